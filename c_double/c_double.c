@@ -12,7 +12,6 @@
 // ================================================================================
 // Include modules here
 
-#include <immintrin.h>  // AVX/SSE
 #include "c_double.h"
 #include <errno.h>
 #include <string.h>
@@ -21,1034 +20,6565 @@
 #include <stdint.h>
 #include <math.h>
 #include <stdio.h>
+#include <locale.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    // Every SIMD variant is compiled and one is picked at load time
+    #define DV_X86_DISPATCH 1
+    #define DV_HAS_SSE2 1
+    #define DV_HAS_AVX2 1
+    #define DV_HAS_AVX512 1
+    #define DV_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #define DV_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define DV_HAS_SSE2 1
+    #endif
+    #if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+        #define DV_HAS_AVX2 1
+    #endif
+    #if defined(__AVX512F__)
+        #define DV_HAS_AVX512 1
+    #endif
+    #define DV_TARGET_AVX2
+    #define DV_TARGET_AVX512
+#endif
+
+#if defined(DV_HAS_SSE2)
+#include <immintrin.h>  // AVX/SSE
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#define DV_HAS_PTHREAD 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#define DV_HAS_MMAP 1
+// madvise and its MADV_ flags need _DEFAULT_SOURCE or _GNU_SOURCE on glibc
+#if defined(MADV_NORMAL)
+#define DV_HAS_MADVISE 1
+#endif
+#endif
+
+// mremap and MAP_ANONYMOUS are only declared with _GNU_SOURCE, so a strict
+// ISO C build falls back to copying the buffer on growth
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MREMAP_MAYMOVE) && defined(MAP_ANONYMOUS)
+#define DV_HAS_MREMAP 1
+#endif
+#endif
+
+// strtod_l parses with a fixed C locale, whatever setlocale has selected
+#if defined(DV_HAS_PTHREAD) && ((defined(__GLIBC__) && defined(_GNU_SOURCE)) || \
+    defined(__APPLE__) || defined(__FreeBSD__))
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
+#define DV_HAS_STRTOD_L 1
+#endif
 
 static const float LOAD_FACTOR_THRESHOLD = 0.7;
 static const size_t VEC_THRESHOLD = 1 * 1024 * 1024;  // 1 MB
 static const size_t VEC_FIXED_AMOUNT = 1 * 1024 * 1024;  // 1 MB
+static const double VEC_GROWTH_FACTOR = 2.0;  // Default factor for GROWTH_GEOMETRIC
+static const double VEC_LARGE_GROWTH_FACTOR = 1.5;  // GROWTH_DEFAULT above VEC_THRESHOLD
+#if defined(DV_HAS_MREMAP)
+static const size_t MREMAP_MIN_BYTES = 1 * 1024 * 1024;  // Smallest buffer moved to mmap
+#endif
+static const size_t PARALLEL_MIN_ELEMENTS = 1 << 21;  // 16 MB, far beyond any L2
+static const size_t PARALLEL_CHUNK_SIZE = 1 << 15;  // Doubles per task, 256 kB
+static const size_t PARALLEL_MAX_THREADS = 256;
+static const size_t RADIX_SORT_MIN = 1 << 11;  // Smallest vector sorted with radix sort
+#define SORT_NETWORK_SIZE 16  // Largest range finished by a sorting network
+static const size_t STATS_BLOCK_SIZE = 512;  // Doubles per describe block, 4 kB fits in L1
+static const size_t ORDER_BLOCK_SIZE = 256;  // Pairs compared between early exits
 static const size_t hashSize = 16;  //  Size fo hash map init functions
 static const uint32_t HASH_SEED = 0x45d9f3b;
 // ================================================================================
 // ================================================================================ 
+// ALIGNED MEMORY
 
-double_v* init_double_vector(size_t buff) {
-    if (buff == 0) {
-        errno = EINVAL;
-        return NULL;
-    }
-    double_v* struct_ptr = malloc(sizeof(double_v));
-    if (struct_ptr == NULL) {
-        errno = ENOMEM;
+/**
+ * @brief Allocates memory for count doubles aligned to DOUBLE_VECTOR_ALIGNMENT bytes
+ *
+ * @param count Number of doubles, must be larger than zero
+ * @return Pointer to the memory or NULL on failure
+ */
+static double* _aligned_alloc_double(size_t count) {
+    if (count > SIZE_MAX / sizeof(double)) return NULL;
+#if defined(_WIN32)
+    return _aligned_malloc(count * sizeof(double), DOUBLE_VECTOR_ALIGNMENT);
+#else
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, DOUBLE_VECTOR_ALIGNMENT, count * sizeof(double)) != 0) {
         return NULL;
     }
-   
-    double* data_ptr = malloc(buff * sizeof(double));
-    if (data_ptr == NULL) {
-        free(struct_ptr);
-        errno = ENOMEM;
-        return NULL; 
-    }
-   
-    // Initialize all elements
-    memset(data_ptr, 0, buff * sizeof(double));
-   
-    struct_ptr->data = data_ptr;
-    struct_ptr->len = 0;
-    struct_ptr->alloc = buff;
-    struct_ptr->alloc_type = DYNAMIC;
-    return struct_ptr;
+    return ptr;
+#endif
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-double* c_double_ptr(double_v* vec) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return NULL;
-    }
-    return vec->data;
+/**
+ * @brief Frees memory obtained from _aligned_alloc_double or _aligned_realloc_double
+ */
+static void _aligned_free_double(double* ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
 }
 // --------------------------------------------------------------------------------
 
-void free_double_vector(double_v* vec) {
-   if (!vec || !vec->alloc_type || vec->alloc_type == STATIC) {
-       errno = EINVAL;
-       return;
-   }
-   if (vec->data) free(vec->data);
-   free(vec);
+/**
+ * @brief Resizes an aligned buffer while keeping its alignment
+ *
+ * realloc only guarantees the alignment of malloc, so on POSIX systems the
+ * first keep elements are copied to a new aligned buffer.
+ *
+ * @param ptr Aligned buffer to resize
+ * @param keep Number of leading elements that must be preserved
+ * @param count New number of doubles
+ * @return Pointer to the new buffer, or NULL on failure in which case ptr is
+ *         left untouched
+ */
+static double* _aligned_realloc_double(double* ptr, size_t keep, size_t count) {
+    if (count > SIZE_MAX / sizeof(double)) return NULL;
+#if defined(_WIN32)
+    (void) keep;
+    return _aligned_realloc(ptr, count * sizeof(double), DOUBLE_VECTOR_ALIGNMENT);
+#else
+    double* new_ptr = _aligned_alloc_double(count);
+    if (!new_ptr) return NULL;
+    if (keep > count) keep = count;
+    memcpy(new_ptr, ptr, keep * sizeof(double));
+    free(ptr);
+    return new_ptr;
+#endif
 }
+// ================================================================================
+// ================================================================================ 
+// SIMD KERNELS
+//
+// The reduction and element-wise kernels are compiled in scalar, SSE2, 
+// AVX2+FMA and AVX-512 variants.  With GCC or Clang on x86-64 every variant is
+// built with a target attribute and the best one supported by the CPU is 
+// selected once when the library is loaded, so a single binary runs on any 
+// x86-64 host.  Other compilers use the best variant enabled by their compile
+// flags.
+
+/**
+ * @brief Statistics of one block of data, NaN values excluded
+ */
+typedef struct {
+    size_t count;    // Elements that are not NaN
+    size_t inf;      // Elements that are +/- Inf
+    double min;
+    double max;
+    double sum;
+    double m2;       // Sum of squared deviations from the block mean
+} dv_block_stats;
 // --------------------------------------------------------------------------------
 
-void _free_double_vector(double_v** vec) {
-    if (vec && *vec) {
-        free_double_vector(*vec);
-        *vec = NULL;
-    }
+/**
+ * @brief Table of the kernels selected for the running CPU
+ */
+typedef struct {
+    simd_level_t level;
+    double (*min)(const double* x, size_t n);
+    double (*max)(const double* x, size_t n);
+    double (*sum)(const double* x, size_t n);
+    double (*sum_comp)(const double* x, size_t n);
+    double (*sq_dev)(const double* x, size_t n, double mean);
+    void (*block_stats)(const double* x, size_t n, dv_block_stats* out);
+    size_t (*partition)(double* x, size_t n, double pivot, bool inclusive);
+    void (*sort_small)(double* x, size_t n);
+    double (*scan)(const double* x, double* out, size_t n, scan_op_t op, double carry);
+    void (*arith)(const double* a, const double* b, double* out, size_t n, arith_op_t op);
+    void (*affine)(const double* x, double* out, size_t n, double scale, double offset);
+    void (*axpy)(double alpha, const double* x, double* y, size_t n);
+    double (*dot)(const double* a, const double* b, size_t n);
+    double (*abs_sum)(const double* x, size_t n);
+    double (*abs_max)(const double* x, size_t n);
+    size_t (*compress)(double* x, size_t n, double value, double tol);
+} dv_kernels;
+// --------------------------------------------------------------------------------
+
+static double _min_scalar(const double* x, size_t n) {
+    double min_val = DBL_MAX;
+    for (size_t i = 0; i < n; ++i)
+        if (x[i] < min_val)
+            min_val = x[i];
+    return min_val;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-bool push_back_double_vector(double_v* vec, const double value) {
-    if (vec == NULL|| vec->data == NULL) {
-        errno = EINVAL;
-        return false;
-    }
-   
-    // Check if we need to resize
-    if (vec->len >= vec->alloc) {
-        if (vec->alloc_type == STATIC) {
-            errno = EINVAL;
-            return false;
-        }
-        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
-        if (new_alloc < VEC_THRESHOLD) {
-            new_alloc *= 2;
-        } else {
-            new_alloc += VEC_FIXED_AMOUNT;
-        }
-       
-        // Allocate more space for the array of str structs
-        double* new_data = realloc(vec->data, new_alloc * sizeof(double));
-        if (!new_data) {
-            errno = ENOMEM;
-            return false;
-        }
-       
-        // Initialize new elements
-        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(double));
-       
-        vec->data = new_data;
-        vec->alloc = new_alloc;
-    }
-    vec->data[vec->len] = value; 
-    vec->len++;
-   
-    return true;
+static double _max_scalar(const double* x, size_t n) {
+    double max_val = -DBL_MAX;
+    for (size_t i = 0; i < n; ++i)
+        if (x[i] > max_val)
+            max_val = x[i];
+    return max_val;
 }
 // --------------------------------------------------------------------------------
 
-bool push_front_double_vector(double_v* vec, const double value) {
-    if (vec == NULL || vec->data == NULL) {
-        errno = EINVAL;
-        return false;
-    }
-   
-    // Check if we need to resize
-    if (vec->len >= vec->alloc) {
-        if (vec->alloc_type == STATIC) {
-            errno = EINVAL;
-            return false;
-        }
-        
-        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
-        if (new_alloc < VEC_THRESHOLD) {
-            new_alloc *= 2;
-        } else {
-            new_alloc += VEC_FIXED_AMOUNT;
-        }
-        
-        // Check for size_t overflow
-        if (new_alloc > SIZE_MAX / sizeof(double)) {
-            errno = ERANGE;
-            return false;
-        }
-       
-        double* new_data = realloc(vec->data, new_alloc * sizeof(double));
-        if (!new_data) {
-            errno = ENOMEM;
-            return false;
-        }
-       
-        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(double));
-       
-        vec->data = new_data;
-        vec->alloc = new_alloc;
-    }
+static double _sum_scalar(const double* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        sum += x[i];
+    return sum;
+}
+// --------------------------------------------------------------------------------
 
-    // Check for length overflow
-    if (vec->len > SIZE_MAX - 1) {
-        errno = ERANGE;
-        return false;
-    }
-    
-    // Move existing elements right if there are any
-    if (vec->len > 0) {
-        memmove(vec->data + 1, vec->data, vec->len * sizeof(double));
-    }
-    
-    vec->data[0] = value;    
-    vec->len++;
-    return true;
+/**
+ * @brief Adds x to a Kahan-Babuska-Neumaier running sum
+ */
+static inline void _neumaier_step(double* sum, double* comp, double x) {
+    double t = *sum + x;
+    if (fabs(*sum) >= fabs(x))
+        *comp += (*sum - t) + x;
+    else
+        *comp += (x - t) + *sum;
+    *sum = t;
 }
 // --------------------------------------------------------------------------------
 
-bool insert_double_vector(double_v* vec, double value, size_t index) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return false;
-    }
-    if (index > vec->len) {
-        errno = ERANGE;
-        return false;
+/**
+ * @brief Folds per lane compensated sums into one result
+ *
+ * The compensation terms are meaningless once an Inf or NaN has been added, so
+ * a non-finite result is replaced by the plain sum, which is then exact.
+ */
+static double _fold_comp_lanes(const double* s, const double* c, size_t lanes,
+                               const double* x, size_t n) {
+    double sum = 0.0, comp = 0.0;
+    for (size_t j = 0; j < lanes; ++j) {
+        _neumaier_step(&sum, &comp, s[j]);
+        comp += c[j];
+    }
+    for (size_t i = 0; i < n; ++i)
+        _neumaier_step(&sum, &comp, x[i]);
+    if (!isfinite(sum + comp))
+        return _sum_scalar(s, lanes) + _sum_scalar(x, n);
+    return sum + comp;
+}
+// --------------------------------------------------------------------------------
+
+static double _sum_comp_scalar(const double* x, size_t n) {
+    return _fold_comp_lanes(NULL, NULL, 0, x, n);
+}
+// --------------------------------------------------------------------------------
+
+static double _sq_dev_scalar(const double* x, size_t n, double mean) {
+    double sum_sq_diff = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double diff = x[i] - mean;
+        sum_sq_diff += diff * diff;
     }
-    if (vec->len >= SIZE_MAX) {  // Check length overflow
-        errno = ERANGE;
-        return false;
+    return sum_sq_diff;
+}
+// --------------------------------------------------------------------------------
+
+static void _block_stats_scalar(const double* x, size_t n, dv_block_stats* out) {
+    size_t count = 0, inf = 0;
+    double min_val = INFINITY, max_val = -INFINITY, sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double v = x[i];
+        if (isnan(v)) continue;
+        if (isinf(v)) inf++;
+        if (v < min_val) min_val = v;
+        if (v > max_val) max_val = v;
+        sum += v;
+        count++;
+    }
+
+    // Second pass runs over data that is still in L1
+    double mean = count ? sum / count : 0.0;
+    double m2 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (isnan(x[i])) continue;
+        double diff = x[i] - mean;
+        m2 += diff * diff;
+    }
+    *out = (dv_block_stats){count, inf, min_val, max_val, sum, m2};
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Partitions x so that values below the pivot (at or below it when 
+ *        inclusive is true) come first
+ *
+ * @return The number of values in the lower part
+ */
+static size_t _partition_scalar(double* x, size_t n, double pivot, bool inclusive) {
+    size_t i = 0, j = n;
+    for (;;) {
+        while (i < j && (inclusive ? x[i] <= pivot : x[i] < pivot)) i++;
+        while (i < j && !(inclusive ? x[j - 1] <= pivot : x[j - 1] < pivot)) j--;
+        if (i >= j) break;
+        double tmp = x[i];
+        x[i++] = x[--j];
+        x[j] = tmp;
+    }
+    return i;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Places the values of a small buffer at the two write cursors of a 
+ *        vectorized partition
+ */
+static void _partition_scatter(double* x, const double* values, size_t n, double pivot,
+                               bool inclusive, size_t* left, size_t* right) {
+    for (size_t i = 0; i < n; ++i) {
+        double v = values[i];
+        if (inclusive ? v <= pivot : v < pivot)
+            x[(*left)++] = v;
+        else
+            x[--(*right)] = v;
     }
-   
-    // Check if we need to resize
-    if (vec->len >= vec->alloc) {
-        if (vec->alloc_type == STATIC) {
-            errno = EINVAL;
-            return false;
-        }
-        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
-        if (new_alloc < VEC_THRESHOLD) {
-            new_alloc *= 2;
-        } else {
-            new_alloc += VEC_FIXED_AMOUNT;
-        }
-        
-        // Check allocation size overflow
-        if (new_alloc > SIZE_MAX / sizeof(double)) {
-            errno = ERANGE;
-            return false;
-        }
-       
-        double* new_data = realloc(vec->data, new_alloc * sizeof(double));
-        if (!new_data) {
-            errno = ENOMEM;
-            return false;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts at most SORT_NETWORK_SIZE values in ascending order
+ */
+static void _sort_small_scalar(double* x, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        double key = x[i];
+        size_t j = i;
+        while (j > 0 && x[j - 1] > key) {
+            x[j] = x[j - 1];
+            j--;
         }
-       
-        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(double));
-       
-        vec->data = new_data;
-        vec->alloc = new_alloc;
+        x[j] = key;
     }
-    
-    // Move existing elements right
-    if (index < vec->len) {  // Only move if not appending
-        // Check for size_t overflow in move operation
-        if (vec->len - index > SIZE_MAX - 1) {
-            errno = ERANGE;
-            return false;
-        }
-        memmove(vec->data + index + 1, vec->data + index, 
-                (vec->len - index) * sizeof(double));
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the value that leaves any other value unchanged under op
+ */
+static inline double _scan_identity(scan_op_t op) {
+    switch (op) {
+        case SCAN_SUM: return 0.0;
+        case SCAN_PROD: return 1.0;
+        case SCAN_MIN: return INFINITY;
+        default: return -INFINITY;
     }
-    
-    vec->data[index] = value;
-    vec->len++;
-    return true;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
+/**
+ * @brief Combines the running value a with the next value b, propagating NaN
+ */
+static inline double _scan_combine(double a, double b, scan_op_t op) {
+    switch (op) {
+        case SCAN_SUM: return a + b;
+        case SCAN_PROD: return a * b;
+        case SCAN_MIN: return (b < a || isnan(b)) ? b : a;
+        default: return (b > a || isnan(b)) ? b : a;
+    }
+}
+// --------------------------------------------------------------------------------
 
-double pop_back_double_vector(double_v* vec) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return DBL_MAX;
+static inline double _scan_scalar_op(const double* x, double* out, size_t n, 
+                                     scan_op_t op, double carry) {
+    for (size_t i = 0; i < n; ++i) {
+        carry = _scan_combine(carry, x[i], op);
+        out[i] = carry;
     }
-    
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return DBL_MAX;
+    return carry;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Inclusive scan of n values starting from carry; out may equal x
+ *
+ * @return The last value written, the carry for the next block
+ */
+static double _scan_scalar(const double* x, double* out, size_t n, scan_op_t op, double carry) {
+    // Each case inlines the helper with a constant op, so no loop tests op
+    switch (op) {
+        case SCAN_SUM: return _scan_scalar_op(x, out, n, SCAN_SUM, carry);
+        case SCAN_PROD: return _scan_scalar_op(x, out, n, SCAN_PROD, carry);
+        case SCAN_MIN: return _scan_scalar_op(x, out, n, SCAN_MIN, carry);
+        default: return _scan_scalar_op(x, out, n, SCAN_MAX, carry);
     }
-    
-    // Create copy of last element
-    double temp = vec->data[vec->len - 1];
-    // Clear the last element (which was moved)
-    memset(&vec->data[vec->len - 1], 0, sizeof(double));
-    vec->len--;
-    return temp;
 }
 // --------------------------------------------------------------------------------
 
-double pop_front_double_vector(double_v* vec) {  // Fixed function name
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return DBL_MAX;
+static inline double _arith_apply(double a, double b, arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: return a + b;
+        case ARITH_SUB: return a - b;
+        case ARITH_MUL: return a * b;
+        default: return a / b;
     }
-   
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return DBL_MAX;
-    }
-   
-    // Check for overflow in memmove size calculation
-    if (vec->len > SIZE_MAX / sizeof(double)) {
-        errno = ERANGE;
-        return DBL_MAX;
-    }
-   
-    // Create copy of first element
-    double temp = vec->data[0];
-    // Shift remaining elements left
-    memmove(vec->data, vec->data + 1, (vec->len - 1) * sizeof(double));
-   
-    // Clear the last element (which was moved)
-    memset(&vec->data[vec->len - 1], 0, sizeof(double));
-   
-    vec->len--;
-    return temp;
 }
 // --------------------------------------------------------------------------------
 
-double pop_any_double_vector(double_v* vec, size_t index) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return DBL_MAX;
-    }
-   
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return DBL_MAX;
-    }
-    
-    if (index >= vec->len) {
-        errno = ERANGE;
-        return DBL_MAX;
-    }
-    
-    // Create copy of element to pop
-    double temp = vec->data[index];
-    
-    // If not the last element, shift remaining elements left
-    if (index < vec->len - 1) {
-        // Check for overflow in memmove size calculation
-        if ((vec->len - index - 1) > SIZE_MAX / sizeof(double)) {
-            errno = ERANGE;
-            return DBL_MAX;
-        }
-        
-        memmove(&vec->data[index], &vec->data[index + 1], 
-                (vec->len - index - 1) * sizeof(double));
-    }
-   
-    // Clear the last element
-    memset(&vec->data[vec->len - 1], 0, sizeof(double));
-    
-    vec->len--;
-    return temp;
+static inline void _arith_scalar_op(const double* a, const double* b, double* out, 
+                                    size_t n, arith_op_t op) {
+    for (size_t i = 0; i < n; ++i)
+        out[i] = _arith_apply(a[i], b[i], op);
 }
 // --------------------------------------------------------------------------------
 
-const double double_vector_index(const double_v* vec, size_t index) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return DBL_MAX;
-    }
-    if (index > vec->len - 1) {
-        errno = ERANGE;
-        return DBL_MAX;
+/**
+ * @brief Writes a[i] op b[i] to out, which may equal a or b
+ */
+static void _arith_scalar(const double* a, const double* b, double* out, size_t n, 
+                          arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: _arith_scalar_op(a, b, out, n, ARITH_ADD); break;
+        case ARITH_SUB: _arith_scalar_op(a, b, out, n, ARITH_SUB); break;
+        case ARITH_MUL: _arith_scalar_op(a, b, out, n, ARITH_MUL); break;
+        default: _arith_scalar_op(a, b, out, n, ARITH_DIV); break;
     }
-    return vec->data[index];
 }
-// // --------------------------------------------------------------------------------
-//
-const size_t double_vector_size(const double_v* vec) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return LONG_MAX;
-    }
-    return vec->len;
+// --------------------------------------------------------------------------------
+
+static void _affine_scalar(const double* x, double* out, size_t n, double scale, double offset) {
+    for (size_t i = 0; i < n; ++i)
+        out[i] = x[i] * scale + offset;
 }
 // --------------------------------------------------------------------------------
 
-const size_t double_vector_alloc(const double_v* vec) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return LONG_MAX;
-    }
-    return vec->alloc;
+static void _axpy_scalar(double alpha, const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] = alpha * x[i] + y[i];
 }
 // --------------------------------------------------------------------------------
 
-void reverse_double_vector(double_v* vec) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return;
-    }
+static double _dot_scalar(const double* a, const double* b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+// --------------------------------------------------------------------------------
 
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return;
+static double _abs_sum_scalar(const double* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        sum += fabs(x[i]);
+    return sum;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the largest absolute value, or NaN if any value is NaN
+ */
+static double _abs_max_scalar(const double* x, size_t n) {
+    double max_val = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double v = fabs(x[i]);
+        if (v > max_val)
+            max_val = v;
+        else if (isnan(v))
+            return NAN;
     }
+    return max_val;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief true if v is kept by a compaction that removes value, or NaN when
+ *        value is NaN
+ */
+static inline bool _compress_keep(double v, double value, double tol) {
+    if (isnan(value)) return !isnan(v);
+    return !(v == value || fabs(v - value) <= tol);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Moves the values kept by _compress_keep to the front of x in order
+ *
+ * Every value is written at the write cursor, which only advances for kept
+ * values, so the loop has no data dependent branch.
+ *
+ * @return The number of kept values
+ */
+static size_t _compress_scalar(double* x, size_t n, double value, double tol) {
+    size_t w = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double v = x[i];
+        x[w] = v;
+        w += _compress_keep(v, value, tol);
+    }
+    return w;
+}
+// --------------------------------------------------------------------------------
+
+static const dv_kernels _scalar_kernels = {
+    SIMD_SCALAR, _min_scalar, _max_scalar, _sum_scalar, _sum_comp_scalar, _sq_dev_scalar,
+    _block_stats_scalar, _partition_scalar, _sort_small_scalar, _scan_scalar,
+    _arith_scalar, _affine_scalar, _axpy_scalar, _dot_scalar, _abs_sum_scalar, _abs_max_scalar,
+    _compress_scalar
+};
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Counts the set bits of a SIMD comparison mask of at most 8 lanes
+ *
+ * Compilers without __builtin_popcount, such as MSVC, use a nibble table.
+ */
+static inline size_t _mask_popcount(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcount(mask);
+#else
+    static const unsigned char bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    return (size_t)bits[mask & 15u] + bits[(mask >> 4) & 15u];
+#endif
+}
+// --------------------------------------------------------------------------------
 
+#if defined(DV_HAS_SSE2)
+static double _min_sse2(const double* x, size_t n) {
+    double min_val = DBL_MAX;
     size_t i = 0;
-    size_t j = vec->len - 1;
-    while (i < j) {
-       swap_double(&vec->data[i], &vec->data[j]);
-       i++;
-       j--;
-    }
+
+    // Scalar head until the data is aligned for _mm_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 15); ++i)
+        if (x[i] < min_val)
+            min_val = x[i];
+
+    __m128d vmin = _mm_set1_pd(DBL_MAX);
+    for (; i + 1 < n; i += 2)
+        vmin = _mm_min_pd(vmin, _mm_load_pd(&x[i]));
+
+    vmin = _mm_min_pd(vmin, _mm_unpackhi_pd(vmin, vmin));
+    if (_mm_cvtsd_f64(vmin) < min_val)
+        min_val = _mm_cvtsd_f64(vmin);
+
+    for (; i < n; ++i)
+        if (x[i] < min_val)
+            min_val = x[i];
+    return min_val;
 }
-// ================================================================================
-// ================================================================================ 
-// QUICKSORT
+// --------------------------------------------------------------------------------
 
-void swap_double(double* a, double* b) {
-    if (!a || !b) {
-        errno = EINVAL;
-        return;
-    }
-    double temp = *a;
-    *a = *b;
-    *b = temp;
+static double _max_sse2(const double* x, size_t n) {
+    double max_val = -DBL_MAX;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 15); ++i)
+        if (x[i] > max_val)
+            max_val = x[i];
+
+    __m128d vmax = _mm_set1_pd(-DBL_MAX);
+    for (; i + 1 < n; i += 2)
+        vmax = _mm_max_pd(vmax, _mm_load_pd(&x[i]));
+
+    vmax = _mm_max_pd(vmax, _mm_unpackhi_pd(vmax, vmax));
+    if (_mm_cvtsd_f64(vmax) > max_val)
+        max_val = _mm_cvtsd_f64(vmax);
+
+    for (; i < n; ++i)
+        if (x[i] > max_val)
+            max_val = x[i];
+    return max_val;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-static double* _median_of_three(double* a, double* b, double* c, iter_dir direction) {
-    if ((direction == FORWARD && *a < *b) ||
-        (direction == REVERSE && *a > *b)) {
-        if ((direction == FORWARD && *b < *c) ||
-            (direction == REVERSE && *b > *c))
-            return b;
-        if ((direction == FORWARD && *a < *c) ||
-            (direction == REVERSE && *a > *c))
-            return c;
-        return a;
+static double _sum_sse2(const double* x, size_t n) {
+    double sum = 0.0;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 15); ++i)
+        sum += x[i];
+
+    __m128d vsum0 = _mm_setzero_pd();
+    __m128d vsum1 = _mm_setzero_pd();
+    for (; i + 3 < n; i += 4) {
+        vsum0 = _mm_add_pd(vsum0, _mm_load_pd(&x[i]));
+        vsum1 = _mm_add_pd(vsum1, _mm_load_pd(&x[i + 2]));
     }
-    if ((direction == FORWARD && *a < *c) ||
-        (direction == REVERSE && *a > *c))
-        return a;
-    if ((direction == FORWARD && *b < *c) ||
-        (direction == REVERSE && *b > *c))
-        return c;
-    return b;
+    vsum0 = _mm_add_pd(vsum0, vsum1);
+    vsum0 = _mm_add_pd(vsum0, _mm_unpackhi_pd(vsum0, vsum0));
+    sum += _mm_cvtsd_f64(vsum0);
+
+    for (; i < n; ++i)
+        sum += x[i];
+    return sum;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-static void _insertion_sort(double* vec, int low, int high, iter_dir direction) {
-    for (int i = low + 1; i <= high; i++) {
-        double key = vec[i];
-        int j = i - 1;
-        while (j >= low && ((direction == FORWARD && vec[j] > key) ||
-                           (direction == REVERSE && vec[j] < key))) {
-            vec[j + 1] = vec[j];
-            j--;
-        }
-        vec[j + 1] = key;
-    }
+/**
+ * @brief One Neumaier step in every lane; SSE2 has no blend so masks select
+ *        the larger and smaller magnitude operands
+ */
+static inline void _neumaier_sse2(__m128d* s, __m128d* c, __m128d x) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d t = _mm_add_pd(*s, x);
+    __m128d ge = _mm_cmpge_pd(_mm_andnot_pd(sign, *s), _mm_andnot_pd(sign, x));
+    __m128d big = _mm_or_pd(_mm_and_pd(ge, *s), _mm_andnot_pd(ge, x));
+    __m128d small = _mm_or_pd(_mm_and_pd(ge, x), _mm_andnot_pd(ge, *s));
+    *c = _mm_add_pd(*c, _mm_add_pd(_mm_sub_pd(big, t), small));
+    *s = t;
 }
 // --------------------------------------------------------------------------------
 
-static int _partition_double(double* vec, int low, int high, iter_dir direction) {
-    int mid = low + (high - low) / 2;
-    double* pivot_ptr = _median_of_three(&vec[low], &vec[mid], &vec[high], direction);
-    
-    if (pivot_ptr != &vec[high])
-        swap_double(pivot_ptr, &vec[high]);
-    
-    double pivot = vec[high];
-    int i = (low - 1);
-    
-    for (int j = low; j <= high - 1; j++) {
-        if ((direction == FORWARD && vec[j] < pivot) ||
-            (direction == REVERSE && vec[j] > pivot)) {
-            i++;
-            swap_double(&vec[i], &vec[j]);
-        }
+static double _sum_comp_sse2(const double* x, size_t n) {
+    __m128d s0 = _mm_setzero_pd(), c0 = _mm_setzero_pd();
+    __m128d s1 = _mm_setzero_pd(), c1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 3 < n; i += 4) {
+        _neumaier_sse2(&s0, &c0, _mm_loadu_pd(&x[i]));
+        _neumaier_sse2(&s1, &c1, _mm_loadu_pd(&x[i + 2]));
+    }
+    double s[4], c[4];
+    _mm_storeu_pd(s, s0);
+    _mm_storeu_pd(s + 2, s1);
+    _mm_storeu_pd(c, c0);
+    _mm_storeu_pd(c + 2, c1);
+    return _fold_comp_lanes(s, c, 4, x + i, n - i);
+}
+// --------------------------------------------------------------------------------
+
+static double _sq_dev_sse2(const double* x, size_t n, double mean) {
+    double sum_sq_diff = 0.0;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 15); ++i) {
+        double diff = x[i] - mean;
+        sum_sq_diff += diff * diff;
+    }
+
+    __m128d vmean = _mm_set1_pd(mean);
+    __m128d vsum = _mm_setzero_pd();
+    for (; i + 1 < n; i += 2) {
+        __m128d diff = _mm_sub_pd(_mm_load_pd(&x[i]), vmean);
+        vsum = _mm_add_pd(vsum, _mm_mul_pd(diff, diff));
+    }
+    vsum = _mm_add_pd(vsum, _mm_unpackhi_pd(vsum, vsum));
+    sum_sq_diff += _mm_cvtsd_f64(vsum);
+
+    for (; i < n; ++i) {
+        double diff = x[i] - mean;
+        sum_sq_diff += diff * diff;
     }
-    swap_double(&vec[i + 1], &vec[high]);
-    return (i + 1);
+    return sum_sq_diff;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-static void _quicksort_double(double* vec, int low, int high, iter_dir direction) {
-    while (low < high) {
-        if (high - low < 10) {
-            _insertion_sort(vec, low, high, direction);
-            break;
-        }
-        
-        int pi = _partition_double(vec, low, high, direction);
-        
-        if (pi - low < high - pi) {
-            _quicksort_double(vec, low, pi - 1, direction);
-            low = pi + 1;
-        } else {
-            _quicksort_double(vec, pi + 1, high, direction);
-            high = pi - 1;
+static void _block_stats_sse2(const double* x, size_t n, dv_block_stats* out) {
+    const __m128d vinf = _mm_set1_pd(INFINITY);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d vmin = _mm_set1_pd(INFINITY);
+    __m128d vmax = _mm_set1_pd(-INFINITY);
+    __m128d vsum = _mm_setzero_pd();
+    __m128i vcount = _mm_setzero_si128();
+    __m128i vinf_count = _mm_setzero_si128();
+    size_t i = 0;
+
+    // Comparison masks are all ones, so subtracting them counts lanes.  NaN
+    // lanes are dropped from min/max by operand order and from sum by the mask.
+    for (; i + 1 < n; i += 2) {
+        __m128d v = _mm_loadu_pd(&x[i]);
+        __m128d ord = _mm_cmpord_pd(v, v);
+        __m128d is_inf = _mm_cmpeq_pd(_mm_andnot_pd(sign, v), vinf);
+        vmin = _mm_min_pd(v, vmin);
+        vmax = _mm_max_pd(v, vmax);
+        vsum = _mm_add_pd(vsum, _mm_and_pd(v, ord));
+        vcount = _mm_sub_epi64(vcount, _mm_castpd_si128(ord));
+        vinf_count = _mm_sub_epi64(vinf_count, _mm_castpd_si128(is_inf));
+    }
+
+    double lanes[2];
+    int64_t counts[2], infs[2];
+    _mm_storeu_pd(lanes, vmin);
+    double min_val = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    _mm_storeu_pd(lanes, vmax);
+    double max_val = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    _mm_storeu_pd(lanes, vsum);
+    double sum = lanes[0] + lanes[1];
+    _mm_storeu_si128((__m128i*)counts, vcount);
+    _mm_storeu_si128((__m128i*)infs, vinf_count);
+    size_t count = (size_t)(counts[0] + counts[1]);
+    size_t inf = (size_t)(infs[0] + infs[1]);
+
+    for (; i < n; ++i) {
+        double v = x[i];
+        if (isnan(v)) continue;
+        if (isinf(v)) inf++;
+        if (v < min_val) min_val = v;
+        if (v > max_val) max_val = v;
+        sum += v;
+        count++;
+    }
+
+    double mean = count ? sum / count : 0.0;
+    __m128d vmean = _mm_set1_pd(mean);
+    __m128d vm2 = _mm_setzero_pd();
+    for (i = 0; i + 1 < n; i += 2) {
+        __m128d v = _mm_loadu_pd(&x[i]);
+        __m128d diff = _mm_and_pd(_mm_sub_pd(v, vmean), _mm_cmpord_pd(v, v));
+        vm2 = _mm_add_pd(vm2, _mm_mul_pd(diff, diff));
+    }
+    vm2 = _mm_add_pd(vm2, _mm_unpackhi_pd(vm2, vm2));
+    double m2 = _mm_cvtsd_f64(vm2);
+    for (; i < n; ++i) {
+        if (isnan(x[i])) continue;
+        double diff = x[i] - mean;
+        m2 += diff * diff;
+    }
+    *out = (dv_block_stats){count, inf, min_val, max_val, sum, m2};
+}
+// --------------------------------------------------------------------------------
+
+static inline __m128d _scan_combine_sse2(__m128d a, __m128d b, scan_op_t op) {
+    switch (op) {
+        case SCAN_SUM: return _mm_add_pd(a, b);
+        case SCAN_PROD: return _mm_mul_pd(a, b);
+        default: {
+            // minpd and maxpd return b when either operand is NaN, so NaN is
+            // carried explicitly through a + b
+            __m128d m = op == SCAN_MIN ? _mm_min_pd(a, b) : _mm_max_pd(a, b);
+            __m128d nan = _mm_cmpunord_pd(a, b);
+            return _mm_or_pd(_mm_andnot_pd(nan, m), _mm_and_pd(nan, _mm_add_pd(a, b)));
         }
     }
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-void sort_double_vector(double_v* vec, iter_dir direction) {
-    if (!vec) {
-        errno = EINVAL;
-        return;
+static inline double _scan_sse2_op(const double* x, double* out, size_t n, 
+                                   scan_op_t op, double carry) {
+    const __m128d id = _mm_set1_pd(_scan_identity(op));
+    __m128d run = _mm_set1_pd(carry);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(x + i);
+        v = _scan_combine_sse2(v, _mm_unpacklo_pd(id, v), op);
+        __m128d total = _mm_unpackhi_pd(v, v);
+        _mm_storeu_pd(out + i, _scan_combine_sse2(run, v, op));
+        run = _scan_combine_sse2(run, total, op);
+    }
+    return _scan_scalar_op(x + i, out + i, n - i, op, _mm_cvtsd_f64(run));
+}
+// --------------------------------------------------------------------------------
+
+static double _scan_sse2(const double* x, double* out, size_t n, scan_op_t op, double carry) {
+    switch (op) {
+        case SCAN_SUM: return _scan_sse2_op(x, out, n, SCAN_SUM, carry);
+        case SCAN_PROD: return _scan_sse2_op(x, out, n, SCAN_PROD, carry);
+        case SCAN_MIN: return _scan_sse2_op(x, out, n, SCAN_MIN, carry);
+        default: return _scan_sse2_op(x, out, n, SCAN_MAX, carry);
     }
-    if (vec->len < 2) return;
-    
-    _quicksort_double(vec->data, 0, vec->len - 1, direction);
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-void trim_double_vector(double_v* vec) {
-    if (!vec || !vec->data) {
-        errno = EINVAL;
-        return;
+static inline __m128d _arith_sse2_vec(__m128d a, __m128d b, arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: return _mm_add_pd(a, b);
+        case ARITH_SUB: return _mm_sub_pd(a, b);
+        case ARITH_MUL: return _mm_mul_pd(a, b);
+        default: return _mm_div_pd(a, b);
     }
-    
-    if (vec->alloc_type == STATIC || vec->len == vec->alloc) {
-        return;
+}
+// --------------------------------------------------------------------------------
+
+static inline void _arith_sse2_op(const double* a, const double* b, double* out, 
+                                  size_t n, arith_op_t op) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d r0 = _arith_sse2_vec(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i), op);
+        __m128d r1 = _arith_sse2_vec(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2), op);
+        _mm_storeu_pd(out + i, r0);
+        _mm_storeu_pd(out + i + 2, r1);
     }
-   
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return;
+    _arith_scalar_op(a + i, b + i, out + i, n - i, op);
+}
+// --------------------------------------------------------------------------------
+
+static void _arith_sse2(const double* a, const double* b, double* out, size_t n, 
+                        arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: _arith_sse2_op(a, b, out, n, ARITH_ADD); break;
+        case ARITH_SUB: _arith_sse2_op(a, b, out, n, ARITH_SUB); break;
+        case ARITH_MUL: _arith_sse2_op(a, b, out, n, ARITH_MUL); break;
+        default: _arith_sse2_op(a, b, out, n, ARITH_DIV); break;
     }
+}
+// --------------------------------------------------------------------------------
 
-    // Check for overflow
-    if (vec->len > SIZE_MAX / sizeof(double)) {
-        errno = ERANGE;
-        return;
+static void _affine_sse2(const double* x, double* out, size_t n, double scale, double offset) {
+    const __m128d vs = _mm_set1_pd(scale);
+    const __m128d vo = _mm_set1_pd(offset);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d r0 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(x + i), vs), vo);
+        __m128d r1 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(x + i + 2), vs), vo);
+        _mm_storeu_pd(out + i, r0);
+        _mm_storeu_pd(out + i + 2, r1);
     }
-    
-    double* ptr = realloc(vec->data, sizeof(double) * vec->len);
-    if (ptr == NULL) {
-        errno = ENOMEM;
-        return;
+    _affine_scalar(x + i, out + i, n - i, scale, offset);
+}
+// --------------------------------------------------------------------------------
+
+static void _axpy_sse2(double alpha, const double* x, double* y, size_t n) {
+    const __m128d va = _mm_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d r0 = _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)), _mm_loadu_pd(y + i));
+        __m128d r1 = _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i + 2)), _mm_loadu_pd(y + i + 2));
+        _mm_storeu_pd(y + i, r0);
+        _mm_storeu_pd(y + i + 2, r1);
     }
-    
-    vec->data = ptr;
-    vec->alloc = vec->len;
+    _axpy_scalar(alpha, x + i, y + i, n - i);
 }
 // --------------------------------------------------------------------------------
 
-size_t binary_search_double_vector(double_v* vec, double value, double tolerance, bool sort_first) {
+static double _dot_sse2(const double* a, const double* b, size_t n) {
+    __m128d vsum0 = _mm_setzero_pd();
+    __m128d vsum1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vsum0 = _mm_add_pd(vsum0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        vsum1 = _mm_add_pd(vsum1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    vsum0 = _mm_add_pd(vsum0, vsum1);
+    vsum0 = _mm_add_pd(vsum0, _mm_unpackhi_pd(vsum0, vsum0));
+    return _mm_cvtsd_f64(vsum0) + _dot_scalar(a + i, b + i, n - i);
+}
+// --------------------------------------------------------------------------------
+
+static double _abs_sum_sse2(const double* x, size_t n) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d vsum0 = _mm_setzero_pd();
+    __m128d vsum1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vsum0 = _mm_add_pd(vsum0, _mm_andnot_pd(sign, _mm_loadu_pd(x + i)));
+        vsum1 = _mm_add_pd(vsum1, _mm_andnot_pd(sign, _mm_loadu_pd(x + i + 2)));
+    }
+    vsum0 = _mm_add_pd(vsum0, vsum1);
+    vsum0 = _mm_add_pd(vsum0, _mm_unpackhi_pd(vsum0, vsum0));
+    return _mm_cvtsd_f64(vsum0) + _abs_sum_scalar(x + i, n - i);
+}
+// --------------------------------------------------------------------------------
+
+static double _abs_max_sse2(const double* x, size_t n) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d vmax = _mm_setzero_pd();
+    __m128d vnan = _mm_setzero_pd();
+    size_t i = 0;
+
+    // maxpd drops a NaN in its first operand, so NaN lanes are collected apart
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_andnot_pd(sign, _mm_loadu_pd(x + i));
+        vmax = _mm_max_pd(v, vmax);
+        vnan = _mm_or_pd(vnan, _mm_cmpunord_pd(v, v));
+    }
+    if (_mm_movemask_pd(vnan))
+        return NAN;
+    vmax = _mm_max_pd(vmax, _mm_unpackhi_pd(vmax, vmax));
+    double tail = _abs_max_scalar(x + i, n - i);
+    return tail > _mm_cvtsd_f64(vmax) || isnan(tail) ? tail : _mm_cvtsd_f64(vmax);
+}
+// --------------------------------------------------------------------------------
+
+static const dv_kernels _sse2_kernels = {
+    SIMD_SSE2, _min_sse2, _max_sse2, _sum_sse2, _sum_comp_sse2, _sq_dev_sse2,
+    _block_stats_sse2, _partition_scalar, _sort_small_scalar,  // Two lanes do not beat scalar
+    _scan_sse2, _arith_sse2, _affine_sse2, _axpy_sse2, _dot_sse2, _abs_sum_sse2, _abs_max_sse2,
+    _compress_scalar
+};
+#endif /* DV_HAS_SSE2 */
+// --------------------------------------------------------------------------------
+
+#if defined(DV_HAS_AVX2)
+static DV_TARGET_AVX2 double _hsum_avx2(__m256d v) {
+    __m128d sum128 = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    sum128 = _mm_add_pd(sum128, _mm_unpackhi_pd(sum128, sum128));
+    return _mm_cvtsd_f64(sum128);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _min_avx2(const double* x, size_t n) {
+    double min_val = DBL_MAX;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm256_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 31); ++i)
+        if (x[i] < min_val)
+            min_val = x[i];
+
+    __m256d vmin0 = _mm256_set1_pd(DBL_MAX);
+    __m256d vmin1 = vmin0;
+    for (; i + 7 < n; i += 8) {
+        vmin0 = _mm256_min_pd(vmin0, _mm256_load_pd(&x[i]));
+        vmin1 = _mm256_min_pd(vmin1, _mm256_load_pd(&x[i + 4]));
+    }
+    for (; i + 3 < n; i += 4)
+        vmin0 = _mm256_min_pd(vmin0, _mm256_load_pd(&x[i]));
+
+    vmin0 = _mm256_min_pd(vmin0, vmin1);
+    __m128d min128 = _mm_min_pd(_mm256_castpd256_pd128(vmin0), 
+                                _mm256_extractf128_pd(vmin0, 1));
+    min128 = _mm_min_pd(min128, _mm_unpackhi_pd(min128, min128));
+    if (_mm_cvtsd_f64(min128) < min_val)
+        min_val = _mm_cvtsd_f64(min128);
+
+    for (; i < n; ++i)
+        if (x[i] < min_val)
+            min_val = x[i];
+    return min_val;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _max_avx2(const double* x, size_t n) {
+    double max_val = -DBL_MAX;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm256_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 31); ++i)
+        if (x[i] > max_val)
+            max_val = x[i];
+
+    __m256d vmax0 = _mm256_set1_pd(-DBL_MAX);
+    __m256d vmax1 = vmax0;
+    for (; i + 7 < n; i += 8) {
+        vmax0 = _mm256_max_pd(vmax0, _mm256_load_pd(&x[i]));
+        vmax1 = _mm256_max_pd(vmax1, _mm256_load_pd(&x[i + 4]));
+    }
+    for (; i + 3 < n; i += 4)
+        vmax0 = _mm256_max_pd(vmax0, _mm256_load_pd(&x[i]));
+
+    vmax0 = _mm256_max_pd(vmax0, vmax1);
+    __m128d max128 = _mm_max_pd(_mm256_castpd256_pd128(vmax0), 
+                                _mm256_extractf128_pd(vmax0, 1));
+    max128 = _mm_max_pd(max128, _mm_unpackhi_pd(max128, max128));
+    if (_mm_cvtsd_f64(max128) > max_val)
+        max_val = _mm_cvtsd_f64(max128);
+
+    for (; i < n; ++i)
+        if (x[i] > max_val)
+            max_val = x[i];
+    return max_val;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _sum_avx2(const double* x, size_t n) {
+    double sum = 0.0;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm256_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 31); ++i)
+        sum += x[i];
+
+    // Four independent accumulators hide the latency of vaddpd
+    __m256d vsum0 = _mm256_setzero_pd();
+    __m256d vsum1 = _mm256_setzero_pd();
+    __m256d vsum2 = _mm256_setzero_pd();
+    __m256d vsum3 = _mm256_setzero_pd();
+    for (; i + 15 < n; i += 16) {
+        vsum0 = _mm256_add_pd(vsum0, _mm256_load_pd(&x[i]));
+        vsum1 = _mm256_add_pd(vsum1, _mm256_load_pd(&x[i + 4]));
+        vsum2 = _mm256_add_pd(vsum2, _mm256_load_pd(&x[i + 8]));
+        vsum3 = _mm256_add_pd(vsum3, _mm256_load_pd(&x[i + 12]));
+    }
+    for (; i + 3 < n; i += 4)
+        vsum0 = _mm256_add_pd(vsum0, _mm256_load_pd(&x[i]));
+
+    vsum0 = _mm256_add_pd(_mm256_add_pd(vsum0, vsum1), _mm256_add_pd(vsum2, vsum3));
+    sum += _hsum_avx2(vsum0);
+
+    for (; i < n; ++i)
+        sum += x[i];
+    return sum;
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX2 void _neumaier_avx2(__m256d* s, __m256d* c, __m256d x) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d t = _mm256_add_pd(*s, x);
+    __m256d ge = _mm256_cmp_pd(_mm256_andnot_pd(sign, *s), _mm256_andnot_pd(sign, x), _CMP_GE_OQ);
+    __m256d big = _mm256_blendv_pd(x, *s, ge);
+    __m256d small = _mm256_blendv_pd(*s, x, ge);
+    *c = _mm256_add_pd(*c, _mm256_add_pd(_mm256_sub_pd(big, t), small));
+    *s = t;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _sum_comp_avx2(const double* x, size_t n) {
+    // Two independent accumulator pairs keep the add latency hidden
+    __m256d s0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 7 < n; i += 8) {
+        _neumaier_avx2(&s0, &c0, _mm256_loadu_pd(&x[i]));
+        _neumaier_avx2(&s1, &c1, _mm256_loadu_pd(&x[i + 4]));
+    }
+    double s[8], c[8];
+    _mm256_storeu_pd(s, s0);
+    _mm256_storeu_pd(s + 4, s1);
+    _mm256_storeu_pd(c, c0);
+    _mm256_storeu_pd(c + 4, c1);
+    return _fold_comp_lanes(s, c, 8, x + i, n - i);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _sq_dev_avx2(const double* x, size_t n, double mean) {
+    double sum_sq_diff = 0.0;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm256_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 31); ++i) {
+        double diff = x[i] - mean;
+        sum_sq_diff += diff * diff;
+    }
+
+    __m256d vmean = _mm256_set1_pd(mean);
+    __m256d vsum0 = _mm256_setzero_pd();
+    __m256d vsum1 = _mm256_setzero_pd();
+    for (; i + 7 < n; i += 8) {
+        __m256d diff0 = _mm256_sub_pd(_mm256_load_pd(&x[i]), vmean);
+        __m256d diff1 = _mm256_sub_pd(_mm256_load_pd(&x[i + 4]), vmean);
+        vsum0 = _mm256_fmadd_pd(diff0, diff0, vsum0);
+        vsum1 = _mm256_fmadd_pd(diff1, diff1, vsum1);
+    }
+    for (; i + 3 < n; i += 4) {
+        __m256d diff = _mm256_sub_pd(_mm256_load_pd(&x[i]), vmean);
+        vsum0 = _mm256_fmadd_pd(diff, diff, vsum0);
+    }
+    sum_sq_diff += _hsum_avx2(_mm256_add_pd(vsum0, vsum1));
+
+    for (; i < n; ++i) {
+        double diff = x[i] - mean;
+        sum_sq_diff += diff * diff;
+    }
+    return sum_sq_diff;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 void _block_stats_avx2(const double* x, size_t n, dv_block_stats* out) {
+    const __m256d vinf = _mm256_set1_pd(INFINITY);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d vmin = _mm256_set1_pd(INFINITY);
+    __m256d vmax = _mm256_set1_pd(-INFINITY);
+    __m256d vsum = _mm256_setzero_pd();
+    __m256i vcount = _mm256_setzero_si256();
+    __m256i vinf_count = _mm256_setzero_si256();
+    size_t i = 0;
+
+    // Comparison masks are all ones, so subtracting them counts lanes.  NaN
+    // lanes are dropped from min/max by operand order and from sum by the mask.
+    for (; i + 3 < n; i += 4) {
+        __m256d v = _mm256_loadu_pd(&x[i]);
+        __m256d ord = _mm256_cmp_pd(v, v, _CMP_ORD_Q);
+        __m256d is_inf = _mm256_cmp_pd(_mm256_andnot_pd(sign, v), vinf, _CMP_EQ_OQ);
+        vmin = _mm256_min_pd(v, vmin);
+        vmax = _mm256_max_pd(v, vmax);
+        vsum = _mm256_add_pd(vsum, _mm256_and_pd(v, ord));
+        vcount = _mm256_sub_epi64(vcount, _mm256_castpd_si256(ord));
+        vinf_count = _mm256_sub_epi64(vinf_count, _mm256_castpd_si256(is_inf));
+    }
+
+    double lanes[4];
+    int64_t counts[4], infs[4];
+    _mm256_storeu_pd(lanes, vmin);
+    double min_val = lanes[0];
+    for (int j = 1; j < 4; ++j) if (lanes[j] < min_val) min_val = lanes[j];
+    _mm256_storeu_pd(lanes, vmax);
+    double max_val = lanes[0];
+    for (int j = 1; j < 4; ++j) if (lanes[j] > max_val) max_val = lanes[j];
+    double sum = _hsum_avx2(vsum);
+    _mm256_storeu_si256((__m256i*)counts, vcount);
+    _mm256_storeu_si256((__m256i*)infs, vinf_count);
+    size_t count = (size_t)(counts[0] + counts[1] + counts[2] + counts[3]);
+    size_t inf = (size_t)(infs[0] + infs[1] + infs[2] + infs[3]);
+
+    for (; i < n; ++i) {
+        double v = x[i];
+        if (isnan(v)) continue;
+        if (isinf(v)) inf++;
+        if (v < min_val) min_val = v;
+        if (v > max_val) max_val = v;
+        sum += v;
+        count++;
+    }
+
+    double mean = count ? sum / count : 0.0;
+    __m256d vmean = _mm256_set1_pd(mean);
+    __m256d vm2 = _mm256_setzero_pd();
+    for (i = 0; i + 3 < n; i += 4) {
+        __m256d v = _mm256_loadu_pd(&x[i]);
+        __m256d diff = _mm256_and_pd(_mm256_sub_pd(v, vmean), _mm256_cmp_pd(v, v, _CMP_ORD_Q));
+        vm2 = _mm256_fmadd_pd(diff, diff, vm2);
+    }
+    double m2 = _hsum_avx2(vm2);
+    for (; i < n; ++i) {
+        if (isnan(x[i])) continue;
+        double diff = x[i] - mean;
+        m2 += diff * diff;
+    }
+    *out = (dv_block_stats){count, inf, min_val, max_val, sum, m2};
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief For every 4 bit comparison mask, the 32 bit lane permutation that
+ *        moves the selected doubles to the front and the others to the back
+ */
+static const int32_t _partition_perm_avx2[16][8] = {
+    {0, 1, 2, 3, 4, 5, 6, 7},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+    {2, 3, 0, 1, 4, 5, 6, 7},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+    {4, 5, 0, 1, 2, 3, 6, 7},
+    {0, 1, 4, 5, 2, 3, 6, 7},
+    {2, 3, 4, 5, 0, 1, 6, 7},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+    {6, 7, 0, 1, 2, 3, 4, 5},
+    {0, 1, 6, 7, 2, 3, 4, 5},
+    {2, 3, 6, 7, 0, 1, 4, 5},
+    {0, 1, 2, 3, 6, 7, 4, 5},
+    {4, 5, 6, 7, 0, 1, 2, 3},
+    {0, 1, 4, 5, 6, 7, 2, 3},
+    {2, 3, 4, 5, 6, 7, 0, 1},
+    {0, 1, 2, 3, 4, 5, 6, 7}
+};
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief In place vectorized partition
+ *
+ * The first and last vectors are held in registers, which opens one vector of
+ * free space at each end.  Each step loads from the side with less free space,
+ * permutes the vector so the lower values lead, and stores the whole vector at
+ * both write cursors; the lanes that land outside the lower or upper part fall
+ * in free space and are overwritten later.
+ */
+static DV_TARGET_AVX2 size_t _partition_avx2(double* x, size_t n, double pivot, bool inclusive) {
+    if (n < 16)
+        return _partition_scalar(x, n, pivot, inclusive);
+
+    const __m256d vpivot = _mm256_set1_pd(pivot);
+    __m256d first = _mm256_loadu_pd(x);
+    __m256d last = _mm256_loadu_pd(x + n - 4);
+    size_t read_left = 4, read_right = n - 4;
+    size_t left = 0, right = n;
+
+    while (read_right - read_left >= 4) {
+        __m256d v;
+        if (read_left - left <= right - read_right) {
+            v = _mm256_loadu_pd(x + read_left);
+            read_left += 4;
+        } else {
+            read_right -= 4;
+            v = _mm256_loadu_pd(x + read_right);
+        }
+        __m256d lower = inclusive ? _mm256_cmp_pd(v, vpivot, _CMP_LE_OQ) 
+                                  : _mm256_cmp_pd(v, vpivot, _CMP_LT_OQ);
+        int mask = _mm256_movemask_pd(lower);
+        size_t n_lower = _mask_popcount((unsigned)mask);
+        __m256i perm = _mm256_loadu_si256((const __m256i*)_partition_perm_avx2[mask]);
+        __m256d packed = _mm256_castsi256_pd(
+            _mm256_permutevar8x32_epi32(_mm256_castpd_si256(v), perm));
+        _mm256_storeu_pd(x + left, packed);
+        _mm256_storeu_pd(x + right - 4, packed);
+        left += n_lower;
+        right -= 4 - n_lower;
+    }
+
+    double rest[12];
+    size_t n_rest = read_right - read_left;
+    memcpy(rest, x + read_left, n_rest * sizeof(double));
+    _mm256_storeu_pd(rest + n_rest, first);
+    _mm256_storeu_pd(rest + n_rest + 4, last);
+    _partition_scatter(x, rest, n_rest + 8, pivot, inclusive, &left, &right);
+    return left;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts a bitonic sequence held in one register
+ */
+static inline DV_TARGET_AVX2 __m256d _bitonic_clean4_avx2(__m256d v) {
+    __m256d t = _mm256_permute2f128_pd(v, v, 0x01);
+    v = _mm256_blend_pd(_mm256_min_pd(v, t), _mm256_max_pd(v, t), 0xC);
+    t = _mm256_permute_pd(v, 0x5);
+    return _mm256_blend_pd(_mm256_min_pd(v, t), _mm256_max_pd(v, t), 0xA);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Merges two sorted registers into the sorted pair (lo, hi)
+ */
+static inline DV_TARGET_AVX2 void _bitonic_merge4_avx2(__m256d* a, __m256d* b) {
+    __m256d r = _mm256_permute4x64_pd(*b, 0x1B);
+    __m256d lo = _mm256_min_pd(*a, r);
+    __m256d hi = _mm256_max_pd(*a, r);
+    *a = _bitonic_clean4_avx2(lo);
+    *b = _bitonic_clean4_avx2(hi);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts up to 16 values with a bitonic sorting network in four registers
+ *
+ * The registers are first sorted column wise with a five comparator network and
+ * transposed, giving four sorted runs of four, which are then combined with
+ * bitonic merges.  Missing inputs are padded with +Inf.
+ */
+static DV_TARGET_AVX2 void _sort_small_avx2(double* x, size_t n) {
+    double buf[16];
+    memcpy(buf, x, n * sizeof(double));
+    for (size_t i = n; i < 16; ++i)
+        buf[i] = INFINITY;
+
+    __m256d r0 = _mm256_loadu_pd(buf);
+    __m256d r1 = _mm256_loadu_pd(buf + 4);
+    __m256d r2 = _mm256_loadu_pd(buf + 8);
+    __m256d r3 = _mm256_loadu_pd(buf + 12);
+
+    // Column network: (0,1) (2,3) (0,2) (1,3) (1,2)
+    __m256d t;
+    t = _mm256_min_pd(r0, r1); r1 = _mm256_max_pd(r0, r1); r0 = t;
+    t = _mm256_min_pd(r2, r3); r3 = _mm256_max_pd(r2, r3); r2 = t;
+    t = _mm256_min_pd(r0, r2); r2 = _mm256_max_pd(r0, r2); r0 = t;
+    t = _mm256_min_pd(r1, r3); r3 = _mm256_max_pd(r1, r3); r1 = t;
+    t = _mm256_min_pd(r1, r2); r2 = _mm256_max_pd(r1, r2); r1 = t;
+
+    // Transpose so every register holds one sorted run
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+    r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+
+    // Two runs of eight
+    _bitonic_merge4_avx2(&r0, &r1);
+    _bitonic_merge4_avx2(&r2, &r3);
+
+    // Final merge of (r0, r1) with (r2, r3) reversed
+    __m256d b0 = _mm256_permute4x64_pd(r3, 0x1B);
+    __m256d b1 = _mm256_permute4x64_pd(r2, 0x1B);
+    __m256d lo0 = _mm256_min_pd(r0, b0), hi0 = _mm256_max_pd(r0, b0);
+    __m256d lo1 = _mm256_min_pd(r1, b1), hi1 = _mm256_max_pd(r1, b1);
+    t = _mm256_min_pd(lo0, lo1); lo1 = _mm256_max_pd(lo0, lo1); lo0 = t;
+    t = _mm256_min_pd(hi0, hi1); hi1 = _mm256_max_pd(hi0, hi1); hi0 = t;
+
+    _mm256_storeu_pd(buf, _bitonic_clean4_avx2(lo0));
+    _mm256_storeu_pd(buf + 4, _bitonic_clean4_avx2(lo1));
+    _mm256_storeu_pd(buf + 8, _bitonic_clean4_avx2(hi0));
+    _mm256_storeu_pd(buf + 12, _bitonic_clean4_avx2(hi1));
+    memcpy(x, buf, n * sizeof(double));
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX2 __m256d _scan_combine_avx2(__m256d a, __m256d b, scan_op_t op) {
+    switch (op) {
+        case SCAN_SUM: return _mm256_add_pd(a, b);
+        case SCAN_PROD: return _mm256_mul_pd(a, b);
+        default: {
+            __m256d m = op == SCAN_MIN ? _mm256_min_pd(a, b) : _mm256_max_pd(a, b);
+            __m256d nan = _mm256_cmp_pd(a, b, _CMP_UNORD_Q);
+            return _mm256_blendv_pd(m, _mm256_add_pd(a, b), nan);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Four lane in-register scan with the block carry kept off the critical path
+ *
+ * Each block is scanned in two shift-and-combine steps, which depend only on 
+ * the loaded data.  The running carry is combined with the block total, not 
+ * with the stored result, so the loop carried dependency is a single add, 
+ * multiply, min or max per four values.
+ */
+static inline DV_TARGET_AVX2 double _scan_avx2_op(const double* x, double* out, size_t n, 
+                                                  scan_op_t op, double carry) {
+    const __m256d id = _mm256_set1_pd(_scan_identity(op));
+    __m256d run = _mm256_set1_pd(carry);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(x + i);
+        __m256d s1 = _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), id, 0x1);
+        v = _scan_combine_avx2(v, s1, op);
+        __m256d s2 = _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(1, 0, 0, 0)), id, 0x3);
+        v = _scan_combine_avx2(v, s2, op);
+        __m256d total = _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm256_storeu_pd(out + i, _scan_combine_avx2(run, v, op));
+        run = _scan_combine_avx2(run, total, op);
+    }
+    return _scan_scalar_op(x + i, out + i, n - i, op, _mm256_cvtsd_f64(run));
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _scan_avx2(const double* x, double* out, size_t n, 
+                                        scan_op_t op, double carry) {
+    switch (op) {
+        case SCAN_SUM: return _scan_avx2_op(x, out, n, SCAN_SUM, carry);
+        case SCAN_PROD: return _scan_avx2_op(x, out, n, SCAN_PROD, carry);
+        case SCAN_MIN: return _scan_avx2_op(x, out, n, SCAN_MIN, carry);
+        default: return _scan_avx2_op(x, out, n, SCAN_MAX, carry);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX2 __m256d _arith_avx2_vec(__m256d a, __m256d b, arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: return _mm256_add_pd(a, b);
+        case ARITH_SUB: return _mm256_sub_pd(a, b);
+        case ARITH_MUL: return _mm256_mul_pd(a, b);
+        default: return _mm256_div_pd(a, b);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX2 void _arith_avx2_op(const double* a, const double* b, double* out, 
+                                                 size_t n, arith_op_t op) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d r0 = _arith_avx2_vec(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), op);
+        __m256d r1 = _arith_avx2_vec(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), op);
+        _mm256_storeu_pd(out + i, r0);
+        _mm256_storeu_pd(out + i + 4, r1);
+    }
+    _arith_scalar_op(a + i, b + i, out + i, n - i, op);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 void _arith_avx2(const double* a, const double* b, double* out, 
+                                       size_t n, arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: _arith_avx2_op(a, b, out, n, ARITH_ADD); break;
+        case ARITH_SUB: _arith_avx2_op(a, b, out, n, ARITH_SUB); break;
+        case ARITH_MUL: _arith_avx2_op(a, b, out, n, ARITH_MUL); break;
+        default: _arith_avx2_op(a, b, out, n, ARITH_DIV); break;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Scaled sums with one rounding; the tail calls fma so that every 
+ *        element is rounded the same way as the vector lanes
+ */
+static DV_TARGET_AVX2 void _affine_avx2(const double* x, double* out, size_t n, 
+                                        double scale, double offset) {
+    const __m256d vs = _mm256_set1_pd(scale);
+    const __m256d vo = _mm256_set1_pd(offset);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d r0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), vs, vo);
+        __m256d r1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), vs, vo);
+        _mm256_storeu_pd(out + i, r0);
+        _mm256_storeu_pd(out + i + 4, r1);
+    }
+    for (; i < n; ++i)
+        out[i] = fma(x[i], scale, offset);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 void _axpy_avx2(double alpha, const double* x, double* y, size_t n) {
+    const __m256d va = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d r0 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+        __m256d r1 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4));
+        _mm256_storeu_pd(y + i, r0);
+        _mm256_storeu_pd(y + i + 4, r1);
+    }
+    for (; i < n; ++i)
+        y[i] = fma(alpha, x[i], y[i]);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _dot_avx2(const double* a, const double* b, size_t n) {
+    // Four independent accumulators hide the latency of vfmadd
+    __m256d vsum0 = _mm256_setzero_pd();
+    __m256d vsum1 = _mm256_setzero_pd();
+    __m256d vsum2 = _mm256_setzero_pd();
+    __m256d vsum3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        vsum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), vsum0);
+        vsum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), vsum1);
+        vsum2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), vsum2);
+        vsum3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), vsum3);
+    }
+    for (; i + 4 <= n; i += 4)
+        vsum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), vsum0);
+
+    vsum0 = _mm256_add_pd(_mm256_add_pd(vsum0, vsum1), _mm256_add_pd(vsum2, vsum3));
+    double sum = _hsum_avx2(vsum0);
+    for (; i < n; ++i)
+        sum = fma(a[i], b[i], sum);
+    return sum;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _abs_sum_avx2(const double* x, size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d vsum0 = _mm256_setzero_pd();
+    __m256d vsum1 = _mm256_setzero_pd();
+    __m256d vsum2 = _mm256_setzero_pd();
+    __m256d vsum3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        vsum0 = _mm256_add_pd(vsum0, _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i)));
+        vsum1 = _mm256_add_pd(vsum1, _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i + 4)));
+        vsum2 = _mm256_add_pd(vsum2, _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i + 8)));
+        vsum3 = _mm256_add_pd(vsum3, _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4)
+        vsum0 = _mm256_add_pd(vsum0, _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i)));
+
+    vsum0 = _mm256_add_pd(_mm256_add_pd(vsum0, vsum1), _mm256_add_pd(vsum2, vsum3));
+    return _hsum_avx2(vsum0) + _abs_sum_scalar(x + i, n - i);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX2 double _abs_max_avx2(const double* x, size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d vmax0 = _mm256_setzero_pd();
+    __m256d vmax1 = _mm256_setzero_pd();
+    __m256d vnan = _mm256_setzero_pd();
+    size_t i = 0;
+
+    // vmaxpd drops a NaN in its first operand, so NaN lanes are collected apart
+    for (; i + 8 <= n; i += 8) {
+        __m256d v0 = _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i));
+        __m256d v1 = _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i + 4));
+        vmax0 = _mm256_max_pd(v0, vmax0);
+        vmax1 = _mm256_max_pd(v1, vmax1);
+        vnan = _mm256_or_pd(vnan, _mm256_cmp_pd(v0, v1, _CMP_UNORD_Q));
+    }
+    if (_mm256_movemask_pd(vnan))
+        return NAN;
+    vmax0 = _mm256_max_pd(vmax0, vmax1);
+    __m128d max128 = _mm_max_pd(_mm256_castpd256_pd128(vmax0), 
+                                _mm256_extractf128_pd(vmax0, 1));
+    max128 = _mm_max_pd(max128, _mm_unpackhi_pd(max128, max128));
+    double tail = _abs_max_scalar(x + i, n - i);
+    return tail > _mm_cvtsd_f64(max128) || isnan(tail) ? tail : _mm_cvtsd_f64(max128);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief In place compaction that packs the kept lanes of each vector with
+ *        the partition permutation table
+ *
+ * The write cursor never passes the read cursor, so the full vector stored 
+ * at the cursor only overwrites values that were already loaded.
+ */
+static DV_TARGET_AVX2 size_t _compress_avx2(double* x, size_t n, double value, double tol) {
+    const bool nan = isnan(value);
+    const __m256d vvalue = _mm256_set1_pd(value);
+    const __m256d vtol = _mm256_set1_pd(tol);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    size_t i = 0, w = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(x + i);
+        __m256d keep;
+        if (nan) {
+            keep = _mm256_cmp_pd(v, v, _CMP_ORD_Q);
+        } else {
+            __m256d diff = _mm256_andnot_pd(sign, _mm256_sub_pd(v, vvalue));
+            keep = _mm256_and_pd(_mm256_cmp_pd(v, vvalue, _CMP_NEQ_UQ),
+                                 _mm256_cmp_pd(diff, vtol, _CMP_NLE_UQ));
+        }
+        int mask = _mm256_movemask_pd(keep);
+        __m256i perm = _mm256_loadu_si256((const __m256i*)_partition_perm_avx2[mask]);
+        _mm256_storeu_pd(x + w, _mm256_castsi256_pd(
+            _mm256_permutevar8x32_epi32(_mm256_castpd_si256(v), perm)));
+        w += _mask_popcount((unsigned)mask);
+    }
+    for (; i < n; ++i) {
+        double v = x[i];
+        x[w] = v;
+        w += _compress_keep(v, value, tol);
+    }
+    return w;
+}
+// --------------------------------------------------------------------------------
+
+static const dv_kernels _avx2_kernels = {
+    SIMD_AVX2, _min_avx2, _max_avx2, _sum_avx2, _sum_comp_avx2, _sq_dev_avx2,
+    _block_stats_avx2, _partition_avx2, _sort_small_avx2, _scan_avx2,
+    _arith_avx2, _affine_avx2, _axpy_avx2, _dot_avx2, _abs_sum_avx2, _abs_max_avx2,
+    _compress_avx2
+};
+#endif /* DV_HAS_AVX2 */
+// --------------------------------------------------------------------------------
+
+#if defined(DV_HAS_AVX512)
+/**
+ * @brief Returns a mask selecting the first n (< 8) lanes of a 512 bit register
+ */
+static inline __mmask8 _tail_mask_avx512(size_t n) {
+    return (__mmask8)((1u << n) - 1u);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _min_avx512(const double* x, size_t n) {
+    double min_val = DBL_MAX;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm512_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 63); ++i)
+        if (x[i] < min_val)
+            min_val = x[i];
+
+    __m512d vmin0 = _mm512_set1_pd(DBL_MAX);
+    __m512d vmin1 = vmin0;
+    for (; i + 15 < n; i += 16) {
+        vmin0 = _mm512_min_pd(vmin0, _mm512_load_pd(&x[i]));
+        vmin1 = _mm512_min_pd(vmin1, _mm512_load_pd(&x[i + 8]));
+    }
+    for (; i + 7 < n; i += 8)
+        vmin0 = _mm512_min_pd(vmin0, _mm512_load_pd(&x[i]));
+    if (i < n) {
+        __mmask8 k = _tail_mask_avx512(n - i);
+        vmin1 = _mm512_mask_min_pd(vmin1, k, vmin1, _mm512_maskz_loadu_pd(k, &x[i]));
+    }
+
+    double vec_min = _mm512_reduce_min_pd(_mm512_min_pd(vmin0, vmin1));
+    return vec_min < min_val ? vec_min : min_val;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _max_avx512(const double* x, size_t n) {
+    double max_val = -DBL_MAX;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm512_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 63); ++i)
+        if (x[i] > max_val)
+            max_val = x[i];
+
+    __m512d vmax0 = _mm512_set1_pd(-DBL_MAX);
+    __m512d vmax1 = vmax0;
+    for (; i + 15 < n; i += 16) {
+        vmax0 = _mm512_max_pd(vmax0, _mm512_load_pd(&x[i]));
+        vmax1 = _mm512_max_pd(vmax1, _mm512_load_pd(&x[i + 8]));
+    }
+    for (; i + 7 < n; i += 8)
+        vmax0 = _mm512_max_pd(vmax0, _mm512_load_pd(&x[i]));
+    if (i < n) {
+        __mmask8 k = _tail_mask_avx512(n - i);
+        vmax1 = _mm512_mask_max_pd(vmax1, k, vmax1, _mm512_maskz_loadu_pd(k, &x[i]));
+    }
+
+    double vec_max = _mm512_reduce_max_pd(_mm512_max_pd(vmax0, vmax1));
+    return vec_max > max_val ? vec_max : max_val;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _sum_avx512(const double* x, size_t n) {
+    double sum = 0.0;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm512_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 63); ++i)
+        sum += x[i];
+
+    __m512d vsum0 = _mm512_setzero_pd();
+    __m512d vsum1 = _mm512_setzero_pd();
+    __m512d vsum2 = _mm512_setzero_pd();
+    __m512d vsum3 = _mm512_setzero_pd();
+    for (; i + 31 < n; i += 32) {
+        vsum0 = _mm512_add_pd(vsum0, _mm512_load_pd(&x[i]));
+        vsum1 = _mm512_add_pd(vsum1, _mm512_load_pd(&x[i + 8]));
+        vsum2 = _mm512_add_pd(vsum2, _mm512_load_pd(&x[i + 16]));
+        vsum3 = _mm512_add_pd(vsum3, _mm512_load_pd(&x[i + 24]));
+    }
+    for (; i + 7 < n; i += 8)
+        vsum0 = _mm512_add_pd(vsum0, _mm512_load_pd(&x[i]));
+    if (i < n)
+        vsum1 = _mm512_add_pd(vsum1, _mm512_maskz_loadu_pd(_tail_mask_avx512(n - i), &x[i]));
+
+    vsum0 = _mm512_add_pd(_mm512_add_pd(vsum0, vsum1), _mm512_add_pd(vsum2, vsum3));
+    return sum + _mm512_reduce_add_pd(vsum0);
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX512 void _neumaier_avx512(__m512d* s, __m512d* c, __m512d x) {
+    __m512d t = _mm512_add_pd(*s, x);
+    __mmask8 ge = _mm512_cmp_pd_mask(_mm512_abs_pd(*s), _mm512_abs_pd(x), _CMP_GE_OQ);
+    __m512d big = _mm512_mask_blend_pd(ge, x, *s);
+    __m512d small = _mm512_mask_blend_pd(ge, *s, x);
+    *c = _mm512_add_pd(*c, _mm512_add_pd(_mm512_sub_pd(big, t), small));
+    *s = t;
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _sum_comp_avx512(const double* x, size_t n) {
+    __m512d s0 = _mm512_setzero_pd(), c0 = _mm512_setzero_pd();
+    __m512d s1 = _mm512_setzero_pd(), c1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 15 < n; i += 16) {
+        _neumaier_avx512(&s0, &c0, _mm512_loadu_pd(&x[i]));
+        _neumaier_avx512(&s1, &c1, _mm512_loadu_pd(&x[i + 8]));
+    }
+    if (i + 7 < n) {
+        _neumaier_avx512(&s0, &c0, _mm512_loadu_pd(&x[i]));
+        i += 8;
+    }
+    double s[16], c[16];
+    _mm512_storeu_pd(s, s0);
+    _mm512_storeu_pd(s + 8, s1);
+    _mm512_storeu_pd(c, c0);
+    _mm512_storeu_pd(c + 8, c1);
+    return _fold_comp_lanes(s, c, 16, x + i, n - i);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _sq_dev_avx512(const double* x, size_t n, double mean) {
+    double sum_sq_diff = 0.0;
+    size_t i = 0;
+
+    // Scalar head until the data is aligned for _mm512_load_pd
+    for (; i < n && ((uintptr_t)&x[i] & 63); ++i) {
+        double diff = x[i] - mean;
+        sum_sq_diff += diff * diff;
+    }
+
+    __m512d vmean = _mm512_set1_pd(mean);
+    __m512d vsum0 = _mm512_setzero_pd();
+    __m512d vsum1 = _mm512_setzero_pd();
+    for (; i + 15 < n; i += 16) {
+        __m512d diff0 = _mm512_sub_pd(_mm512_load_pd(&x[i]), vmean);
+        __m512d diff1 = _mm512_sub_pd(_mm512_load_pd(&x[i + 8]), vmean);
+        vsum0 = _mm512_fmadd_pd(diff0, diff0, vsum0);
+        vsum1 = _mm512_fmadd_pd(diff1, diff1, vsum1);
+    }
+    for (; i + 7 < n; i += 8) {
+        __m512d diff = _mm512_sub_pd(_mm512_load_pd(&x[i]), vmean);
+        vsum0 = _mm512_fmadd_pd(diff, diff, vsum0);
+    }
+    if (i < n) {
+        __mmask8 k = _tail_mask_avx512(n - i);
+        __m512d diff = _mm512_maskz_sub_pd(k, _mm512_maskz_loadu_pd(k, &x[i]), vmean);
+        vsum1 = _mm512_fmadd_pd(diff, diff, vsum1);
+    }
+    return sum_sq_diff + _mm512_reduce_add_pd(_mm512_add_pd(vsum0, vsum1));
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 void _block_stats_avx512(const double* x, size_t n, dv_block_stats* out) {
+    const __m512d vinf = _mm512_set1_pd(INFINITY);
+    const __m512i one = _mm512_set1_epi64(1);
+    __m512d vmin = _mm512_set1_pd(INFINITY);
+    __m512d vmax = _mm512_set1_pd(-INFINITY);
+    __m512d vsum = _mm512_setzero_pd();
+    __m512i vcount = _mm512_setzero_si512();
+    __m512i vinf_count = _mm512_setzero_si512();
+
+    // NaN lanes are masked out of every accumulator; the tail uses the same
+    // loop body with a partial load mask
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 k = n - i >= 8 ? (__mmask8)0xFF : _tail_mask_avx512(n - i);
+        __m512d v = _mm512_maskz_loadu_pd(k, &x[i]);
+        __mmask8 ord = _mm512_mask_cmp_pd_mask(k, v, v, _CMP_ORD_Q);
+        __mmask8 is_inf = _mm512_mask_cmp_pd_mask(ord, _mm512_abs_pd(v), vinf, _CMP_EQ_OQ);
+        vmin = _mm512_mask_min_pd(vmin, ord, vmin, v);
+        vmax = _mm512_mask_max_pd(vmax, ord, vmax, v);
+        vsum = _mm512_mask_add_pd(vsum, ord, vsum, v);
+        vcount = _mm512_mask_add_epi64(vcount, ord, vcount, one);
+        vinf_count = _mm512_mask_add_epi64(vinf_count, is_inf, vinf_count, one);
+    }
+
+    size_t count = (size_t)_mm512_reduce_add_epi64(vcount);
+    double sum = _mm512_reduce_add_pd(vsum);
+    double mean = count ? sum / count : 0.0;
+
+    __m512d vmean = _mm512_set1_pd(mean);
+    __m512d vm2 = _mm512_setzero_pd();
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 k = n - i >= 8 ? (__mmask8)0xFF : _tail_mask_avx512(n - i);
+        __m512d v = _mm512_maskz_loadu_pd(k, &x[i]);
+        __mmask8 ord = _mm512_mask_cmp_pd_mask(k, v, v, _CMP_ORD_Q);
+        __m512d diff = _mm512_maskz_sub_pd(ord, v, vmean);
+        vm2 = _mm512_fmadd_pd(diff, diff, vm2);
+    }
+
+    *out = (dv_block_stats){
+        count, (size_t)_mm512_reduce_add_epi64(vinf_count),
+        _mm512_reduce_min_pd(vmin), _mm512_reduce_max_pd(vmax),
+        sum, _mm512_reduce_add_pd(vm2)
+    };
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief In place vectorized partition using compress stores
+ *
+ * Same scheme as _partition_avx2, with the lower and upper lanes written by
+ * separate compress stores so no lane is written twice.
+ */
+static DV_TARGET_AVX512 size_t _partition_avx512(double* x, size_t n, double pivot, bool inclusive) {
+    if (n < 32)
+        return _partition_scalar(x, n, pivot, inclusive);
+
+    const __m512d vpivot = _mm512_set1_pd(pivot);
+    __m512d first = _mm512_loadu_pd(x);
+    __m512d last = _mm512_loadu_pd(x + n - 8);
+    size_t read_left = 8, read_right = n - 8;
+    size_t left = 0, right = n;
+
+    while (read_right - read_left >= 8) {
+        __m512d v;
+        if (read_left - left <= right - read_right) {
+            v = _mm512_loadu_pd(x + read_left);
+            read_left += 8;
+        } else {
+            read_right -= 8;
+            v = _mm512_loadu_pd(x + read_right);
+        }
+        __mmask8 lower = inclusive ? _mm512_cmp_pd_mask(v, vpivot, _CMP_LE_OQ) 
+                                   : _mm512_cmp_pd_mask(v, vpivot, _CMP_LT_OQ);
+        size_t n_lower = _mask_popcount((unsigned)lower);
+        _mm512_mask_compressstoreu_pd(x + left, lower, v);
+        right -= 8 - n_lower;
+        _mm512_mask_compressstoreu_pd(x + right, (__mmask8)~lower, v);
+        left += n_lower;
+    }
+
+    double rest[24];
+    size_t n_rest = read_right - read_left;
+    memcpy(rest, x + read_left, n_rest * sizeof(double));
+    _mm512_storeu_pd(rest + n_rest, first);
+    _mm512_storeu_pd(rest + n_rest + 8, last);
+    _partition_scatter(x, rest, n_rest + 16, pivot, inclusive, &left, &right);
+    return left;
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX512 __m512d _scan_combine_avx512(__m512d a, __m512d b, scan_op_t op) {
+    switch (op) {
+        case SCAN_SUM: return _mm512_add_pd(a, b);
+        case SCAN_PROD: return _mm512_mul_pd(a, b);
+        default: {
+            __m512d m = op == SCAN_MIN ? _mm512_min_pd(a, b) : _mm512_max_pd(a, b);
+            __mmask8 nan = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+            return _mm512_mask_add_pd(m, nan, a, b);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Eight lane version of _scan_avx2_op, scanning each block in three steps
+ */
+static inline DV_TARGET_AVX512 double _scan_avx512_op(const double* x, double* out, size_t n, 
+                                                      scan_op_t op, double carry) {
+    const __m512d id = _mm512_set1_pd(_scan_identity(op));
+    const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+    const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+    const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+    const __m512i last = _mm512_set1_epi64(7);
+    __m512d run = _mm512_set1_pd(carry);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(x + i);
+        v = _scan_combine_avx512(v, _mm512_mask_permutexvar_pd(id, 0xFE, shift1, v), op);
+        v = _scan_combine_avx512(v, _mm512_mask_permutexvar_pd(id, 0xFC, shift2, v), op);
+        v = _scan_combine_avx512(v, _mm512_mask_permutexvar_pd(id, 0xF0, shift4, v), op);
+        __m512d total = _mm512_permutexvar_pd(last, v);
+        _mm512_storeu_pd(out + i, _scan_combine_avx512(run, v, op));
+        run = _scan_combine_avx512(run, total, op);
+    }
+    return _scan_scalar_op(x + i, out + i, n - i, op, _mm512_cvtsd_f64(run));
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _scan_avx512(const double* x, double* out, size_t n, 
+                                            scan_op_t op, double carry) {
+    switch (op) {
+        case SCAN_SUM: return _scan_avx512_op(x, out, n, SCAN_SUM, carry);
+        case SCAN_PROD: return _scan_avx512_op(x, out, n, SCAN_PROD, carry);
+        case SCAN_MIN: return _scan_avx512_op(x, out, n, SCAN_MIN, carry);
+        default: return _scan_avx512_op(x, out, n, SCAN_MAX, carry);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX512 __m512d _arith_avx512_vec(__m512d a, __m512d b, arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: return _mm512_add_pd(a, b);
+        case ARITH_SUB: return _mm512_sub_pd(a, b);
+        case ARITH_MUL: return _mm512_mul_pd(a, b);
+        default: return _mm512_div_pd(a, b);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline DV_TARGET_AVX512 void _arith_avx512_op(const double* a, const double* b, 
+                                                     double* out, size_t n, arith_op_t op) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d r0 = _arith_avx512_vec(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), op);
+        __m512d r1 = _arith_avx512_vec(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), op);
+        _mm512_storeu_pd(out + i, r0);
+        _mm512_storeu_pd(out + i + 8, r1);
+    }
+    for (; i < n; i += 8) {
+        __mmask8 k = n - i < 8 ? _tail_mask_avx512(n - i) : 0xFF;
+        __m512d r = _arith_avx512_vec(_mm512_maskz_loadu_pd(k, a + i), 
+                                      _mm512_maskz_loadu_pd(k, b + i), op);
+        _mm512_mask_storeu_pd(out + i, k, r);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 void _arith_avx512(const double* a, const double* b, double* out, 
+                                           size_t n, arith_op_t op) {
+    switch (op) {
+        case ARITH_ADD: _arith_avx512_op(a, b, out, n, ARITH_ADD); break;
+        case ARITH_SUB: _arith_avx512_op(a, b, out, n, ARITH_SUB); break;
+        case ARITH_MUL: _arith_avx512_op(a, b, out, n, ARITH_MUL); break;
+        default: _arith_avx512_op(a, b, out, n, ARITH_DIV); break;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 void _affine_avx512(const double* x, double* out, size_t n, 
+                                            double scale, double offset) {
+    const __m512d vs = _mm512_set1_pd(scale);
+    const __m512d vo = _mm512_set1_pd(offset);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d r0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), vs, vo);
+        __m512d r1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), vs, vo);
+        _mm512_storeu_pd(out + i, r0);
+        _mm512_storeu_pd(out + i + 8, r1);
+    }
+    for (; i < n; i += 8) {
+        __mmask8 k = n - i < 8 ? _tail_mask_avx512(n - i) : 0xFF;
+        _mm512_mask_storeu_pd(out + i, k, _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, x + i), vs, vo));
+    }
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 void _axpy_avx512(double alpha, const double* x, double* y, size_t n) {
+    const __m512d va = _mm512_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d r0 = _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i));
+        __m512d r1 = _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8));
+        _mm512_storeu_pd(y + i, r0);
+        _mm512_storeu_pd(y + i + 8, r1);
+    }
+    for (; i < n; i += 8) {
+        __mmask8 k = n - i < 8 ? _tail_mask_avx512(n - i) : 0xFF;
+        __m512d r = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(k, x + i), 
+                                    _mm512_maskz_loadu_pd(k, y + i));
+        _mm512_mask_storeu_pd(y + i, k, r);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _dot_avx512(const double* a, const double* b, size_t n) {
+    __m512d vsum0 = _mm512_setzero_pd();
+    __m512d vsum1 = _mm512_setzero_pd();
+    __m512d vsum2 = _mm512_setzero_pd();
+    __m512d vsum3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        vsum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), vsum0);
+        vsum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), vsum1);
+        vsum2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), vsum2);
+        vsum3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), vsum3);
+    }
+    for (; i + 8 <= n; i += 8)
+        vsum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), vsum0);
+    if (i < n) {
+        __mmask8 k = _tail_mask_avx512(n - i);
+        vsum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a + i), 
+                                _mm512_maskz_loadu_pd(k, b + i), vsum1);
+    }
+
+    vsum0 = _mm512_add_pd(_mm512_add_pd(vsum0, vsum1), _mm512_add_pd(vsum2, vsum3));
+    return _mm512_reduce_add_pd(vsum0);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _abs_sum_avx512(const double* x, size_t n) {
+    __m512d vsum0 = _mm512_setzero_pd();
+    __m512d vsum1 = _mm512_setzero_pd();
+    __m512d vsum2 = _mm512_setzero_pd();
+    __m512d vsum3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        vsum0 = _mm512_add_pd(vsum0, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+        vsum1 = _mm512_add_pd(vsum1, _mm512_abs_pd(_mm512_loadu_pd(x + i + 8)));
+        vsum2 = _mm512_add_pd(vsum2, _mm512_abs_pd(_mm512_loadu_pd(x + i + 16)));
+        vsum3 = _mm512_add_pd(vsum3, _mm512_abs_pd(_mm512_loadu_pd(x + i + 24)));
+    }
+    for (; i + 8 <= n; i += 8)
+        vsum0 = _mm512_add_pd(vsum0, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+    if (i < n) {
+        __m512d v = _mm512_maskz_loadu_pd(_tail_mask_avx512(n - i), x + i);
+        vsum1 = _mm512_add_pd(vsum1, _mm512_abs_pd(v));
+    }
+
+    vsum0 = _mm512_add_pd(_mm512_add_pd(vsum0, vsum1), _mm512_add_pd(vsum2, vsum3));
+    return _mm512_reduce_add_pd(vsum0);
+}
+// --------------------------------------------------------------------------------
+
+static DV_TARGET_AVX512 double _abs_max_avx512(const double* x, size_t n) {
+    __m512d vmax0 = _mm512_setzero_pd();
+    __m512d vmax1 = _mm512_setzero_pd();
+    __mmask8 nan = 0;
+    size_t i = 0;
+
+    // vmaxpd drops a NaN in its first operand, so NaN lanes are collected apart
+    for (; i + 16 <= n; i += 16) {
+        __m512d v0 = _mm512_abs_pd(_mm512_loadu_pd(x + i));
+        __m512d v1 = _mm512_abs_pd(_mm512_loadu_pd(x + i + 8));
+        vmax0 = _mm512_max_pd(v0, vmax0);
+        vmax1 = _mm512_max_pd(v1, vmax1);
+        nan |= _mm512_cmp_pd_mask(v0, v1, _CMP_UNORD_Q);
+    }
+    for (; i < n; i += 8) {
+        __mmask8 k = n - i < 8 ? _tail_mask_avx512(n - i) : 0xFF;
+        __m512d v = _mm512_abs_pd(_mm512_maskz_loadu_pd(k, x + i));
+        vmax0 = _mm512_max_pd(v, vmax0);
+        nan |= _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q);
+    }
+    if (nan)
+        return NAN;
+    return _mm512_reduce_max_pd(_mm512_max_pd(vmax0, vmax1));
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Same scheme as _compress_avx2 with the lanes packed by a register
+ *        compress, which avoids the slow memory form of the compress store
+ */
+static DV_TARGET_AVX512 size_t _compress_avx512(double* x, size_t n, double value, double tol) {
+    const bool nan = isnan(value);
+    const __m512d vvalue = _mm512_set1_pd(value);
+    const __m512d vtol = _mm512_set1_pd(tol);
+    size_t i = 0, w = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(x + i);
+        __mmask8 keep;
+        if (nan) {
+            keep = _mm512_cmp_pd_mask(v, v, _CMP_ORD_Q);
+        } else {
+            __m512d diff = _mm512_abs_pd(_mm512_sub_pd(v, vvalue));
+            keep = _mm512_cmp_pd_mask(v, vvalue, _CMP_NEQ_UQ) & 
+                   _mm512_cmp_pd_mask(diff, vtol, _CMP_NLE_UQ);
+        }
+        _mm512_storeu_pd(x + w, _mm512_maskz_compress_pd(keep, v));
+        w += _mask_popcount((unsigned)keep);
+    }
+    for (; i < n; ++i) {
+        double v = x[i];
+        x[w] = v;
+        w += _compress_keep(v, value, tol);
+    }
+    return w;
+}
+// --------------------------------------------------------------------------------
+
+static const dv_kernels _avx512_kernels = {
+    SIMD_AVX512, _min_avx512, _max_avx512, _sum_avx512, _sum_comp_avx512, _sq_dev_avx512,
+    _block_stats_avx512, _partition_avx512, _sort_small_avx2,  // AVX-512 implies AVX2 here
+    _scan_avx512, _arith_avx512, _affine_avx512, _axpy_avx512, _dot_avx512, _abs_sum_avx512, 
+    _abs_max_avx512, _compress_avx512
+};
+#endif /* DV_HAS_AVX512 */
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the kernel table for a SIMD level, or NULL if it was not compiled
+ */
+static const dv_kernels* _kernels_for_level(simd_level_t level) {
+    switch (level) {
+        case SIMD_SCALAR: return &_scalar_kernels;
+#if defined(DV_HAS_SSE2)
+        case SIMD_SSE2: return &_sse2_kernels;
+#endif
+#if defined(DV_HAS_AVX2)
+        case SIMD_AVX2: return &_avx2_kernels;
+#endif
+#if defined(DV_HAS_AVX512)
+        case SIMD_AVX512: return &_avx512_kernels;
+#endif
+        default: return NULL;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the highest SIMD level supported by both the build and the CPU
+ */
+static simd_level_t _detect_simd_level(void) {
+#if defined(DV_X86_DISPATCH)
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (avx2 && __builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (avx2) return SIMD_AVX2;
+    return SIMD_SSE2;
+#elif defined(DV_HAS_AVX512)
+    return SIMD_AVX512;
+#elif defined(DV_HAS_AVX2)
+    return SIMD_AVX2;
+#elif defined(DV_HAS_SSE2)
+    return SIMD_SSE2;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+// Without load time dispatch the compile time choice is the final one
+#if defined(DV_X86_DISPATCH)
+static const dv_kernels* _kern = &_sse2_kernels;
+
+__attribute__((constructor)) static void _init_kernels(void) {
+    _kern = _kernels_for_level(_detect_simd_level());
+}
+#elif defined(DV_HAS_AVX512)
+static const dv_kernels* _kern = &_avx512_kernels;
+#elif defined(DV_HAS_AVX2)
+static const dv_kernels* _kern = &_avx2_kernels;
+#elif defined(DV_HAS_SSE2)
+static const dv_kernels* _kern = &_sse2_kernels;
+#else
+static const dv_kernels* _kern = &_scalar_kernels;
+#endif
+// --------------------------------------------------------------------------------
+
+simd_level_t double_simd_level(void) {
+    return _kern->level;
+}
+// --------------------------------------------------------------------------------
+
+bool set_double_simd_level(simd_level_t level) {
+    if (level < SIMD_SCALAR || level > SIMD_AVX512) {
+        errno = EINVAL;
+        return false;
+    }
+    if (level > _detect_simd_level() || !_kernels_for_level(level)) {
+        errno = ENOTSUP;
+        return false;
+    }
+    _kern = _kernels_for_level(level);
+    return true;
+}
+// ================================================================================
+// ================================================================================ 
+// THREAD POOL
+//
+// Reductions over large vectors are split into fixed PARALLEL_CHUNK_SIZE chunks
+// whose partial results are combined in chunk order.  The chunk boundaries do
+// not depend on the number of threads, so a result is reproducible bit for bit
+// on any machine and with any thread count.  Workers are started on first use
+// and live until the thread count changes or the program exits.
+
+/**
+ * @brief Work item executed once for every task index of a parallel job
+ */
+typedef void (*dv_task_fn)(void* ctx, size_t task);
+// --------------------------------------------------------------------------------
+
+static size_t _thread_count = 0;  // 0 selects one thread per online CPU
+static size_t _parallel_threshold = PARALLEL_MIN_ELEMENTS;
+// --------------------------------------------------------------------------------
+
+#if defined(DV_HAS_PTHREAD)
+typedef struct {
+    pthread_mutex_t run_lock;   // Serializes jobs and pool changes
+    pthread_mutex_t lock;       // Protects the job state below
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    pthread_t* workers;
+    size_t n_workers;
+    bool started;
+    bool shutdown;
+    dv_task_fn fn;
+    void* ctx;
+    size_t n_tasks;
+    size_t next_task;
+    size_t pending;
+} dv_pool;
+
+static dv_pool _pool = {
+    .run_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_cv = PTHREAD_COND_INITIALIZER,
+    .done_cv = PTHREAD_COND_INITIALIZER
+};
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Claims and runs tasks of the current job until none are left
+ *
+ * Called with _pool.lock held and returns with it held.
+ */
+static void _pool_drain(void) {
+    while (_pool.next_task < _pool.n_tasks) {
+        size_t task = _pool.next_task++;
+        pthread_mutex_unlock(&_pool.lock);
+        _pool.fn(_pool.ctx, task);
+        pthread_mutex_lock(&_pool.lock);
+        if (--_pool.pending == 0)
+            pthread_cond_signal(&_pool.done_cv);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static void* _pool_worker(void* arg) {
+    (void) arg;
+    pthread_mutex_lock(&_pool.lock);
+    for (;;) {
+        while (!_pool.shutdown && _pool.next_task >= _pool.n_tasks)
+            pthread_cond_wait(&_pool.work_cv, &_pool.lock);
+        if (_pool.shutdown)
+            break;
+        _pool_drain();
+    }
+    pthread_mutex_unlock(&_pool.lock);
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Stops and joins all workers.  Called with _pool.run_lock held.
+ */
+static void _pool_stop(void) {
+    if (!_pool.started) return;
+    pthread_mutex_lock(&_pool.lock);
+    _pool.shutdown = true;
+    pthread_cond_broadcast(&_pool.work_cv);
+    pthread_mutex_unlock(&_pool.lock);
+    for (size_t i = 0; i < _pool.n_workers; ++i)
+        pthread_join(_pool.workers[i], NULL);
+    free(_pool.workers);
+    _pool.workers = NULL;
+    _pool.n_workers = 0;
+    _pool.shutdown = false;
+    _pool.started = false;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Starts threads - 1 workers, the calling thread being the last one.  
+ *        Called with _pool.run_lock held.
+ */
+static void _pool_start(size_t threads) {
+    _pool.started = true;
+    if (threads < 2) return;
+    _pool.workers = malloc((threads - 1) * sizeof(pthread_t));
+    if (!_pool.workers) return;
+    for (size_t i = 0; i < threads - 1; ++i) {
+        if (pthread_create(&_pool.workers[i], NULL, _pool_worker, NULL) != 0)
+            break;
+        _pool.n_workers++;
+    }
+}
+// --------------------------------------------------------------------------------
+
+__attribute__((destructor)) static void _pool_exit(void) {
+    pthread_mutex_lock(&_pool.run_lock);
+    _pool_stop();
+    pthread_mutex_unlock(&_pool.run_lock);
+}
+#endif /* DV_HAS_PTHREAD */
+// --------------------------------------------------------------------------------
+
+size_t double_thread_count(void) {
+    if (_thread_count != 0)
+        return _thread_count;
+#if defined(DV_HAS_PTHREAD)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t)cpus : 1;
+#else
+    return 1;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool set_double_thread_count(size_t threads) {
+    if (threads > PARALLEL_MAX_THREADS) {
+        errno = EINVAL;
+        return false;
+    }
+#if defined(DV_HAS_PTHREAD)
+    pthread_mutex_lock(&_pool.run_lock);
+    _pool_stop();
+    _thread_count = threads;
+    pthread_mutex_unlock(&_pool.run_lock);
+#else
+    _thread_count = threads;
+#endif
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t double_parallel_threshold(void) {
+    return _parallel_threshold;
+}
+// --------------------------------------------------------------------------------
+
+void set_double_parallel_threshold(size_t elements) {
+    _parallel_threshold = elements;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Runs fn(ctx, task) for task = 0 .. n_tasks - 1 on the thread pool
+ *
+ * The calling thread takes part in the work.  If the pool is busy with a job
+ * from another thread, or threads are unavailable, the tasks run serially on
+ * the caller, which gives the same result because tasks are independent.
+ */
+static void _parallel_for(dv_task_fn fn, void* ctx, size_t n_tasks) {
+#if defined(DV_HAS_PTHREAD)
+    if (n_tasks > 1 && pthread_mutex_trylock(&_pool.run_lock) == 0) {
+        if (!_pool.started) {
+            size_t threads = double_thread_count();
+            if (threads > PARALLEL_MAX_THREADS) threads = PARALLEL_MAX_THREADS;
+            _pool_start(threads);
+        }
+        if (_pool.n_workers > 0) {
+            pthread_mutex_lock(&_pool.lock);
+            _pool.fn = fn;
+            _pool.ctx = ctx;
+            _pool.n_tasks = n_tasks;
+            _pool.next_task = 0;
+            _pool.pending = n_tasks;
+            pthread_cond_broadcast(&_pool.work_cv);
+            _pool_drain();
+            while (_pool.pending > 0)
+                pthread_cond_wait(&_pool.done_cv, &_pool.lock);
+            _pool.n_tasks = 0;
+            _pool.next_task = 0;
+            pthread_mutex_unlock(&_pool.lock);
+            pthread_mutex_unlock(&_pool.run_lock);
+            return;
+        }
+        pthread_mutex_unlock(&_pool.run_lock);
+    }
+#endif
+    for (size_t task = 0; task < n_tasks; ++task)
+        fn(ctx, task);
+}
+// ================================================================================
+// ================================================================================ 
+
+double_v* init_double_vector(size_t buff) {
+    if (buff == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    double_v* struct_ptr = malloc(sizeof(double_v));
+    if (struct_ptr == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+   
+    double* data_ptr = _aligned_alloc_double(buff);
+    if (data_ptr == NULL) {
+        free(struct_ptr);
+        errno = ENOMEM;
+        return NULL; 
+    }
+   
+    // Initialize all elements
+    memset(data_ptr, 0, buff * sizeof(double));
+   
+    struct_ptr->data = data_ptr;
+    struct_ptr->len = 0;
+    struct_ptr->alloc = buff;
+    struct_ptr->alloc_type = DYNAMIC;
+    struct_ptr->growth = GROWTH_DEFAULT;
+    struct_ptr->growth_factor = VEC_GROWTH_FACTOR;
+    struct_ptr->growth_step = VEC_FIXED_AMOUNT;
+    struct_ptr->anon_mmap = false;
+    struct_ptr->sum_mode = SUM_NAIVE;
+    struct_ptr->sorted = false;
+    struct_ptr->head = 0;
+    struct_ptr->deque = false;
+    return struct_ptr;
+}
+// -------------------------------------------------------------------------------- 
+
+double* c_double_ptr(double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    // Writes through the raw pointer cannot be tracked
+    vec->sorted = false;
+    return vec->data;
+}
+// --------------------------------------------------------------------------------
+
+double_v view_double_vector(double_v* vec, size_t start, size_t len) {
+    double_v view = {.alloc_type = VIEW};
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return view;
+    }
+    if (start > vec->len || len > vec->len - start) {
+        errno = ERANGE;
+        return view;
+    }
+    view.data = vec->data + start;
+    view.len = len;
+    view.alloc = len;
+    view.sum_mode = vec->sum_mode;
+    // vec can change after this call without the view knowing, so the view 
+    // never starts sorted; is_sorted_double_vector sets the flag in one scan
+    view.sorted = false;
+    // A view of a read only mapping is just as read only
+    view.map_mode = vec->alloc_type == MAPPED || vec->alloc_type == VIEW ? 
+                    vec->map_mode : MAPPED_READ_WRITE;
+    // Writes through the view cannot be tracked in vec
+    vec->sorted = false;
+    return view;
+}
+// --------------------------------------------------------------------------------
+
+double_v view_double_array(double* data, size_t len) {
+    double_v view = {.alloc_type = VIEW};
+    if (!data) {
+        errno = EINVAL;
+        return view;
+    }
+    view.data = data;
+    view.len = len;
+    view.alloc = len;
+    view.map_mode = MAPPED_READ_WRITE;
+    return view;
+}
+// --------------------------------------------------------------------------------
+
+#if defined(DV_HAS_MREMAP)
+/**
+ * @brief Rounds a byte count up to a whole number of pages
+ */
+static size_t _page_round(size_t bytes) {
+    static size_t page = 0;
+    if (page == 0) {
+        long sz = sysconf(_SC_PAGESIZE);
+        page = sz > 0 ? (size_t)sz : 4096;
+    }
+    return (bytes + page - 1) / page * page;
+}
+#endif
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Releases the buffer of a dynamically allocated vector
+ */
+static void _free_double_buffer(double_v* vec) {
+    double* base = vec->data - vec->head;
+#if defined(DV_HAS_MMAP)
+    if (vec->alloc_type == MAPPED) {
+        munmap(base, (vec->head + vec->alloc) * sizeof(double));
+        return;
+    }
+#endif
+#if defined(DV_HAS_MREMAP)
+    if (vec->anon_mmap) {
+        munmap(base, _page_round((vec->head + vec->alloc) * sizeof(double)));
+        return;
+    }
+#endif
+    _aligned_free_double(base);
+}
+// --------------------------------------------------------------------------------
+
+void free_double_vector(double_v* vec) {
+   if (!vec || (vec->alloc_type != DYNAMIC && vec->alloc_type != MAPPED)) {
+       errno = EINVAL;
+       return;
+   }
+   if (vec->data) _free_double_buffer(vec);
+   free(vec);
+}
+// --------------------------------------------------------------------------------
+
+void _free_double_vector(double_v** vec) {
+    if (vec && *vec) {
+        free_double_vector(*vec);
+        *vec = NULL;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Multiplies a capacity by a growth factor without overflowing
+ */
+static size_t _scale_alloc(size_t alloc, double factor) {
+    const size_t max_alloc = SIZE_MAX / sizeof(double);
+    double scaled = (double)alloc * factor;
+    if (scaled >= (double)max_alloc) return max_alloc;
+    size_t new_alloc = (size_t)scaled;
+    return new_alloc > alloc ? new_alloc : alloc + 1;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the capacity a vector grows to under its growth policy
+ *
+ * @param vec A dynamically allocated double vector
+ * @param needed The minimum number of elements the buffer must hold
+ * @return The new capacity, never smaller than needed
+ */
+static size_t _next_alloc_double_vector(const double_v* vec, size_t needed) {
+    size_t alloc = vec->alloc == 0 ? 1 : vec->alloc;
+    size_t new_alloc;
+
+    switch (vec->growth) {
+        case GROWTH_FIXED: {
+            size_t step = vec->growth_step ? vec->growth_step : VEC_FIXED_AMOUNT;
+            new_alloc = step > SIZE_MAX - alloc ? SIZE_MAX : alloc + step;
+            break;
+        }
+        case GROWTH_GEOMETRIC:
+        case GROWTH_MREMAP:
+            new_alloc = _scale_alloc(alloc, vec->growth_factor > 1.0 ? 
+                                     vec->growth_factor : VEC_GROWTH_FACTOR);
+            break;
+        default:
+            new_alloc = alloc < VEC_THRESHOLD ? alloc * 2 : 
+                        _scale_alloc(alloc, VEC_LARGE_GROWTH_FACTOR);
+            break;
+    }
+    return new_alloc < needed ? needed : new_alloc;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Moves the elements of a deque back to the start of its buffer, 
+ *        which makes the free space in front of data usable at the back
+ */
+static void _deque_compact(double_v* vec) {
+    if (vec->head == 0) return;
+    double* base = vec->data - vec->head;
+    memmove(base, vec->data, vec->len * sizeof(double));
+    vec->data = base;
+    vec->alloc += vec->head;
+    vec->head = 0;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Moves the buffer of a dynamically allocated vector to a new capacity
+ *
+ * Uses an aligned reallocation, or mmap/mremap for large GROWTH_MREMAP vectors
+ * so the kernel can remap pages instead of copying them.  Either way the buffer
+ * stays aligned to DOUBLE_VECTOR_ALIGNMENT.  Memory beyond len is left
+ * uninitialized.
+ *
+ * @param vec A dynamically allocated double vector
+ * @param new_alloc The new capacity, must be at least vec->len
+ * @return true if successful, false otherwise with errno set to ERANGE or ENOMEM
+ */
+static bool _realloc_double_vector(double_v* vec, size_t new_alloc) {
+    if (new_alloc > SIZE_MAX / sizeof(double)) {
+        errno = ERANGE;
+        return false;
+    }
+    _deque_compact(vec);
+
+#if defined(DV_HAS_MREMAP)
+    const size_t bytes = new_alloc * sizeof(double);
+    if (vec->anon_mmap) {
+        void* ptr = mremap(vec->data, _page_round(vec->alloc * sizeof(double)),
+                           _page_round(bytes), MREMAP_MAYMOVE);
+        if (ptr == MAP_FAILED) {
+            errno = ENOMEM;
+            return false;
+        }
+        vec->data = ptr;
+        vec->alloc = new_alloc;
+        return true;
+    }
+    if (vec->growth == GROWTH_MREMAP && bytes >= MREMAP_MIN_BYTES) {
+        void* ptr = mmap(NULL, _page_round(bytes), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            errno = ENOMEM;
+            return false;
+        }
+        memcpy(ptr, vec->data, vec->len * sizeof(double));
+        _aligned_free_double(vec->data);
+        vec->data = ptr;
+        vec->alloc = new_alloc;
+        vec->anon_mmap = true;
+        return true;
+    }
+#endif
+
+    double* new_data = _aligned_realloc_double(vec->data, vec->len, new_alloc);
+    if (!new_data) {
+        errno = ENOMEM;
+        return false;
+    }
+    vec->data = new_data;
+    vec->alloc = new_alloc;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Grows the buffer of a vector so that it can hold at least needed elements
+ *
+ * The growth policy is applied once, so a caller that knows how many elements it
+ * is about to write gets a single reallocation.  The new capacity is not zero
+ * filled since the caller overwrites it.
+ *
+ * @param vec A double vector
+ * @param needed The minimum number of elements the buffer must hold
+ * @return true if successful, false otherwise with errno set to EINVAL, ERANGE
+ *         or ENOMEM
+ */
+static bool _grow_double_vector(double_v* vec, size_t needed) {
+    if (needed <= vec->alloc) return true;
+    // The space a deque freed at the front is reused once it is at least half
+    // the length, so the move is paid for by the pops that freed it
+    if (vec->head > 0 && needed <= vec->head + vec->alloc && 
+        (vec->alloc_type != DYNAMIC || vec->head >= vec->len / 2)) {
+        _deque_compact(vec);
+        return true;
+    }
+    if (vec->alloc_type != DYNAMIC) {
+        errno = EINVAL;
+        return false;
+    }
+    return _realloc_double_vector(vec, _next_alloc_double_vector(vec, needed));
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns true if a may precede b in ascending order with NaN last
+ */
+static inline bool _in_order(double a, double b) {
+    return isnan(b) || a <= b;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns true with errno set to EPERM if the elements of vec lie in a
+ *        read only mapping
+ *
+ * Writing to those pages would raise SIGSEGV, so every function that changes
+ * the elements in place checks here first.
+ */
+static inline bool _read_only(const double_v* vec) {
+    if ((vec->alloc_type == MAPPED || vec->alloc_type == VIEW) && 
+        vec->map_mode == MAPPED_READ_ONLY) {
+        errno = EPERM;
+        return true;
+    }
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns true if n values are ascending with NaN last
+ *
+ * Pairs are tested a block at a time without early exits inside the block, so
+ * the compiler can vectorize the comparisons.
+ */
+static bool _is_ascending(const double* x, size_t n) {
+    for (size_t i = 1; i < n; i += ORDER_BLOCK_SIZE) {
+        size_t end = n - i < ORDER_BLOCK_SIZE ? n : i + ORDER_BLOCK_SIZE;
+        int bad = 0;
+        for (size_t j = i; j < end; ++j)
+            bad |= !((x[j] != x[j]) | (x[j - 1] <= x[j]));
+        if (bad) return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool push_back_double_vector(double_v* vec, const double value) {
+    if (vec == NULL|| vec->data == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+   
+    // Check if we need to resize
+    if (vec->len >= vec->alloc && !_grow_double_vector(vec, vec->len + 1)) {
+        return false;
+    }
+    vec->sorted = vec->len == 0 || 
+                  (vec->sorted && _in_order(vec->data[vec->len - 1], value));
+    vec->data[vec->len] = value; 
+    vec->len++;
+   
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Makes room in front of the first element of a deque
+ *
+ * The elements are moved to the middle of the free space, growing the buffer
+ * first when less than half the length is free.  Each move leaves about half
+ * the length free in front, so push_front is amortized O(1).
+ */
+static bool _deque_front_room(double_v* vec) {
+    if (vec->head > 0) return true;
+    size_t spare = vec->alloc - vec->len;
+    if (spare == 0 || (spare <= vec->len / 2 && vec->alloc_type == DYNAMIC)) {
+        if (vec->alloc_type != DYNAMIC) {
+            errno = EINVAL;
+            return false;
+        }
+        if (!_realloc_double_vector(vec, _next_alloc_double_vector(vec, vec->len + 1)))
+            return false;
+        spare = vec->alloc - vec->len;
+    }
+    size_t shift = (spare + 1) / 2;
+    memmove(vec->data + shift, vec->data, vec->len * sizeof(double));
+    vec->data += shift;
+    vec->head = shift;
+    vec->alloc -= shift;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool push_front_double_vector(double_v* vec, const double value) {
+    if (vec == NULL || vec->data == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (vec->deque) {
+        if (!_deque_front_room(vec)) return false;
+        vec->sorted = vec->len == 0 || (vec->sorted && _in_order(value, vec->data[0]));
+        vec->data--;
+        vec->head--;
+        vec->alloc++;
+        vec->data[0] = value;
+        vec->len++;
+        return true;
+    }
+   
+    // Check if we need to resize
+    if (vec->len >= vec->alloc && !_grow_double_vector(vec, vec->len + 1)) {
+        return false;
+    }
+
+    // Check for length overflow
+    if (vec->len > SIZE_MAX - 1) {
+        errno = ERANGE;
+        return false;
+    }
+    
+    vec->sorted = vec->len == 0 || (vec->sorted && _in_order(value, vec->data[0]));
+
+    // Move existing elements right if there are any
+    if (vec->len > 0) {
+        memmove(vec->data + 1, vec->data, vec->len * sizeof(double));
+    }
+    
+    vec->data[0] = value;    
+    vec->len++;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool insert_double_vector(double_v* vec, double value, size_t index) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return false;
+    }
+    if (index > vec->len) {
+        errno = ERANGE;
+        return false;
+    }
+    if (vec->len >= SIZE_MAX) {  // Check length overflow
+        errno = ERANGE;
+        return false;
+    }
+   
+    // Check if we need to resize
+    if (vec->len >= vec->alloc && !_grow_double_vector(vec, vec->len + 1)) {
+        return false;
+    }
+    
+    vec->sorted = vec->len == 0 || 
+                  (vec->sorted && (index == 0 || _in_order(vec->data[index - 1], value)) &&
+                   (index == vec->len || _in_order(value, vec->data[index])));
+
+    // Move existing elements right
+    if (index < vec->len) {  // Only move if not appending
+        // Check for size_t overflow in move operation
+        if (vec->len - index > SIZE_MAX - 1) {
+            errno = ERANGE;
+            return false;
+        }
+        memmove(vec->data + index + 1, vec->data + index, 
+                (vec->len - index) * sizeof(double));
+    }
+    
+    vec->data[index] = value;
+    vec->len++;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool extend_double_vector(double_v* vec, const double* src, size_t n) {
+    if (!vec || !vec->data || (!src && n > 0)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (n == 0) return true;
+    if (n > SIZE_MAX - vec->len) {
+        errno = ERANGE;
+        return false;
+    }
+
+    // src may point into the buffer that is about to be reallocated
+    bool aliased = src >= vec->data && src < vec->data + vec->alloc;
+    size_t offset = aliased ? (size_t)(src - vec->data) : 0;
+
+    if (!_grow_double_vector(vec, vec->len + n)) {
+        return false;
+    }
+    if (aliased) src = vec->data + offset;
+
+    // The order survives when src is ascending and continues from the last value
+    if (vec->sorted || vec->len == 0) {
+        vec->sorted = (vec->len == 0 || _in_order(vec->data[vec->len - 1], src[0])) &&
+                      _is_ascending(src, n);
+    }
+
+    memcpy(vec->data + vec->len, src, n * sizeof(double));
+    vec->len += n;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool append_double_vector(double_v* vec, const double_v* other) {
+    if (!vec || !vec->data || !other || !other->data) {
+        errno = EINVAL;
+        return false;
+    }
+    return extend_double_vector(vec, other->data, other->len);
+}
+// -------------------------------------------------------------------------------- 
+
+
+double pop_back_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return DBL_MAX;
+    }
+    
+    // Create copy of last element
+    double temp = vec->data[vec->len - 1];
+    // Clear the last element (which was moved)
+    memset(&vec->data[vec->len - 1], 0, sizeof(double));
+    vec->len--;
+    return temp;
+}
+// --------------------------------------------------------------------------------
+
+double pop_front_double_vector(double_v* vec) {  // Fixed function name
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+   
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return DBL_MAX;
+    }
+   
+    // Check for overflow in memmove size calculation
+    if (vec->len > SIZE_MAX / sizeof(double)) {
+        errno = ERANGE;
+        return DBL_MAX;
+    }
+   
+    // Create copy of first element
+    double temp = vec->data[0];
+
+    // A deque only moves its start; an emptied deque starts over at the 
+    // aligned beginning of its buffer
+    if (vec->deque) {
+        vec->data[0] = 0.0;
+        vec->len--;
+        if (vec->len == 0) {
+            vec->data -= vec->head;
+            vec->alloc += vec->head;
+            vec->head = 0;
+        } else {
+            vec->data++;
+            vec->head++;
+            vec->alloc--;
+        }
+        return temp;
+    }
+
+    // Shift remaining elements left
+    memmove(vec->data, vec->data + 1, (vec->len - 1) * sizeof(double));
+   
+    // Clear the last element (which was moved)
+    memset(&vec->data[vec->len - 1], 0, sizeof(double));
+   
+    vec->len--;
+    return temp;
+}
+// --------------------------------------------------------------------------------
+
+double pop_any_double_vector(double_v* vec, size_t index) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+   
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return DBL_MAX;
+    }
+    
+    if (index >= vec->len) {
+        errno = ERANGE;
+        return DBL_MAX;
+    }
+    
+    // Create copy of element to pop
+    double temp = vec->data[index];
+    
+    // If not the last element, shift remaining elements left
+    if (index < vec->len - 1) {
+        // Check for overflow in memmove size calculation
+        if ((vec->len - index - 1) > SIZE_MAX / sizeof(double)) {
+            errno = ERANGE;
+            return DBL_MAX;
+        }
+        
+        memmove(&vec->data[index], &vec->data[index + 1], 
+                (vec->len - index - 1) * sizeof(double));
+    }
+   
+    // Clear the last element
+    memset(&vec->data[vec->len - 1], 0, sizeof(double));
+    
+    vec->len--;
+    return temp;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Drops count elements starting at start with one move of the tail 
+ *        and clears the freed elements
+ */
+static void _erase_range(double_v* vec, size_t start, size_t count) {
+    if (count == 0) return;
+    memmove(vec->data + start, vec->data + start + count, 
+            (vec->len - start - count) * sizeof(double));
+    memset(vec->data + vec->len - count, 0, count * sizeof(double));
+    vec->len -= count;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Drops the elements past keep, which a compaction has already 
+ *        moved, and returns how many were removed
+ */
+static size_t _compress_finish(double_v* vec, size_t keep) {
+    size_t removed = vec->len - keep;
+    memset(vec->data + keep, 0, removed * sizeof(double));
+    vec->len = keep;
+    return removed;
+}
+// --------------------------------------------------------------------------------
+
+bool erase_range_double_vector(double_v* vec, size_t start, size_t count) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return false;
+    }
+    if (start > vec->len || count > vec->len - start) {
+        errno = ERANGE;
+        return false;
+    }
+    _erase_range(vec, start, count);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t remove_value_double_vector(double_v* vec, double value, double tol) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW ||
+        !(tol >= 0.0)) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (isnan(value) || !vec->sorted)
+        return _compress_finish(vec, _kern->compress(vec->data, vec->len, value, tol));
+
+    // In sorted data the matches form one run: everything before it is below
+    // value and unmatched, and inside it the distance to value only grows
+    const double* x = vec->data;
+    size_t lo = 0, hi = vec->len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (x[mid] < value && _compress_keep(x[mid], value, tol)) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t first = lo;
+    hi = vec->len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (!_compress_keep(x[mid], value, tol)) lo = mid + 1;
+        else hi = mid;
+    }
+    _erase_range(vec, first, lo - first);
+    return lo - first;
+}
+// --------------------------------------------------------------------------------
+
+size_t remove_nan_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (!vec->sorted)
+        return _compress_finish(vec, _kern->compress(vec->data, vec->len, NAN, 0.0));
+
+    // NaN values sit at the end of sorted data
+    size_t keep = vec->len;
+    while (keep > 0 && isnan(vec->data[keep - 1])) keep--;
+    return _compress_finish(vec, keep);
+}
+// --------------------------------------------------------------------------------
+
+size_t remove_if_double_vector(double_v* vec, double_predicate pred, void* user_data) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW || 
+        !pred) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    double* x = vec->data;
+    size_t w = 0;
+    for (size_t i = 0; i < vec->len; ++i) {
+        double v = x[i];
+        x[w] = v;
+        w += !pred(v, user_data);
+    }
+    return _compress_finish(vec, w);
+}
+// --------------------------------------------------------------------------------
+
+const double double_vector_index(const double_v* vec, size_t index) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    if (index > vec->len - 1) {
+        errno = ERANGE;
+        return DBL_MAX;
+    }
+    return vec->data[index];
+}
+// // --------------------------------------------------------------------------------
+//
+const size_t double_vector_size(const double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return vec->len;
+}
+// --------------------------------------------------------------------------------
+
+const size_t double_vector_alloc(const double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return vec->alloc;
+}
+// --------------------------------------------------------------------------------
+
+size_t double_vector_alignment(const double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return 0;
+    }
+    uintptr_t addr = (uintptr_t)vec->data;
+    size_t alignment = (size_t)(addr & (~addr + 1));  // lowest set bit
+    return alignment > 4096 || alignment == 0 ? 4096 : alignment;
+}
+// --------------------------------------------------------------------------------
+
+void reverse_double_vector(double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return;
+    }
+    if (_read_only(vec)) return;
+
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return;
+    }
+
+    if (vec->len > 1) vec->sorted = false;
+
+    size_t i = 0;
+    size_t j = vec->len - 1;
+    while (i < j) {
+       swap_double(&vec->data[i], &vec->data[j]);
+       i++;
+       j--;
+    }
+}
+// ================================================================================
+// ================================================================================ 
+// QUICKSORT
+
+void swap_double(double* a, double* b) {
+    if (!a || !b) {
+        errno = EINVAL;
+        return;
+    }
+    double temp = *a;
+    *a = *b;
+    *b = temp;
+}
+// -------------------------------------------------------------------------------- 
+
+static double _median_of_three(double a, double b, double c) {
+    if (a < b) {
+        if (b < c) return b;
+        return a < c ? c : a;
+    }
+    if (a < c) return a;
+    return b < c ? c : b;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts n values without NaN in ascending order
+ *
+ * Ranges are partitioned with the vectorized kernel from the dispatch table
+ * and ranges of SORT_NETWORK_SIZE or fewer values are finished with the small
+ * sort kernel, a bitonic sorting network on SIMD builds.  When no value is below the pivot, the values equal to it are split
+ * off with an inclusive partition, so runs of duplicates cannot stall the sort.
+ */
+static void _quicksort_double(double* x, size_t n) {
+    while (n > SORT_NETWORK_SIZE) {
+        double pivot = _median_of_three(x[0], x[n / 2], x[n - 1]);
+        size_t split = _kern->partition(x, n, pivot, false);
+        if (split == 0) {
+            // Everything is >= pivot; the values equal to it are now final
+            size_t equal = _kern->partition(x, n, pivot, true);
+            x += equal;
+            n -= equal;
+            continue;
+        }
+
+        // Recurse into the smaller side so the stack depth stays O(log n)
+        if (split < n - split) {
+            _quicksort_double(x, split);
+            x += split;
+            n -= split;
+        } else {
+            _quicksort_double(x + split, n - split);
+            n = split;
+        }
+    }
+    if (n > 1)
+        _kern->sort_small(x, n);
+}
+// --------------------------------------------------------------------------------
+
+static void _reverse_doubles(double* x, size_t n) {
+    for (size_t i = 0, j = n; i + 1 < j; ++i, --j) {
+        double tmp = x[i];
+        x[i] = x[j - 1];
+        x[j - 1] = tmp;
+    }
+}
+// ================================================================================ 
+// ================================================================================ 
+// RADIX SORT
+//
+// Doubles are mapped to unsigned keys whose integer order is the numeric order:
+// negative values have every bit inverted and positive values have the sign bit
+// set.  The keys are then sorted with a stable least significant digit radix 
+// sort using RADIX_BITS wide digits.  Descending order sorts the complemented 
+// keys, so both directions take the same number of passes.
+
+#define RADIX_BITS 11
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+#define RADIX_PASSES ((64 + RADIX_BITS - 1) / RADIX_BITS)
+
+static inline uint64_t _double_to_key(double value, iter_dir direction) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t key = (bits & 0x8000000000000000ULL) ? ~bits : bits | 0x8000000000000000ULL;
+    return direction == REVERSE ? ~key : key;
+}
+// --------------------------------------------------------------------------------
+
+static inline double _key_to_double(uint64_t key, iter_dir direction) {
+    if (direction == REVERSE) key = ~key;
+    uint64_t bits = (key & 0x8000000000000000ULL) ? key & ~0x8000000000000000ULL : ~key;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+// Keys are kept in the double buffers themselves; memcpy reinterprets the bits
+// without breaking strict aliasing and compiles to a plain move
+static inline uint64_t _load_key(const double* p) {
+    uint64_t key;
+    memcpy(&key, p, sizeof(key));
+    return key;
+}
+// --------------------------------------------------------------------------------
+
+static inline void _store_key(double* p, uint64_t key) {
+    memcpy(p, &key, sizeof(key));
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Encodes n doubles into keys in place and builds every digit histogram
+ */
+static void _encode_keys(double* data, size_t n, iter_dir direction, 
+                         size_t (*hist)[RADIX_BUCKETS]) {
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t key = _double_to_key(data[i], direction);
+        _store_key(&data[i], key);
+        for (size_t p = 0; p < RADIX_PASSES; ++p)
+            hist[p][(key >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Runs the LSD passes over n encoded keys
+ *
+ * Keys move between src and dst.  Passes in which every key has the same digit
+ * are skipped, which removes most passes for data with a narrow exponent range.
+ *
+ * @return The buffer, src or dst, that holds the sorted keys
+ */
+static double* _radix_sort_keys(double* src, double* dst, size_t n, 
+                                size_t (*hist)[RADIX_BUCKETS]) {
+    for (size_t p = 0; p < RADIX_PASSES; ++p) {
+        size_t shift = p * RADIX_BITS;
+        if (hist[p][(_load_key(&src[0]) >> shift) & (RADIX_BUCKETS - 1)] == n)
+            continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; ++b) {
+            size_t count = hist[p][b];
+            hist[p][b] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t key = _load_key(&src[i]);
+            _store_key(&dst[hist[p][(key >> shift) & (RADIX_BUCKETS - 1)]++], key);
+        }
+        double* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    return src;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts n doubles that contain no NaN with an LSD radix sort
+ *
+ * The keys are encoded in place and moved between data and a single scratch
+ * buffer.
+ *
+ * @return false if the scratch memory could not be allocated, in which case 
+ *         the data is unchanged
+ */
+static bool _radix_sort_double(double* data, size_t n, iter_dir direction) {
+    double* scratch = _aligned_alloc_double(n);
+    size_t (*hist)[RADIX_BUCKETS] = calloc(RADIX_PASSES, sizeof(*hist));
+    if (!scratch || !hist) {
+        _aligned_free_double(scratch);
+        free(hist);
+        return false;
+    }
+
+    _encode_keys(data, n, direction, hist);
+    double* sorted = _radix_sort_keys(data, scratch, n, hist);
+
+    // Decoding doubles as the copy back when the last pass ended in scratch
+    for (size_t i = 0; i < n; ++i)
+        data[i] = _key_to_double(_load_key(&sorted[i]), direction);
+
+    free(hist);
+    _aligned_free_double(scratch);
+    return true;
+}
+// ================================================================================ 
+// ================================================================================ 
+// PARALLEL SORT
+//
+// Large vectors are cut into one run per thread.  Each run is radix sorted on 
+// its own thread and left as encoded keys, then the runs are merged pairwise
+// on the keys.  Every merge is split into segments of about equal output size
+// with a merge path search, so each round keeps all threads busy even when
+// only two runs remain.  A final parallel pass decodes the keys.
+
+typedef struct {
+    double* data;
+    double* scratch;
+    size_t n;
+    size_t n_runs;
+    iter_dir direction;
+    size_t (*hist)[RADIX_PASSES][RADIX_BUCKETS];
+} dv_sort_ctx;
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief One merge segment: a[0..na) and b[0..nb) merged into out
+ */
+typedef struct {
+    const double* a;
+    size_t na;
+    const double* b;
+    size_t nb;
+    double* out;
+} dv_merge_task;
+// --------------------------------------------------------------------------------
+
+static inline size_t _run_start(size_t run, size_t n, size_t n_runs) {
+    return (size_t)(((unsigned long long)n * run) / n_runs);
+}
+// --------------------------------------------------------------------------------
+
+static void _sort_run_task(void* arg, size_t run) {
+    dv_sort_ctx* ctx = arg;
+    size_t start = _run_start(run, ctx->n, ctx->n_runs);
+    size_t len = _run_start(run + 1, ctx->n, ctx->n_runs) - start;
+    double* data = ctx->data + start;
+    _encode_keys(data, len, ctx->direction, ctx->hist[run]);
+    double* sorted = _radix_sort_keys(data, ctx->scratch + start, len, ctx->hist[run]);
+    if (sorted != data)
+        memcpy(data, sorted, len * sizeof(double));
+}
+// --------------------------------------------------------------------------------
+
+static void _merge_task(void* arg, size_t task) {
+    dv_merge_task* t = (dv_merge_task*)arg + task;
+    size_t i = 0, j = 0, k = 0;
+    while (i < t->na && j < t->nb) {
+        uint64_t ka = _load_key(&t->a[i]);
+        uint64_t kb = _load_key(&t->b[j]);
+        // Ties take from a first, which keeps the merge stable
+        if (kb < ka) {
+            _store_key(&t->out[k++], kb);
+            j++;
+        } else {
+            _store_key(&t->out[k++], ka);
+            i++;
+        }
+    }
+    if (i < t->na)
+        memcpy(&t->out[k], &t->a[i], (t->na - i) * sizeof(double));
+    if (j < t->nb)
+        memcpy(&t->out[k], &t->b[j], (t->nb - j) * sizeof(double));
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns how many elements of a precede output position d when a and b
+ *        are merged with ties taken from a
+ */
+static size_t _merge_path(const double* a, size_t na, const double* b, size_t nb, size_t d) {
+    size_t lo = d > nb ? d - nb : 0;
+    size_t hi = d < na ? d : na;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (_load_key(&a[mid]) <= _load_key(&b[d - mid - 1]))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+// --------------------------------------------------------------------------------
+
+static void _decode_task(void* arg, size_t task) {
+    dv_sort_ctx* ctx = arg;
+    size_t start = _run_start(task, ctx->n, ctx->n_runs);
+    size_t end = _run_start(task + 1, ctx->n, ctx->n_runs);
+    for (size_t i = start; i < end; ++i)
+        ctx->data[i] = _key_to_double(_load_key(&ctx->scratch[i]), ctx->direction);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts n doubles that contain no NaN on the thread pool
+ *
+ * @return false if memory could not be allocated, in which case the data is
+ *         unchanged
+ */
+static bool _parallel_sort_double(double* data, size_t n, size_t threads, 
+                                  iter_dir direction) {
+    size_t n_runs = threads;
+    size_t* bounds = malloc((n_runs + 1) * sizeof(size_t));
+    // Each round has at most n_runs / 2 merges of at most threads segments
+    dv_merge_task* tasks = malloc((n_runs + 1) * (threads + 1) * sizeof(dv_merge_task));
+    double* scratch = _aligned_alloc_double(n);
+    size_t (*hist)[RADIX_PASSES][RADIX_BUCKETS] = calloc(n_runs, sizeof(*hist));
+    if (!bounds || !tasks || !scratch || !hist) {
+        free(bounds);
+        free(tasks);
+        _aligned_free_double(scratch);
+        free(hist);
+        return false;
+    }
+
+    dv_sort_ctx ctx = {data, scratch, n, n_runs, direction, hist};
+    _parallel_for(_sort_run_task, &ctx, n_runs);
+
+    for (size_t r = 0; r <= n_runs; ++r)
+        bounds[r] = _run_start(r, n, n_runs);
+
+    size_t segment = (n + threads - 1) / threads;
+    double* src = data;
+    double* dst = scratch;
+    size_t runs = n_runs;
+    while (runs > 1) {
+        size_t n_tasks = 0;
+        for (size_t r = 0; r < runs; r += 2) {
+            size_t a0 = bounds[r], a1 = bounds[r + 1];
+            size_t b1 = r + 2 <= runs ? bounds[r + 2] : a1;
+            const double* a = src + a0;
+            const double* b = src + a1;
+            size_t na = a1 - a0, nb = b1 - a1, total = na + nb;
+            for (size_t d0 = 0; d0 < total; d0 += segment) {
+                size_t d1 = d0 + segment < total ? d0 + segment : total;
+                size_t i0 = _merge_path(a, na, b, nb, d0);
+                size_t i1 = _merge_path(a, na, b, nb, d1);
+                tasks[n_tasks++] = (dv_merge_task){
+                    a + i0, i1 - i0, b + (d0 - i0), (d1 - i1) - (d0 - i0), dst + a0 + d0
+                };
+            }
+        }
+        _parallel_for(_merge_task, tasks, n_tasks);
+
+        size_t merged = 0;
+        for (size_t r = 0; r < runs; r += 2)
+            bounds[merged++] = bounds[r];
+        bounds[merged] = n;
+        runs = merged;
+        double* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // Decode into data, copying through scratch if the keys ended in data
+    if (src == data)
+        memcpy(scratch, data, n * sizeof(double));
+    _parallel_for(_decode_task, &ctx, n_runs);
+
+    free(bounds);
+    free(tasks);
+    _aligned_free_double(scratch);
+    free(hist);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Moves every NaN to the end of the array
+ *
+ * @return The number of values that are not NaN
+ */
+static size_t _partition_nan(double* data, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!isnan(data[i])) {
+            if (i != count)
+                swap_double(&data[count], &data[i]);
+            count++;
+        }
+    }
+    return count;
+}
+// -------------------------------------------------------------------------------- 
+
+void sort_double_vector(double_v* vec, iter_dir direction) {
+    if (!vec) {
+        errno = EINVAL;
+        return;
+    }
+    if (vec->len < 2) {
+        vec->sorted = true;
+        return;
+    }
+
+    if (vec->sorted && direction == FORWARD) return;
+    int saved = errno;
+    if (_read_only(vec)) {
+        // Data that is already in order needs no writes to be sorted forward,
+        // so a read only mapping only fails if it really is out of order
+        if (direction == FORWARD && _is_ascending(vec->data, vec->len)) {
+            vec->sorted = true;
+            errno = saved;
+        }
+        return;
+    }
+
+    // Data that is already ascending only needs to be turned around
+    if (vec->sorted) {
+        size_t n = vec->len;
+        while (n > 0 && isnan(vec->data[n - 1])) n--;
+        _reverse_doubles(vec->data, n);
+        vec->sorted = n < 2;
+        return;
+    }
+
+    // NaN has no place in either order, so it is always placed last
+    size_t n = _partition_nan(vec->data, vec->len);
+    vec->sorted = direction == FORWARD || n < 2;
+    if (n < 2) return;
+
+    size_t threads = double_thread_count();
+    if (threads > n / RADIX_SORT_MIN) threads = n / RADIX_SORT_MIN;
+    if (n >= _parallel_threshold && threads > 1 && 
+        _parallel_sort_double(vec->data, n, threads, direction))
+        return;
+    if (n >= RADIX_SORT_MIN && _radix_sort_double(vec->data, n, direction))
+        return;
+
+    // The quicksort always sorts ascending, which keeps direction tests out 
+    // of the partition loop
+    _quicksort_double(vec->data, n);
+    if (direction == REVERSE)
+        _reverse_doubles(vec->data, n);
+}
+// -------------------------------------------------------------------------------- 
+
+bool is_sorted_double_vector(double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return false;
+    }
+    if (vec->sorted) return true;
+    // Remember a positive answer so later searches and sorts can use it
+    vec->sorted = _is_ascending(vec->data, vec->len);
+    return vec->sorted;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Stable LSD radix sort of keys carrying their original positions
+ *
+ * keys/index are sorted using key_tmp/index_tmp as scratch; the result is 
+ * always left in keys/index.
+ *
+ * @return false if the histogram memory could not be allocated
+ */
+static bool _radix_argsort(uint64_t* keys, size_t* index, uint64_t* key_tmp,
+                           size_t* index_tmp, size_t n) {
+    size_t (*hist)[RADIX_BUCKETS] = calloc(RADIX_PASSES, sizeof(*hist));
+    if (!hist) return false;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t p = 0; p < RADIX_PASSES; ++p)
+            hist[p][(keys[i] >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    uint64_t* src_key = keys;
+    size_t* src_index = index;
+    uint64_t* dst_key = key_tmp;
+    size_t* dst_index = index_tmp;
+    for (size_t p = 0; p < RADIX_PASSES; ++p) {
+        size_t shift = p * RADIX_BITS;
+        if (hist[p][(src_key[0] >> shift) & (RADIX_BUCKETS - 1)] == n)
+            continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; ++b) {
+            size_t count = hist[p][b];
+            hist[p][b] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            size_t pos = hist[p][(src_key[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            dst_key[pos] = src_key[i];
+            dst_index[pos] = src_index[i];
+        }
+        uint64_t* tk = src_key; src_key = dst_key; dst_key = tk;
+        size_t* ti = src_index; src_index = dst_index; dst_index = ti;
+    }
+    if (src_index != index)
+        memcpy(index, src_index, n * sizeof(size_t));
+    free(hist);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+size_t* argsort_double_vector(const double_v* vec, iter_dir direction) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t n = vec->len;
+    size_t* index = malloc(n * sizeof(size_t));
+    size_t* index_tmp = malloc(n * sizeof(size_t));
+    uint64_t* keys = malloc(n * sizeof(uint64_t));
+    uint64_t* key_tmp = malloc(n * sizeof(uint64_t));
+    if (!index || !index_tmp || !keys || !key_tmp) {
+        free(index);
+        free(index_tmp);
+        free(keys);
+        free(key_tmp);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    // NaN gets the largest key in both directions so it sorts last
+    for (size_t i = 0; i < n; ++i) {
+        double value = vec->data[i];
+        keys[i] = isnan(value) ? UINT64_MAX : _double_to_key(value, direction);
+        index[i] = i;
+    }
+
+    bool ok = _radix_argsort(keys, index, key_tmp, index_tmp, n);
+    free(index_tmp);
+    free(keys);
+    free(key_tmp);
+    if (!ok) {
+        free(index);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return index;
+}
+// -------------------------------------------------------------------------------- 
+
+bool permute_double_vector(double_v* vec, const size_t* perm) {
+    if (!vec || !vec->data || !perm) {
+        errno = EINVAL;
+        return false;
+    }
+    if (_read_only(vec)) return false;
+    size_t n = vec->len;
+    if (n < 2) return true;
+
+    // One bit per element, used first to validate perm and then to mark
+    // positions already placed while following cycles
+    size_t words = (n + 63) / 64;
+    uint64_t* seen = calloc(words, sizeof(uint64_t));
+    if (!seen) {
+        errno = ENOMEM;
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        size_t k = perm[i];
+        if (k >= n || (seen[k / 64] >> (k % 64)) & 1u) {
+            free(seen);
+            errno = EINVAL;
+            return false;
+        }
+        seen[k / 64] |= (uint64_t)1 << (k % 64);
+    }
+    memset(seen, 0, words * sizeof(uint64_t));
+    vec->sorted = false;
+
+    // data[i] = old data[perm[i]], applied in place one cycle at a time
+    for (size_t start = 0; start < n; ++start) {
+        if ((seen[start / 64] >> (start % 64)) & 1u) continue;
+        double first = vec->data[start];
+        size_t j = start;
+        for (;;) {
+            seen[j / 64] |= (uint64_t)1 << (j % 64);
+            size_t k = perm[j];
+            if (k == start) {
+                vec->data[j] = first;
+                break;
+            }
+            vec->data[j] = vec->data[k];
+            j = k;
+        }
+    }
+    free(seen);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+// ================================================================================ 
+// ================================================================================ 
+// SELECTION
+//
+// Order statistics are found with quickselect on the partition kernels used by
+// the quicksort.  Each round only continues into the side that holds the 
+// wanted rank, so the expected work is linear.  A work budget turns it into an
+// introselect: once the rounds have touched SELECT_WORK_FACTOR * n values the
+// remaining range is sorted, which bounds the worst case by the O(n) radix sort.
+
+#define SELECT_WORK_FACTOR 8
+
+/**
+ * @brief Sorts n values without NaN in ascending order with the fastest engine
+ */
+static void _sort_ascending(double* x, size_t n) {
+    if (n >= RADIX_SORT_MIN && _radix_sort_double(x, n, FORWARD))
+        return;
+    _quicksort_double(x, n);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Moves the k-th smallest of n values without NaN to x[k]
+ *
+ * On return every value in x[0, k) is <= x[k] and every value in x(k, n) is 
+ * >= x[k], as with std::nth_element.
+ */
+static void _select_double(double* x, size_t n, size_t k) {
+    size_t budget = n <= SIZE_MAX / SELECT_WORK_FACTOR ? SELECT_WORK_FACTOR * n : SIZE_MAX;
+    while (n > SORT_NETWORK_SIZE) {
+        if (n > budget) {
+            _sort_ascending(x, n);
+            return;
+        }
+        budget -= n;
+
+        double pivot = _median_of_three(x[0], x[n / 2], x[n - 1]);
+        size_t split = _kern->partition(x, n, pivot, false);
+        if (k < split) {
+            n = split;
+            continue;
+        }
+        if (split == 0) {
+            // Everything is >= pivot; split off the values equal to it
+            size_t equal = _kern->partition(x, n, pivot, true);
+            if (k < equal) return;
+            split = equal;
+        }
+        x += split;
+        n -= split;
+        k -= split;
+    }
+    if (n > 1)
+        _kern->sort_small(x, n);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Returns the values of vec without NaN, ready to be reordered
+ *
+ * In place mode moves NaN to the end of vec->data and returns vec->data.
+ * Otherwise the values that are not NaN are copied to a new aligned buffer, 
+ * which the caller releases with _aligned_free_double.  A sorted vector is
+ * returned as it is, since every rank is already in place; callers skip the 
+ * selection when vec->sorted is set.
+ *
+ * @param count Receives the number of values that are not NaN
+ * @return The buffer, or NULL with errno set to ENOMEM, or to EPERM if 
+ *         in_place is set and the elements cannot be written
+ */
+static double* _select_buffer(double_v* vec, bool in_place, size_t* count) {
+    if (vec->sorted) {
+        size_t m = vec->len;
+        while (m > 0 && isnan(vec->data[m - 1])) m--;
+        *count = m;
+        return vec->data;
+    }
+    if (in_place) {
+        if (_read_only(vec)) return NULL;
+        *count = _partition_nan(vec->data, vec->len);
+        return vec->data;
+    }
+    double* scratch = _aligned_alloc_double(vec->len);
+    if (!scratch) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    size_t m = 0;
+    for (size_t i = 0; i < vec->len; ++i) {
+        if (!isnan(vec->data[i]))
+            scratch[m++] = vec->data[i];
+    }
+    *count = m;
+    return scratch;
+}
+// -------------------------------------------------------------------------------- 
+
+static void _release_select_buffer(double_v* vec, double* x) {
+    if (x != vec->data)
+        _aligned_free_double(x);
+}
+// -------------------------------------------------------------------------------- 
+
+double nth_double_vector(double_v* vec, size_t k, bool in_place) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return DBL_MAX;
+    }
+    if (k >= vec->len) {
+        errno = ERANGE;
+        return DBL_MAX;
+    }
+
+    size_t m;
+    double* x = _select_buffer(vec, in_place, &m);
+    if (!x) return DBL_MAX;
+
+    // NaN sorts last, so ranks past the numeric values land on a NaN
+    double result = NAN;
+    if (k < m) {
+        if (!vec->sorted) _select_double(x, m, k);
+        result = x[k];
+    }
+    _release_select_buffer(vec, x);
+    return result;
+}
+// -------------------------------------------------------------------------------- 
+
+double median_double_vector(double_v* vec, bool in_place) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return DBL_MAX;
+    }
+
+    size_t m;
+    double* x = _select_buffer(vec, in_place, &m);
+    if (!x) return DBL_MAX;
+
+    double result = NAN;
+    if (m > 0) {
+        size_t mid = m / 2;
+        if (!vec->sorted) _select_double(x, m, mid);
+        result = x[mid];
+        if (m % 2 == 0) {
+            // The lower middle value is the largest of the lower half
+            double lower = vec->sorted ? x[mid - 1] : _kern->max(x, mid);
+            result = lower == result ? result : lower + (result - lower) / 2.0;
+        }
+    }
+    _release_select_buffer(vec, x);
+    return result;
+}
+// -------------------------------------------------------------------------------- 
+
+static int _compare_size(const void* a, const void* b) {
+    size_t x = *(const size_t*)a;
+    size_t y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+// -------------------------------------------------------------------------------- 
+
+bool percentiles_double_vector(double_v* vec, const double* qs, size_t nq, 
+                               double* out, bool in_place) {
+    if (!vec || !vec->data || (nq > 0 && (!qs || !out))) {
+        errno = EINVAL;
+        return false;
+    }
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return false;
+    }
+    for (size_t i = 0; i < nq; ++i) {
+        if (!(qs[i] >= 0.0 && qs[i] <= 100.0)) {
+            errno = EINVAL;
+            return false;
+        }
+    }
+    if (nq == 0) return true;
+
+    size_t* ranks = malloc(2 * nq * sizeof(size_t));
+    if (!ranks) {
+        errno = ENOMEM;
+        return false;
+    }
+    size_t m;
+    double* x = _select_buffer(vec, in_place, &m);
+    if (!x) {
+        free(ranks);
+        return false;
+    }
+    if (m == 0) {
+        for (size_t i = 0; i < nq; ++i) out[i] = NAN;
+        _release_select_buffer(vec, x);
+        free(ranks);
+        return true;
+    }
+
+    // Every percentile reads the two ranks around q / 100 * (m - 1)
+    for (size_t i = 0; i < nq; ++i) {
+        size_t lo = (size_t)floor(qs[i] / 100.0 * (double)(m - 1));
+        if (lo > m - 1) lo = m - 1;
+        ranks[2 * i] = lo;
+        ranks[2 * i + 1] = lo + 1 < m ? lo + 1 : lo;
+    }
+
+    // Selecting the ranks in ascending order lets each search start just past
+    // the previous rank, since everything beyond it is already >= x[rank]
+    qsort(ranks, 2 * nq, sizeof(size_t), _compare_size);
+    size_t base = 0;
+    for (size_t i = 0; i < 2 * nq && !vec->sorted; ++i) {
+        if (i > 0 && ranks[i] == ranks[i - 1]) continue;
+        _select_double(x + base, m - base, ranks[i] - base);
+        base = ranks[i] + 1;
+    }
+
+    for (size_t i = 0; i < nq; ++i) {
+        double pos = qs[i] / 100.0 * (double)(m - 1);
+        size_t lo = (size_t)floor(pos);
+        if (lo > m - 1) lo = m - 1;
+        double frac = pos - (double)lo;
+        double a = x[lo];
+        if (frac <= 0.0 || lo + 1 >= m || x[lo + 1] == a) {
+            out[i] = a;
+        } else {
+            out[i] = a + frac * (x[lo + 1] - a);
+        }
+    }
+    _release_select_buffer(vec, x);
+    free(ranks);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+double_v* topk_double_vector(double_v* vec, size_t k, iter_dir direction, bool in_place) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return NULL;
+    }
+    if (k == 0 || k > vec->len) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    size_t m;
+    double* x = _select_buffer(vec, in_place, &m);
+    if (!x) return NULL;
+    if (k > m) k = m;
+
+    // The k smallest values end up in front of rank k - 1 and the k largest
+    // values behind rank m - k
+    double* first = x;
+    if (k > 0 && k < m) {
+        size_t rank = direction == FORWARD ? k - 1 : m - k;
+        if (!vec->sorted) _select_double(x, m, rank);
+        if (direction != FORWARD) first = x + rank;
+    }
+
+    double_v* result = init_double_vector(k > 0 ? k : 1);
+    if (!result) {
+        _release_select_buffer(vec, x);
+        return NULL;
+    }
+    if (k > 0) {
+        memcpy(result->data, first, k * sizeof(double));
+        result->len = k;
+        result->sorted = vec->sorted;
+        sort_double_vector(result, direction);
+    }
+    _release_select_buffer(vec, x);
+    return result;
+}
+// ================================================================================ 
+// ================================================================================ 
+
+void trim_double_vector(double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return;
+    }
+    
+    if (vec->alloc_type != DYNAMIC || (vec->len == vec->alloc && vec->head == 0)) {
+        return;
+    }
+   
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return;
+    }
+
+    _realloc_double_vector(vec, vec->len);
+}
+// --------------------------------------------------------------------------------
+
+bool reserve_double_vector(double_v* vec, size_t capacity) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return false;
+    }
+    if (capacity <= vec->alloc) return true;
+    if (vec->alloc_type != DYNAMIC) {
+        errno = EINVAL;
+        return false;
+    }
+    return _realloc_double_vector(vec, capacity);
+}
+// --------------------------------------------------------------------------------
+
+bool resize_double_vector(double_v* vec, size_t new_len) {
+    if (!vec || !vec->data || vec->alloc_type == MAPPED || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return false;
+    }
+    if (new_len > vec->len) {
+        if (!_grow_double_vector(vec, new_len)) return false;
+        memset(vec->data + vec->len, 0, (new_len - vec->len) * sizeof(double));
+        vec->sorted = false;
+    }
+    vec->len = new_len;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool set_double_vector_growth(double_v* vec, growth_t policy, double param) {
+    if (!vec || !vec->data || vec->alloc_type != DYNAMIC) {
+        errno = EINVAL;
+        return false;
+    }
+    switch (policy) {
+        case GROWTH_DEFAULT:
+            break;
+        case GROWTH_GEOMETRIC:
+        case GROWTH_MREMAP:
+            if (!(param > 1.0) || isinf(param)) {
+                errno = EINVAL;
+                return false;
+            }
+            vec->growth_factor = param;
+            break;
+        case GROWTH_FIXED:
+            if (!(param >= 1.0) || param >= (double)(SIZE_MAX / sizeof(double))) {
+                errno = EINVAL;
+                return false;
+            }
+            vec->growth_step = (size_t)param;
+            break;
+        default:
+            errno = EINVAL;
+            return false;
+    }
+    vec->growth = policy;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool set_double_vector_deque(double_v* vec, bool enable) {
+    if (!vec || !vec->data || vec->alloc_type == VIEW) {
+        errno = EINVAL;
+        return false;
+    }
+    if (_read_only(vec)) return false;
+    if (!enable) _deque_compact(vec);
+    vec->deque = enable;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+double* linearize_double_vector(double_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    _deque_compact(vec);
+    return vec->data;
+}
+// --------------------------------------------------------------------------------
+
+double_v* open_mapped_double_vector(const char* path, map_mode_t mode) {
+#if defined(DV_HAS_MMAP)
+    if (!path || mode < MAPPED_READ_ONLY || mode > MAPPED_READ_WRITE) {
+        errno = EINVAL;
+        return NULL;
+    }
+    int fd = open(path, mode == MAPPED_READ_WRITE ? O_RDWR : O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    if (st.st_size == 0 || st.st_size % (off_t)sizeof(double) != 0 ||
+        (uintmax_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        errno = st.st_size == 0 ? ENODATA : EINVAL;
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+
+    double_v* vec = calloc(1, sizeof(double_v));
+    if (!vec) {
+        close(fd);
+        errno = ENOMEM;
+        return NULL;
+    }
+    int prot = mode == MAPPED_READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = mode == MAPPED_COPY_ON_WRITE ? MAP_PRIVATE : MAP_SHARED;
+    void* ptr = mmap(NULL, bytes, prot, flags, fd, 0);
+    int err = errno;
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        free(vec);
+        errno = err;
+        return NULL;
+    }
+
+    vec->data = ptr;
+    vec->len = bytes / sizeof(double);
+    vec->alloc = vec->len;
+    vec->alloc_type = MAPPED;
+    vec->growth = GROWTH_DEFAULT;
+    vec->sum_mode = SUM_NAIVE;
+    vec->map_mode = mode;
+    return vec;
+#else
+    (void) path;
+    (void) mode;
+    errno = ENOSYS;
+    return NULL;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool sync_mapped_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->alloc_type != MAPPED) {
+        errno = EINVAL;
+        return false;
+    }
+#if defined(DV_HAS_MMAP)
+    if (vec->map_mode != MAPPED_READ_WRITE) return true;
+    return msync(vec->data - vec->head, (vec->head + vec->alloc) * sizeof(double), 
+                 MS_SYNC) == 0;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool advise_mapped_double_vector(double_v* vec, map_advice_t advice) {
+    if (!vec || !vec->data || vec->alloc_type != MAPPED) {
+        errno = EINVAL;
+        return false;
+    }
+#if defined(DV_HAS_MMAP)
+    if (advice < ADVICE_NORMAL || advice > ADVICE_DONTNEED) {
+        errno = EINVAL;
+        return false;
+    }
+    // Dropping private pages would silently undo the writes to them
+    if (advice == ADVICE_DONTNEED && vec->map_mode == MAPPED_COPY_ON_WRITE) {
+        errno = EINVAL;
+        return false;
+    }
+#if defined(DV_HAS_MADVISE)
+    int flag = MADV_NORMAL;
+    switch (advice) {
+        case ADVICE_NORMAL: flag = MADV_NORMAL; break;
+        case ADVICE_SEQUENTIAL: flag = MADV_SEQUENTIAL; break;
+        case ADVICE_RANDOM: flag = MADV_RANDOM; break;
+        case ADVICE_WILLNEED: flag = MADV_WILLNEED; break;
+        case ADVICE_DONTNEED: flag = MADV_DONTNEED; break;
+    }
+    return madvise(vec->data - vec->head, (vec->head + vec->alloc) * sizeof(double), 
+                   flag) == 0;
+#else
+    // The advice is only a hint, so it is dropped where madvise is not declared
+    return true;
+#endif
+#else
+    (void) advice;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool close_mapped_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->alloc_type != MAPPED) {
+        errno = EINVAL;
+        return false;
+    }
+#if defined(DV_HAS_MMAP)
+    bool ok = munmap(vec->data - vec->head, (vec->head + vec->alloc) * sizeof(double)) == 0;
+    free(vec);
+    return ok;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sorts vec ahead of a search when sort_first asks for it
+ *
+ * @return false with errno set to EPERM if vec needs sorting but its elements
+ *         cannot be written
+ */
+static bool _sort_for_search(double_v* vec, bool sort_first) {
+    if (!sort_first || vec->sorted || vec->len < 2) return true;
+    sort_double_vector(vec, FORWARD);
+    return vec->sorted;
+}
+// -------------------------------------------------------------------------------- 
+
+size_t binary_search_double_vector(double_v* vec, double value, double tolerance, bool sort_first) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return LONG_MAX;
+    }
+
+    if (tolerance < 0) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+
+    if (isnan(value) || isnan(tolerance)) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    
+    // Sort if requested, unless the vector is known to be in order already
+    if (!_sort_for_search(vec, sort_first)) return LONG_MAX;
+    
+    size_t left = 0;
+    size_t right = vec->len - 1;
+    
+    while (left <= right) {
+        size_t mid = left + (right - left) / 2;
+        double diff = vec->data[mid] - value;
+        
+        // Check if we found a match within tolerance
+        if (fabs(diff) <= tolerance) {
+            return mid;
+        }
+        
+        if (diff < 0) {
+            left = mid + 1;
+        } else {
+            // Handle case where mid is 0 to prevent underflow
+            if (mid == 0) {
+                break;
+            }
+            right = mid - 1;
+        }
+    }
+    // The value does not exist in the array 
+    return LONG_MAX;
+}
+// -------------------------------------------------------------------------------- 
+// Bound searches treat the data as ascending with NaN last.  The lower bound 
+// of a value is the number of values ordered before it and the upper bound the
+// number of values not ordered after it, so a NaN query has its lower bound at
+// the first NaN and its upper bound at len.
+
+#define SEARCH_BATCH 8  // Queries searched in lockstep so their cache misses overlap
+
+/**
+ * @brief Returns the position of the first NaN in data that is ascending with NaN last
+ */
+static size_t _count_before_nan(const double* x, size_t n) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (isnan(x[mid])) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Branchless lower or upper bound of a value that is not NaN
+ *
+ * Each step halves n and moves base with a conditional move rather than a 
+ * branch, so the loop always runs log2(n) times and never mispredicts.  NaN
+ * probes compare false and therefore act as values above every query.
+ */
+static inline size_t _bound_search(const double* x, size_t n, double value, bool upper) {
+    if (n == 0) return 0;
+    const double* base = x;
+    while (n > 1) {
+        size_t half = n / 2;
+        double probe = base[half];
+        base = (upper ? probe <= value : probe < value) ? base + half : base;
+        n -= half;
+    }
+    return (size_t)(base - x) + (upper ? *base <= value : *base < value);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Bound searches for nq queries, SEARCH_BATCH of them in lockstep
+ *
+ * The queries of a batch share the loop counter, so each step issues 
+ * SEARCH_BATCH independent loads and the memory latency is paid once per 
+ * step rather than once per query.
+ */
+static void _bound_batch(const double* x, size_t n, const double* q, size_t nq,
+                         size_t* out, bool upper) {
+    if (n == 0) {
+        memset(out, 0, nq * sizeof(size_t));
+        return;
+    }
+    size_t nan_bound = upper ? n : _count_before_nan(x, n);
+    size_t i = 0;
+    for (; i + SEARCH_BATCH <= nq; i += SEARCH_BATCH) {
+        const double* base[SEARCH_BATCH];
+        for (size_t j = 0; j < SEARCH_BATCH; ++j) base[j] = x;
+        for (size_t len = n; len > 1; ) {
+            size_t half = len / 2;
+            for (size_t j = 0; j < SEARCH_BATCH; ++j) {
+                double probe = base[j][half];
+                base[j] = (upper ? probe <= q[i + j] : probe < q[i + j]) ? base[j] + half : base[j];
+            }
+            len -= half;
+        }
+        for (size_t j = 0; j < SEARCH_BATCH; ++j) {
+            double v = q[i + j];
+            size_t pos = (size_t)(base[j] - x) + (upper ? *base[j] <= v : *base[j] < v);
+            out[i + j] = isnan(v) ? nan_bound : pos;
+        }
+    }
+    for (; i < nq; ++i)
+        out[i] = isnan(q[i]) ? nan_bound : _bound_search(x, n, q[i], upper);
+}
+// -------------------------------------------------------------------------------- 
+
+size_t lower_bound_double_vector(double_v* vec, double value, bool sort_first) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (!_sort_for_search(vec, sort_first)) return LONG_MAX;
+    if (isnan(value)) 
+        return _count_before_nan(vec->data, vec->len);
+    return _bound_search(vec->data, vec->len, value, false);
+}
+// -------------------------------------------------------------------------------- 
+
+size_t upper_bound_double_vector(double_v* vec, double value, bool sort_first) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (!_sort_for_search(vec, sort_first)) return LONG_MAX;
+    if (isnan(value)) 
+        return vec->len;
+    return _bound_search(vec->data, vec->len, value, true);
+}
+// -------------------------------------------------------------------------------- 
+
+bool equal_range_double_vector(double_v* vec, double value, size_t* first, 
+                               size_t* last, bool sort_first) {
+    if (!vec || !vec->data || !first || !last) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!_sort_for_search(vec, sort_first)) return false;
+    if (isnan(value)) {
+        *first = _count_before_nan(vec->data, vec->len);
+        *last = vec->len;
+        return true;
+    }
+    *first = _bound_search(vec->data, vec->len, value, false);
+    *last = *first + _bound_search(vec->data + *first, vec->len - *first, value, true);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool lower_bound_batch_double_vector(double_v* vec, const double_v* queries, 
+                                     size_t* out, bool sort_first) {
+    if (!vec || !vec->data || !queries || !queries->data || !out) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!_sort_for_search(vec, sort_first)) return false;
+    _bound_batch(vec->data, vec->len, queries->data, queries->len, out, false);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool upper_bound_batch_double_vector(double_v* vec, const double_v* queries, 
+                                     size_t* out, bool sort_first) {
+    if (!vec || !vec->data || !queries || !queries->data || !out) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!_sort_for_search(vec, sort_first)) return false;
+    _bound_batch(vec->data, vec->len, queries->data, queries->len, out, true);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+void update_double_vector(double_v* vec, size_t index, double replacement_value) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return;
+    }
+    if (index > vec->len -1) {
+        errno = ERANGE;
+        return;
+    }
+    if (_read_only(vec)) return;
+    vec->sorted = vec->sorted && 
+                  (index == 0 || _in_order(vec->data[index - 1], replacement_value)) &&
+                  (index == vec->len - 1 || _in_order(replacement_value, vec->data[index + 1]));
+    vec->data[index] = replacement_value;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief The reductions that can be split across the thread pool
+ */
+typedef enum {
+    REDUCE_MIN,
+    REDUCE_MAX,
+    REDUCE_SUM,
+    REDUCE_SQ_DEV,
+    REDUCE_DOT,
+    REDUCE_ABS_SUM,
+    REDUCE_ABS_MAX
+} dv_reduce_op;
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    const double* data;
+    const double* other;  // Second operand of REDUCE_DOT
+    size_t len;
+    dv_reduce_op op;
+    sum_mode_t mode;
+    double mean;
+    double* partial;
+} dv_reduce_ctx;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Applies one reduction kernel to a contiguous range
+ */
+static double _reduce_range(const double* x, const double* y, size_t n, dv_reduce_op op, 
+                            sum_mode_t mode, double mean) {
+    switch (op) {
+        case REDUCE_MIN: return _kern->min(x, n);
+        case REDUCE_MAX: return _kern->max(x, n);
+        case REDUCE_SUM: 
+            return mode == SUM_COMPENSATED ? _kern->sum_comp(x, n) : _kern->sum(x, n);
+        case REDUCE_DOT: return _kern->dot(x, y, n);
+        case REDUCE_ABS_SUM: return _kern->abs_sum(x, n);
+        case REDUCE_ABS_MAX: return _kern->abs_max(x, n);
+        default: return _kern->sq_dev(x, n, mean);
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+static void _reduce_task(void* arg, size_t task) {
+    dv_reduce_ctx* ctx = arg;
+    size_t start = task * PARALLEL_CHUNK_SIZE;
+    size_t n = ctx->len - start < PARALLEL_CHUNK_SIZE ? ctx->len - start : PARALLEL_CHUNK_SIZE;
+    const double* other = ctx->other ? ctx->other + start : NULL;
+    ctx->partial[task] = _reduce_range(ctx->data + start, other, n, ctx->op, ctx->mode, ctx->mean);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Reduces len values, or pairs of values for REDUCE_DOT, on the thread
+ *        pool when there are enough of them
+ *
+ * Parallel partials are always combined in chunk order, with a compensated
+ * sum when the vector uses SUM_COMPENSATED.
+ */
+static double _reduce_data(const double* x, const double* y, size_t len, dv_reduce_op op,
+                           sum_mode_t mode, double mean) {
+    size_t n_chunks = (len + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    double* partial = NULL;
+    // Above the threshold the chunking is used even with one thread so the
+    // result does not depend on the thread count
+    if (len < _parallel_threshold || n_chunks < 2 || 
+        !(partial = malloc(n_chunks * sizeof(double))))
+        return _reduce_range(x, y, len, op, mode, mean);
+
+    dv_reduce_ctx ctx = {x, y, len, op, mode, mean, partial};
+    _parallel_for(_reduce_task, &ctx, n_chunks);
+
+    double result;
+    if (op == REDUCE_MIN || op == REDUCE_MAX || op == REDUCE_ABS_MAX) {
+        result = partial[0];
+        for (size_t i = 1; i < n_chunks; ++i) {
+            if (op == REDUCE_MIN ? partial[i] < result : partial[i] > result)
+                result = partial[i];
+            else if (op == REDUCE_ABS_MAX && isnan(partial[i]))
+                result = NAN;
+        }
+    } else if (op == REDUCE_SUM && mode == SUM_COMPENSATED) {
+        result = _sum_comp_scalar(partial, n_chunks);
+    } else {
+        result = 0.0;
+        for (size_t i = 0; i < n_chunks; ++i)
+            result += partial[i];
+    }
+    free(partial);
+    return result;
+}
+// -------------------------------------------------------------------------------- 
+
+static double _reduce(const double_v* vec, dv_reduce_op op, double mean) {
+    return _reduce_data(vec->data, NULL, vec->len, op, vec->sum_mode, mean);
+}
+// -------------------------------------------------------------------------------- 
+
+double min_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    return _reduce(vec, REDUCE_MIN, 0.0);
+}
+// -------------------------------------------------------------------------------- 
+
+double max_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return -DBL_MAX;
+    }
+    return _reduce(vec, REDUCE_MAX, 0.0);
+}
+// -------------------------------------------------------------------------------- 
+
+bool set_double_vector_sum_mode(double_v* vec, sum_mode_t mode) {
+    if (!vec || (mode != SUM_NAIVE && mode != SUM_COMPENSATED)) {
+        errno = EINVAL;
+        return false;
+    }
+    vec->sum_mode = mode;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+double sum_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    return _reduce(vec, REDUCE_SUM, 0.0);
+}
+// -------------------------------------------------------------------------------- 
+
+double average_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    return _reduce(vec, REDUCE_SUM, 0.0) / vec->len;
+}
+// -------------------------------------------------------------------------------- 
+
+double stdev_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->len < 2) {
+        errno = ENODATA;
+        return DBL_MAX;
+    }
+
+    double mean = _reduce(vec, REDUCE_SUM, 0.0) / vec->len;
+
+    // A finite mean means the data holds no Inf or NaN, so the kernel needs
+    // no per element checks.  Otherwise any infinity makes the result infinite.
+    if (!isfinite(mean)) {
+        bool has_nan = false;
+        for (size_t i = 0; i < vec->len; ++i) {
+            if (isinf(vec->data[i])) return INFINITY;
+            if (isnan(vec->data[i])) has_nan = true;
+        }
+        return has_nan ? NAN : INFINITY;
+    }
+
+    return sqrt(_reduce(vec, REDUCE_SQ_DEV, mean) / vec->len);
+}
+// -------------------------------------------------------------------------------- 
+
+double_stats_t describe_double_vector(const double_v* vec) {
+    double_stats_t stats = {0};
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return stats;
+    }
+
+    // Blocks are summarized while they sit in L1 and folded into the running
+    // totals with the pairwise update of Chan et al., so memory is read once
+    size_t count = 0, inf = 0;
+    double min_val = INFINITY, max_val = -INFINITY;
+    double sum = 0.0, mean = 0.0, m2 = 0.0;
+    for (size_t i = 0; i < vec->len; i += STATS_BLOCK_SIZE) {
+        size_t n = vec->len - i < STATS_BLOCK_SIZE ? vec->len - i : STATS_BLOCK_SIZE;
+        dv_block_stats block;
+        _kern->block_stats(vec->data + i, n, &block);
+        if (block.count == 0) continue;
+
+        double block_mean = block.sum / block.count;
+        size_t total = count + block.count;
+        double delta = block_mean - mean;
+        mean += delta * ((double)block.count / total);
+        m2 += block.m2 + delta * delta * ((double)count * block.count / total);
+        count = total;
+
+        sum += block.sum;
+        inf += block.inf;
+        if (block.min < min_val) min_val = block.min;
+        if (block.max > max_val) max_val = block.max;
+    }
+
+    stats.count = count;
+    stats.nan_count = vec->len - count;
+    stats.inf_count = inf;
+    if (count == 0) {
+        stats.min = stats.max = stats.sum = stats.mean = NAN;
+        stats.variance = stats.stdev = NAN;
+        return stats;
+    }
+
+    stats.min = min_val;
+    stats.max = max_val;
+    stats.sum = sum;
+    if (inf > 0) {
+        // The running mean is meaningless once an infinity is included
+        stats.mean = sum;
+        stats.variance = stats.stdev = INFINITY;
+        return stats;
+    }
+    stats.mean = mean;
+    stats.variance = m2 / count;
+    stats.stdev = sqrt(stats.variance);
+    return stats;
+}
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    const double* in;
+    double* out;
+    size_t len;
+    scan_op_t op;
+    double* carry;  // Chunk totals, then the value each chunk starts from
+} dv_scan_ctx;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Combines n values with op into one total, propagating NaN
+ */
+static double _scan_fold(const double* x, size_t n, scan_op_t op) {
+    if (op == SCAN_SUM) return _kern->sum(x, n);
+
+    // Four running values keep the dependency chains short
+    double id = _scan_identity(op);
+    double acc[4] = {id, id, id, id};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (size_t j = 0; j < 4; ++j)
+            acc[j] = _scan_combine(acc[j], x[i + j], op);
+    }
+    for (; i < n; ++i)
+        acc[0] = _scan_combine(acc[0], x[i], op);
+    return _scan_combine(_scan_combine(acc[0], acc[1], op), 
+                         _scan_combine(acc[2], acc[3], op), op);
+}
+// -------------------------------------------------------------------------------- 
+
+static void _scan_fold_task(void* arg, size_t task) {
+    dv_scan_ctx* ctx = arg;
+    size_t start = task * PARALLEL_CHUNK_SIZE;
+    size_t n = ctx->len - start < PARALLEL_CHUNK_SIZE ? ctx->len - start : PARALLEL_CHUNK_SIZE;
+    ctx->carry[task] = _scan_fold(ctx->in + start, n, ctx->op);
+}
+// -------------------------------------------------------------------------------- 
+
+static void _scan_task(void* arg, size_t task) {
+    dv_scan_ctx* ctx = arg;
+    size_t start = task * PARALLEL_CHUNK_SIZE;
+    size_t n = ctx->len - start < PARALLEL_CHUNK_SIZE ? ctx->len - start : PARALLEL_CHUNK_SIZE;
+    _kern->scan(ctx->in + start, ctx->out + start, n, ctx->op, ctx->carry[task]);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Inclusive scan of len values into out, which may equal in
+ *
+ * Large inputs are scanned in two parallel passes over fixed chunks: the 
+ * first folds every chunk to its total, a short serial scan of the totals 
+ * gives each chunk its starting carry, and the second pass scans every chunk
+ * from its carry.  As with the reductions, the chunking is used above the 
+ * threshold even with one thread, so results do not depend on the thread 
+ * count.  A compensated sum is a serial Neumaier scan.
+ */
+static void _scan(const double* in, double* out, size_t len, scan_op_t op, sum_mode_t mode) {
+    if (op == SCAN_SUM && mode == SUM_COMPENSATED) {
+        double sum = 0.0, comp = 0.0;
+        for (size_t i = 0; i < len; ++i) {
+            _neumaier_step(&sum, &comp, in[i]);
+            out[i] = sum + comp;
+        }
+        return;
+    }
+
+    size_t n_chunks = (len + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    double* carry = NULL;
+    if (len < _parallel_threshold || n_chunks < 2 || 
+        !(carry = malloc(n_chunks * sizeof(double)))) {
+        _kern->scan(in, out, len, op, _scan_identity(op));
+        return;
+    }
+
+    dv_scan_ctx ctx = {in, out, len, op, carry};
+    _parallel_for(_scan_fold_task, &ctx, n_chunks);
+    double run = _scan_identity(op);
+    for (size_t i = 0; i < n_chunks; ++i) {
+        double total = carry[i];
+        carry[i] = run;
+        run = _scan_combine(run, total, op);
+    }
+    _parallel_for(_scan_task, &ctx, n_chunks);
+    free(carry);
+}
+// -------------------------------------------------------------------------------- 
+
+double_v* cum_sum_double_vector(double_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    double_v* new_vec = init_double_vector(vec->len);
+    if (!new_vec) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    new_vec->sum_mode = vec->sum_mode;
+    _scan(vec->data, new_vec->data, vec->len, SCAN_SUM, vec->sum_mode);
+    new_vec->len = vec->len;
+
+    // NaN input is rejected, and once the running sum leaves the finite range
+    // the rest of the result is INFINITY
+    size_t i = 0;
+    while (i < vec->len && isfinite(new_vec->data[i])) i++;
+    if (i < vec->len) {
+        for (size_t j = i; j < vec->len; ++j) {
+            if (isnan(vec->data[j])) {
+                free_double_vector(new_vec);
+                errno = EINVAL;
+                return NULL;
+            }
+        }
+        for (; i < vec->len; ++i) new_vec->data[i] = INFINITY;
+    }
+    return new_vec;
+}
+// -------------------------------------------------------------------------------- 
+
+bool scan_double_vector(double_v* vec, scan_op_t op) {
+    if (!vec || !vec->data || op < SCAN_SUM || op > SCAN_MAX) {
+        errno = EINVAL;
+        return false;
+    }
+    if (_read_only(vec)) return false;
+    _scan(vec->data, vec->data, vec->len, op, vec->sum_mode);
+    // A running maximum never decreases and NaN, once reached, fills the rest
+    vec->sorted = op == SCAN_MAX || vec->len < 2;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool scan_into_double_vector(const double_v* vec, double* out, scan_op_t op) {
+    if (!vec || !vec->data || !out || op < SCAN_SUM || op > SCAN_MAX) {
+        errno = EINVAL;
+        return false;
+    }
+    _scan(vec->data, out, vec->len, op, vec->sum_mode);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief The element-wise operations that can be split across the thread pool
+ */
+typedef enum {
+    MAP_ARITH,
+    MAP_AFFINE,
+    MAP_AXPY
+} dv_map_kind;
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    dv_map_kind kind;
+    const double* a;
+    const double* b;
+    double* out;       // Result, also the y operand of MAP_AXPY
+    size_t len;
+    arith_op_t op;
+    double scale;      // Also alpha of MAP_AXPY
+    double offset;
+} dv_map_ctx;
+// -------------------------------------------------------------------------------- 
+
+static void _map_range(const dv_map_ctx* ctx, size_t start, size_t n) {
+    switch (ctx->kind) {
+        case MAP_ARITH: 
+            _kern->arith(ctx->a + start, ctx->b + start, ctx->out + start, n, ctx->op);
+            break;
+        case MAP_AFFINE: 
+            _kern->affine(ctx->a + start, ctx->out + start, n, ctx->scale, ctx->offset);
+            break;
+        default: 
+            _kern->axpy(ctx->scale, ctx->a + start, ctx->out + start, n);
+            break;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+static void _map_task(void* arg, size_t task) {
+    dv_map_ctx* ctx = arg;
+    size_t start = task * PARALLEL_CHUNK_SIZE;
+    size_t n = ctx->len - start < PARALLEL_CHUNK_SIZE ? ctx->len - start : PARALLEL_CHUNK_SIZE;
+    _map_range(ctx, start, n);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Applies an element-wise operation, on the thread pool when the 
+ *        vector is large enough
+ *
+ * Each element is computed on its own, so the result does not depend on the
+ * chunking.  The pool only pays off once the data no longer fits in cache and
+ * several cores can keep more memory requests in flight than one.
+ */
+static void _map(const dv_map_ctx* ctx) {
+    size_t n_chunks = (ctx->len + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    if (ctx->len < _parallel_threshold || n_chunks < 2) {
+        _map_range(ctx, 0, ctx->len);
+        return;
+    }
+    _parallel_for(_map_task, (void*)ctx, n_chunks);
+}
+// -------------------------------------------------------------------------------- 
+
+bool arith_double_vector(double_v* vec, const double_v* other, arith_op_t op) {
+    if (!vec || !vec->data || !other || !other->data || vec->len != other->len ||
+        op < ARITH_ADD || op > ARITH_DIV) {
+        errno = EINVAL;
+        return false;
+    }
+    if (_read_only(vec)) return false;
+    dv_map_ctx ctx = {MAP_ARITH, vec->data, other->data, vec->data, vec->len, op, 0.0, 0.0};
+    _map(&ctx);
+    vec->sorted = vec->len < 2;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool arith_into_double_vector(const double_v* a, const double_v* b, double* out, 
+                              arith_op_t op) {
+    if (!a || !a->data || !b || !b->data || !out || a->len != b->len ||
+        op < ARITH_ADD || op > ARITH_DIV) {
+        errno = EINVAL;
+        return false;
+    }
+    dv_map_ctx ctx = {MAP_ARITH, a->data, b->data, out, a->len, op, 0.0, 0.0};
+    _map(&ctx);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool affine_double_vector(double_v* vec, double scale, double offset) {
     if (!vec || !vec->data) {
+        errno = EINVAL;
+        return false;
+    }
+    if (_read_only(vec)) return false;
+    dv_map_ctx ctx = {MAP_AFFINE, vec->data, NULL, vec->data, vec->len, ARITH_ADD, 
+                      scale, offset};
+    _map(&ctx);
+    // Rounding is monotone, so a positive finite scale keeps the order, and 
+    // a finite offset cannot turn an infinity into NaN
+    vec->sorted = vec->len < 2 || (vec->sorted && scale > 0.0 && isfinite(scale) && 
+                                   isfinite(offset));
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool affine_into_double_vector(const double_v* vec, double* out, double scale, 
+                               double offset) {
+    if (!vec || !vec->data || !out) {
+        errno = EINVAL;
+        return false;
+    }
+    dv_map_ctx ctx = {MAP_AFFINE, vec->data, NULL, out, vec->len, ARITH_ADD, scale, offset};
+    _map(&ctx);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool axpy_double_vector(double_v* y, double alpha, const double_v* x) {
+    if (!y || !y->data || !x || !x->data || y->len != x->len) {
+        errno = EINVAL;
+        return false;
+    }
+    if (_read_only(y)) return false;
+    dv_map_ctx ctx = {MAP_AXPY, x->data, NULL, y->data, y->len, ARITH_ADD, alpha, 0.0};
+    _map(&ctx);
+    y->sorted = y->len < 2;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+double dot_double_vector(const double_v* a, const double_v* b) {
+    if (!a || !a->data || !b || !b->data || a->len == 0 || a->len != b->len) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    return _reduce_data(a->data, b->data, a->len, REDUCE_DOT, SUM_NAIVE, 0.0);
+}
+// -------------------------------------------------------------------------------- 
+
+double norm_double_vector(const double_v* vec, norm_t type) {
+    if (!vec || !vec->data || vec->len == 0 || type < NORM_L1 || type > NORM_INF) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    if (type == NORM_L1)
+        return _reduce_data(vec->data, NULL, vec->len, REDUCE_ABS_SUM, SUM_NAIVE, 0.0);
+    if (type == NORM_INF)
+        return _reduce_data(vec->data, NULL, vec->len, REDUCE_ABS_MAX, SUM_NAIVE, 0.0);
+
+    // The plain sum of squares is used unless it overflowed or is so small 
+    // that squares below DBL_MIN lost precision
+    double ss = _reduce_data(vec->data, vec->data, vec->len, REDUCE_DOT, SUM_NAIVE, 0.0);
+    if (ss >= DBL_MIN / DBL_EPSILON && ss <= DBL_MAX)
+        return sqrt(ss);
+
+    // Dividing by the largest magnitude brings every square into [0, 1].  A 
+    // NaN or Inf, or a vector of zeros, is its own norm.
+    double scale = _reduce_data(vec->data, NULL, vec->len, REDUCE_ABS_MAX, SUM_NAIVE, 0.0);
+    if (!isfinite(scale) || scale == 0.0)
+        return scale;
+    double sum = 0.0;
+    for (size_t i = 0; i < vec->len; ++i) {
+        double v = vec->data[i] / scale;
+        sum += v * v;
+    }
+    return scale * sqrt(sum);
+}
+// -------------------------------------------------------------------------------- 
+
+double_v* copy_double_vector(const double_v* original) {
+    if (!original || !original->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    double_v* copy = init_double_vector(original->alloc);
+    if (!copy) {
+        return NULL;
+    }
+    if (original->alloc_type == DYNAMIC) {
+        copy->growth = original->growth;
+        copy->growth_factor = original->growth_factor;
+        copy->growth_step = original->growth_step;
+    }
+    copy->sum_mode = original->sum_mode;
+
+    if (!extend_double_vector(copy, original->data, original->len)) {
+        free_double_vector(copy);
+        return NULL;
+    }
+    copy->sorted = original->sorted;
+    copy->deque = original->deque;
+
+    return copy;
+}
+// ================================================================================ 
+// ================================================================================ 
+// SEARCH INDEX
+//
+// The values of a sorted vector are stored in Eytzinger (breadth first) order:
+// tree[1] is the root and the children of tree[k] are tree[2k] and tree[2k+1].
+// The first levels of every search share a few cache lines, and the 8 nodes 
+// three levels below tree[k] sit together in tree[8k .. 8k+7], one aligned 
+// cache line that is prefetched while the three levels above it are compared.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DV_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define DV_PREFETCH(ptr) ((void)(ptr))
+#endif
+
+#define EYTZINGER_PREFETCH 8  // Doubles per cache line, prefetch three levels ahead
+
+struct search_index_d {
+    double* tree;   // Values in Eytzinger order, tree[0] is unused
+    size_t* rank;   // Position of tree[k] in the sorted vector, rank[0] = count
+    size_t count;   // Values in the tree, the leading values that are not NaN
+    size_t len;     // Length of the source vector including NaN
+};
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Places sorted values in Eytzinger order with an in-order traversal
+ *
+ * @return The index of the next sorted value to place
+ */
+static size_t _eytzinger_fill(search_index_d* index, const double* x, size_t i, size_t k) {
+    if (k <= index->count) {
+        i = _eytzinger_fill(index, x, i, 2 * k);
+        index->tree[k] = x[i];
+        index->rank[k] = i++;
+        i = _eytzinger_fill(index, x, i, 2 * k + 1);
+    }
+    return i;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Returns the number of trailing one bits of k
+ */
+static inline unsigned _trailing_ones(size_t k) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(~(unsigned long long)k);
+#else
+    unsigned ones = 0;
+    while (k & 1) {
+        k >>= 1;
+        ones++;
+    }
+    return ones;
+#endif
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Maps the node where an Eytzinger descent left the tree to a sorted position
+ *
+ * After the last right turn above the answer the descent only went left, so 
+ * dropping the trailing right turns and the left turn after them leaves the 
+ * node of the answer.  Node 0 means every value was below the query.
+ */
+static inline size_t _eytzinger_rank(const search_index_d* index, size_t k) {
+    return index->rank[k >> (_trailing_ones(k) + 1)];
+}
+// -------------------------------------------------------------------------------- 
+
+static inline size_t _eytzinger_bound(const search_index_d* index, double value, bool upper) {
+    const double* tree = index->tree;
+    size_t n = index->count;
+    size_t k = 1;
+    while (k <= n) {
+        size_t ahead = EYTZINGER_PREFETCH * k;
+        DV_PREFETCH(tree + (ahead <= n ? ahead : 0));
+        double node = tree[k];
+        k = 2 * k + (upper ? node <= value : node < value);
+    }
+    return _eytzinger_rank(index, k);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Eytzinger searches for nq queries, SEARCH_BATCH of them in lockstep
+ *
+ * Every level that is complete in the tree is descended by all queries of a
+ * batch together; only the last, partial level needs a bounds test.
+ */
+static void _eytzinger_batch(const search_index_d* index, const double* q, size_t nq,
+                             size_t* out, bool upper) {
+    const double* tree = index->tree;
+    size_t n = index->count;
+    size_t nan_bound = upper ? index->len : n;
+    size_t levels = 0;
+    while (((size_t)2 << levels) - 1 <= n) levels++;
+
+    size_t i = 0;
+    for (; i + SEARCH_BATCH <= nq; i += SEARCH_BATCH) {
+        size_t k[SEARCH_BATCH];
+        for (size_t j = 0; j < SEARCH_BATCH; ++j) k[j] = 1;
+        for (size_t level = 0; level < levels; ++level) {
+            for (size_t j = 0; j < SEARCH_BATCH; ++j) {
+                size_t ahead = EYTZINGER_PREFETCH * k[j];
+                DV_PREFETCH(tree + (ahead <= n ? ahead : 0));
+                double node = tree[k[j]];
+                k[j] = 2 * k[j] + (upper ? node <= q[i + j] : node < q[i + j]);
+            }
+        }
+        for (size_t j = 0; j < SEARCH_BATCH; ++j) {
+            if (k[j] <= n) {
+                double node = tree[k[j]];
+                k[j] = 2 * k[j] + (upper ? node <= q[i + j] : node < q[i + j]);
+            }
+            out[i + j] = isnan(q[i + j]) ? nan_bound : _eytzinger_rank(index, k[j]);
+        }
+    }
+    for (; i < nq; ++i)
+        out[i] = isnan(q[i]) ? nan_bound : _eytzinger_bound(index, q[i], upper);
+}
+// -------------------------------------------------------------------------------- 
+
+search_index_d* init_search_index(double_v* vec) {
+    if (!vec || !vec->data || !is_sorted_double_vector(vec)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t count = _count_before_nan(vec->data, vec->len);
+    if (count >= SIZE_MAX / 2 / sizeof(size_t)) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    search_index_d* index = malloc(sizeof(search_index_d));
+    if (!index) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    index->tree = _aligned_alloc_double(count + 1);
+    index->rank = malloc((count + 1) * sizeof(size_t));
+    if (!index->tree || !index->rank) {
+        _aligned_free_double(index->tree);
+        free(index->rank);
+        free(index);
+        errno = ENOMEM;
+        return NULL;
+    }
+    index->count = count;
+    index->len = vec->len;
+    index->tree[0] = 0.0;
+    index->rank[0] = count;
+    _eytzinger_fill(index, vec->data, 0, 1);
+    return index;
+}
+// -------------------------------------------------------------------------------- 
+
+void free_search_index(search_index_d* index) {
+    if (!index) {
+        errno = EINVAL;
+        return;
+    }
+    _aligned_free_double(index->tree);
+    free(index->rank);
+    free(index);
+}
+// -------------------------------------------------------------------------------- 
+
+void _free_search_index(search_index_d** index) {
+    if (index && *index) {
+        free_search_index(*index);
+        *index = NULL;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+size_t lower_bound_search_index(const search_index_d* index, double value) {
+    if (!index) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (isnan(value)) return index->count;
+    return _eytzinger_bound(index, value, false);
+}
+// -------------------------------------------------------------------------------- 
+
+size_t upper_bound_search_index(const search_index_d* index, double value) {
+    if (!index) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (isnan(value)) return index->len;
+    return _eytzinger_bound(index, value, true);
+}
+// -------------------------------------------------------------------------------- 
+
+bool lower_bound_batch_search_index(const search_index_d* index, const double_v* queries,
+                                    size_t* out) {
+    if (!index || !queries || !queries->data || !out) {
+        errno = EINVAL;
+        return false;
+    }
+    _eytzinger_batch(index, queries->data, queries->len, out, false);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool upper_bound_batch_search_index(const search_index_d* index, const double_v* queries,
+                                    size_t* out) {
+    if (!index || !queries || !queries->data || !out) {
+        errno = EINVAL;
+        return false;
+    }
+    _eytzinger_batch(index, queries->data, queries->len, out, true);
+    return true;
+}
+// ================================================================================ 
+// ================================================================================ 
+// EXPRESSIONS
+//
+// An expression is compiled on every evaluation into a short list of arith 
+// kernel calls.  Nodes only refer to earlier nodes, so the node array is
+// already in topological order.  Every computed node writes to a tile of 
+// scratch memory, and a tile is reused as soon as the last node that reads it
+// has run.  The tile length is chosen so that all live tiles fit in 
+// EXPR_SCRATCH_SIZE doubles, about the size of an L1 data cache, and the 
+// program then runs once per tile of the inputs.
+
+#define EXPR_SCRATCH_SIZE 4096  // Doubles of tile memory, 32 kB
+#define EXPR_MIN_TILE 8         // One cache line
+#define EXPR_MAX_TILE 1024      // Longer tiles no longer reduce the call overhead
+
+typedef enum {
+    EXPR_INPUT,
+    EXPR_CONST,
+    EXPR_ARITH
+} dv_expr_kind;
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    dv_expr_kind kind;
+    arith_op_t op;
+    size_t lhs;
+    size_t rhs;
+    const double_v* vec;  // EXPR_INPUT
+    double value;         // EXPR_CONST
+} dv_expr_node;
+// -------------------------------------------------------------------------------- 
+
+struct expr_d {
+    dv_expr_node* nodes;
+    size_t len;
+    size_t alloc;
+};
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Operand of a compiled step, either input data or a scratch tile
+ */
+typedef struct {
+    const double* input;  // NULL for a scratch tile
+    size_t slot;
+} dv_expr_ref;
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    arith_op_t op;
+    dv_expr_ref lhs;
+    dv_expr_ref rhs;
+    size_t dst;
+} dv_expr_step;
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    size_t slot;
+    double value;
+} dv_expr_const;
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    dv_expr_step* steps;
+    size_t n_steps;
+    dv_expr_const* consts;
+    size_t n_const;
+    size_t n_slots;
+    size_t tile;
+    size_t len;
+    dv_expr_ref root;
+    double* out;        // Receives the result, or NULL to fold it
+    scan_op_t fold;
+    double* partial;    // Fold of every chunk on the thread pool
+} dv_expr_prog;
+// -------------------------------------------------------------------------------- 
+
+expr_d* init_double_expr(void) {
+    expr_d* expr = malloc(sizeof(expr_d));
+    if (!expr) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    expr->nodes = malloc(EXPR_MIN_TILE * sizeof(dv_expr_node));
+    if (!expr->nodes) {
+        free(expr);
+        errno = ENOMEM;
+        return NULL;
+    }
+    expr->len = 0;
+    expr->alloc = EXPR_MIN_TILE;
+    return expr;
+}
+// -------------------------------------------------------------------------------- 
+
+void free_double_expr(expr_d* expr) {
+    if (!expr) {
+        errno = EINVAL;
+        return;
+    }
+    free(expr->nodes);
+    free(expr);
+}
+// -------------------------------------------------------------------------------- 
+
+void _free_double_expr(expr_d** expr) {
+    if (expr && *expr) {
+        free_double_expr(*expr);
+        *expr = NULL;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+static size_t _expr_push(expr_d* expr, dv_expr_node node) {
+    if (expr->len == expr->alloc) {
+        if (expr->alloc > SIZE_MAX / 2 / sizeof(dv_expr_node)) {
+            errno = ENOMEM;
+            return LONG_MAX;
+        }
+        dv_expr_node* nodes = realloc(expr->nodes, 2 * expr->alloc * sizeof(dv_expr_node));
+        if (!nodes) {
+            errno = ENOMEM;
+            return LONG_MAX;
+        }
+        expr->nodes = nodes;
+        expr->alloc *= 2;
+    }
+    expr->nodes[expr->len] = node;
+    return expr->len++;
+}
+// -------------------------------------------------------------------------------- 
+
+size_t input_double_expr(expr_d* expr, const double_v* vec) {
+    if (!expr || !vec) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return _expr_push(expr, (dv_expr_node){.kind = EXPR_INPUT, .vec = vec});
+}
+// -------------------------------------------------------------------------------- 
+
+size_t const_double_expr(expr_d* expr, double value) {
+    if (!expr) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return _expr_push(expr, (dv_expr_node){.kind = EXPR_CONST, .value = value});
+}
+// -------------------------------------------------------------------------------- 
+
+size_t arith_double_expr(expr_d* expr, arith_op_t op, size_t lhs, size_t rhs) {
+    if (!expr || op < ARITH_ADD || op > ARITH_DIV || lhs >= expr->len || rhs >= expr->len) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return _expr_push(expr, (dv_expr_node){.kind = EXPR_ARITH, .op = op, 
+                                           .lhs = lhs, .rhs = rhs});
+}
+// -------------------------------------------------------------------------------- 
+
+static inline dv_expr_ref _expr_ref(const expr_d* expr, const size_t* slot_of, size_t node) {
+    if (expr->nodes[node].kind == EXPR_INPUT)
+        return (dv_expr_ref){expr->nodes[node].vec->data, 0};
+    return (dv_expr_ref){NULL, slot_of[node]};
+}
+// -------------------------------------------------------------------------------- 
+
+static void _expr_release(dv_expr_prog* prog) {
+    free(prog->steps);
+    free(prog->consts);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Compiles the nodes that root depends on into prog
+ *
+ * @return false with errno set if an input is invalid or memory runs out
+ */
+static bool _expr_compile(const expr_d* expr, size_t root, dv_expr_prog* prog) {
+    size_t n = root + 1;
+    *prog = (dv_expr_prog){0};
+    size_t* work = malloc(3 * n * sizeof(size_t));
+    prog->steps = malloc(n * sizeof(dv_expr_step));
+    prog->consts = malloc(n * sizeof(dv_expr_const));
+    if (!work || !prog->steps || !prog->consts) {
+        free(work);
+        _expr_release(prog);
+        errno = ENOMEM;
+        return false;
+    }
+    size_t* last_use = work;       // Last node that reads a node, SIZE_MAX if unused
+    size_t* slot_of = work + n;    // Scratch tile of a node
+    size_t* free_slots = work + 2 * n;
+
+    // Walking down from root, the first reader found is the last one to run
+    for (size_t i = 0; i < n; ++i) last_use[i] = SIZE_MAX;
+    last_use[root] = n;
+    for (size_t i = n; i-- > 0;) {
+        const dv_expr_node* node = &expr->nodes[i];
+        if (last_use[i] == SIZE_MAX || node->kind != EXPR_ARITH) continue;
+        if (last_use[node->lhs] == SIZE_MAX) last_use[node->lhs] = i;
+        if (last_use[node->rhs] == SIZE_MAX) last_use[node->rhs] = i;
+    }
+
+    size_t n_free = 0;
+    bool valid = true;
+    prog->len = SIZE_MAX;
+    for (size_t i = 0; i < n && valid; ++i) {
+        const dv_expr_node* node = &expr->nodes[i];
+        if (last_use[i] == SIZE_MAX) continue;
+        if (node->kind == EXPR_INPUT) {
+            if (!node->vec->data || (prog->len != SIZE_MAX && node->vec->len != prog->len))
+                valid = false;
+            prog->len = node->vec->len;
+        } else if (node->kind == EXPR_CONST) {
+            // Constant tiles are filled once and never reused
+            slot_of[i] = prog->n_slots++;
+            prog->consts[prog->n_const++] = (dv_expr_const){slot_of[i], node->value};
+        } else {
+            dv_expr_step* step = &prog->steps[prog->n_steps++];
+            step->op = node->op;
+            step->lhs = _expr_ref(expr, slot_of, node->lhs);
+            step->rhs = _expr_ref(expr, slot_of, node->rhs);
+            // The kernels allow the output to be an operand, so a tile read for 
+            // the last time can receive the result
+            if (last_use[node->lhs] == i && expr->nodes[node->lhs].kind == EXPR_ARITH)
+                free_slots[n_free++] = slot_of[node->lhs];
+            if (node->rhs != node->lhs && last_use[node->rhs] == i && 
+                expr->nodes[node->rhs].kind == EXPR_ARITH)
+                free_slots[n_free++] = slot_of[node->rhs];
+            slot_of[i] = n_free > 0 ? free_slots[--n_free] : prog->n_slots++;
+            step->dst = slot_of[i];
+        }
+    }
+    if (valid && prog->len != SIZE_MAX)
+        prog->root = _expr_ref(expr, slot_of, root);
+    free(work);
+    if (!valid || prog->len == SIZE_MAX) {
+        _expr_release(prog);
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t tile = prog->n_slots > 0 ? EXPR_SCRATCH_SIZE / prog->n_slots : EXPR_MAX_TILE;
+    if (tile > EXPR_MAX_TILE) tile = EXPR_MAX_TILE;
+    tile -= tile % EXPR_MIN_TILE;
+    prog->tile = tile < EXPR_MIN_TILE ? EXPR_MIN_TILE : tile;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+static inline const double* _expr_ptr(dv_expr_ref ref, const double* scratch, 
+                                      size_t tile, size_t pos) {
+    return ref.input ? ref.input + pos : scratch + ref.slot * tile;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Runs the program over n elements from start, tile by tile
+ *
+ * @return The fold of the results in tile order when prog->out is NULL
+ */
+static double _expr_run(const dv_expr_prog* prog, double* scratch, size_t start, size_t n) {
+    size_t tile = prog->tile;
+    for (size_t c = 0; c < prog->n_const; ++c) {
+        double* dst = scratch + prog->consts[c].slot * tile;
+        for (size_t i = 0; i < tile; ++i) dst[i] = prog->consts[c].value;
+    }
+
+    double acc = _scan_identity(prog->fold);
+    for (size_t pos = start; pos < start + n; pos += tile) {
+        size_t m = start + n - pos < tile ? start + n - pos : tile;
+        for (size_t s = 0; s < prog->n_steps; ++s) {
+            const dv_expr_step* step = &prog->steps[s];
+            // The root is the last step and writes straight to the output
+            double* dst = prog->out && s + 1 == prog->n_steps ? prog->out + pos 
+                                                              : scratch + step->dst * tile;
+            _kern->arith(_expr_ptr(step->lhs, scratch, tile, pos), 
+                         _expr_ptr(step->rhs, scratch, tile, pos), dst, m, step->op);
+        }
+        const double* result = _expr_ptr(prog->root, scratch, tile, pos);
+        if (!prog->out)
+            acc = _scan_combine(acc, _scan_fold(result, m, prog->fold), prog->fold);
+        else if (prog->n_steps == 0 && result != prog->out + pos)
+            memcpy(prog->out + pos, result, m * sizeof(double));
+    }
+    return acc;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Rounds a stack buffer up to DOUBLE_VECTOR_ALIGNMENT
+ *
+ * The sum kernel peels a scalar head up to the first aligned element, so the
+ * tiles must sit at the same alignment on every thread for a fold to be 
+ * reproducible.
+ */
+static inline double* _expr_align(double* buffer) {
+    uintptr_t addr = (uintptr_t)buffer;
+    addr = (addr + DOUBLE_VECTOR_ALIGNMENT - 1) & ~(uintptr_t)(DOUBLE_VECTOR_ALIGNMENT - 1);
+    return (double*)addr;
+}
+// -------------------------------------------------------------------------------- 
+
+static void _expr_task(void* arg, size_t task) {
+    const dv_expr_prog* prog = arg;
+    double stack[EXPR_SCRATCH_SIZE + DOUBLE_VECTOR_ALIGNMENT / sizeof(double)];
+    double* scratch = _expr_align(stack);
+    size_t start = task * PARALLEL_CHUNK_SIZE;
+    size_t n = prog->len - start < PARALLEL_CHUNK_SIZE ? prog->len - start : PARALLEL_CHUNK_SIZE;
+    prog->partial[task] = _expr_run(prog, scratch, start, n);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Runs a compiled program over all elements
+ *
+ * As with the reductions, large inputs are split into fixed chunks even with 
+ * one thread, and the chunk folds are combined in order.  Programs with more
+ * live tiles than fit in EXPR_SCRATCH_SIZE run their chunks serially on one 
+ * heap buffer.
+ */
+static bool _expr_exec(dv_expr_prog* prog, double* result) {
+    double stack[EXPR_SCRATCH_SIZE + DOUBLE_VECTOR_ALIGNMENT / sizeof(double)];
+    double* scratch = _expr_align(stack);
+    double* heap = NULL;
+    size_t scratch_len = prog->n_slots * prog->tile;
+    if (scratch_len > EXPR_SCRATCH_SIZE) {
+        if (!(heap = _aligned_alloc_double(scratch_len))) {
+            errno = ENOMEM;
+            return false;
+        }
+        scratch = heap;
+    }
+
+    size_t n_chunks = (prog->len + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    if (prog->len < _parallel_threshold || n_chunks < 2) {
+        *result = _expr_run(prog, scratch, 0, prog->len);
+    } else if (!(prog->partial = malloc(n_chunks * sizeof(double)))) {
+        if (heap) _aligned_free_double(heap);
+        errno = ENOMEM;
+        return false;
+    } else {
+        if (!heap) {
+            _parallel_for(_expr_task, prog, n_chunks);
+        } else {
+            for (size_t task = 0; task < n_chunks; ++task) {
+                size_t start = task * PARALLEL_CHUNK_SIZE;
+                size_t n = prog->len - start < PARALLEL_CHUNK_SIZE ? prog->len - start 
+                                                                   : PARALLEL_CHUNK_SIZE;
+                prog->partial[task] = _expr_run(prog, scratch, start, n);
+            }
+        }
+        double acc = _scan_identity(prog->fold);
+        for (size_t i = 0; i < n_chunks; ++i)
+            acc = _scan_combine(acc, prog->partial[i], prog->fold);
+        *result = acc;
+        free(prog->partial);
+    }
+    if (heap) _aligned_free_double(heap);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool eval_double_expr(const expr_d* expr, size_t root, double* out) {
+    if (!expr || !out || root >= expr->len) {
+        errno = EINVAL;
+        return false;
+    }
+    dv_expr_prog prog;
+    if (!_expr_compile(expr, root, &prog)) return false;
+    prog.out = out;
+    double unused;
+    bool ok = _expr_exec(&prog, &unused);
+    _expr_release(&prog);
+    return ok;
+}
+// -------------------------------------------------------------------------------- 
+
+double reduce_double_expr(const expr_d* expr, size_t root, scan_op_t op) {
+    if (!expr || root >= expr->len || op < SCAN_SUM || op > SCAN_MAX) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    dv_expr_prog prog;
+    if (!_expr_compile(expr, root, &prog)) return DBL_MAX;
+    double result = DBL_MAX;
+    if (prog.len == 0) {
+        errno = EINVAL;
+    } else {
+        prog.fold = op;
+        if (!_expr_exec(&prog, &result)) result = DBL_MAX;
+    }
+    _expr_release(&prog);
+    return result;
+}
+// ================================================================================ 
+// ================================================================================ 
+// ORDERED MULTISET
+//
+// The values are kept in sorted leaves of at most MSET_LEAF_SIZE doubles.  A 
+// binary search over the last value of every leaf finds the leaf of a value, 
+// and a Fenwick tree over the leaf counts gives the number of values in front
+// of a leaf, so rank and select cost O(log n) and an insert or delete moves
+// at most one leaf.  Leaves are split when full and merged with a neighbour 
+// when they drop below a quarter, which rebuilds the leaf arrays in 
+// O(n / MSET_LEAF_SIZE) but happens at most once per MSET_LEAF_SIZE / 4 
+// updates.
+
+#define MSET_LEAF_SIZE 512  // Doubles per leaf, one 4 kB page
+#define MSET_MIN_LEAVES 4
+
+struct multiset_d {
+    double** leaves;
+    size_t* counts;
+    double* last;      // Largest value of every leaf
+    size_t* fenwick;   // 1 based Fenwick tree over counts
+    size_t n_leaves;
+    size_t alloc;
+    size_t len;
+};
+// -------------------------------------------------------------------------------- 
+
+multiset_d* init_double_multiset(void) {
+    multiset_d* ms = calloc(1, sizeof(multiset_d));
+    if (!ms) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    ms->leaves = malloc(MSET_MIN_LEAVES * sizeof(double*));
+    ms->counts = malloc(MSET_MIN_LEAVES * sizeof(size_t));
+    ms->last = malloc(MSET_MIN_LEAVES * sizeof(double));
+    ms->fenwick = malloc((MSET_MIN_LEAVES + 1) * sizeof(size_t));
+    if (!ms->leaves || !ms->counts || !ms->last || !ms->fenwick) {
+        free(ms->leaves);
+        free(ms->counts);
+        free(ms->last);
+        free(ms->fenwick);
+        free(ms);
+        errno = ENOMEM;
+        return NULL;
+    }
+    ms->alloc = MSET_MIN_LEAVES;
+    ms->fenwick[0] = 0;
+    return ms;
+}
+// -------------------------------------------------------------------------------- 
+
+void free_double_multiset(multiset_d* ms) {
+    if (!ms) {
+        errno = EINVAL;
+        return;
+    }
+    for (size_t i = 0; i < ms->n_leaves; ++i) _aligned_free_double(ms->leaves[i]);
+    free(ms->leaves);
+    free(ms->counts);
+    free(ms->last);
+    free(ms->fenwick);
+    free(ms);
+}
+// -------------------------------------------------------------------------------- 
+
+void _free_double_multiset(multiset_d** ms) {
+    if (ms && *ms) {
+        free_double_multiset(*ms);
+        *ms = NULL;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Makes room for one more leaf in the leaf arrays
+ */
+static bool _mset_reserve(multiset_d* ms) {
+    if (ms->n_leaves < ms->alloc) return true;
+    if (ms->alloc > SIZE_MAX / 2 / sizeof(double*)) {
+        errno = ENOMEM;
+        return false;
+    }
+    size_t alloc = ms->alloc * 2;
+    double** leaves = realloc(ms->leaves, alloc * sizeof(double*));
+    if (leaves) ms->leaves = leaves;
+    size_t* counts = realloc(ms->counts, alloc * sizeof(size_t));
+    if (counts) ms->counts = counts;
+    double* last = realloc(ms->last, alloc * sizeof(double));
+    if (last) ms->last = last;
+    size_t* fenwick = realloc(ms->fenwick, (alloc + 1) * sizeof(size_t));
+    if (fenwick) ms->fenwick = fenwick;
+    if (!leaves || !counts || !last || !fenwick) {
+        errno = ENOMEM;
+        return false;
+    }
+    ms->alloc = alloc;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Rebuilds the Fenwick tree in O(n_leaves) after leaves were added or 
+ *        removed
+ */
+static void _mset_rebuild(multiset_d* ms) {
+    size_t n = ms->n_leaves;
+    size_t* f = ms->fenwick;
+    for (size_t i = 1; i <= n; ++i) f[i] = ms->counts[i - 1];
+    for (size_t i = 1; i <= n; ++i) {
+        size_t j = i + (i & (~i + 1));
+        if (j <= n) f[j] += f[i];
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Adds delta to the count of a leaf in the Fenwick tree; (size_t)-1 
+ *        subtracts one through unsigned wrap around
+ */
+static void _mset_add(multiset_d* ms, size_t leaf, size_t delta) {
+    for (size_t i = leaf + 1; i <= ms->n_leaves; i += i & (~i + 1))
+        ms->fenwick[i] += delta;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Returns the number of values in the leaves in front of leaf
+ */
+static size_t _mset_prefix(const multiset_d* ms, size_t leaf) {
+    size_t sum = 0;
+    for (size_t i = leaf; i > 0; i -= i & (~i + 1)) sum += ms->fenwick[i];
+    return sum;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Inserts a leaf of count values at position at of the leaf arrays,
+ *        which must have room for it
+ */
+static void _mset_insert_leaf(multiset_d* ms, size_t at, double* leaf, size_t count) {
+    size_t move = ms->n_leaves - at;
+    memmove(ms->leaves + at + 1, ms->leaves + at, move * sizeof(double*));
+    memmove(ms->counts + at + 1, ms->counts + at, move * sizeof(size_t));
+    memmove(ms->last + at + 1, ms->last + at, move * sizeof(double));
+    ms->leaves[at] = leaf;
+    ms->counts[at] = count;
+    ms->last[at] = leaf[count - 1];
+    ms->n_leaves++;
+    _mset_rebuild(ms);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Frees the leaf at position at and closes the gap it leaves
+ */
+static void _mset_remove_leaf(multiset_d* ms, size_t at) {
+    _aligned_free_double(ms->leaves[at]);
+    size_t move = ms->n_leaves - at - 1;
+    memmove(ms->leaves + at, ms->leaves + at + 1, move * sizeof(double*));
+    memmove(ms->counts + at, ms->counts + at + 1, move * sizeof(size_t));
+    memmove(ms->last + at, ms->last + at + 1, move * sizeof(double));
+    ms->n_leaves--;
+    _mset_rebuild(ms);
+}
+// -------------------------------------------------------------------------------- 
+
+bool insert_double_multiset(multiset_d* ms, double value) {
+    if (!ms || isnan(value)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (ms->n_leaves == 0) {
+        double* leaf = _aligned_alloc_double(MSET_LEAF_SIZE);
+        if (!leaf) {
+            errno = ENOMEM;
+            return false;
+        }
+        leaf[0] = value;
+        _mset_insert_leaf(ms, 0, leaf, 1);
+        ms->len = 1;
+        return true;
+    }
+
+    // Equal values go after the ones already stored
+    size_t i = _bound_search(ms->last, ms->n_leaves, value, true);
+    if (i == ms->n_leaves) i--;
+    double* leaf = ms->leaves[i];
+    size_t count = ms->counts[i];
+
+    // Allocate before changing anything, so a failed split leaves ms intact
+    double* upper = NULL;
+    if (count + 1 == MSET_LEAF_SIZE) {
+        if (!_mset_reserve(ms)) return false;
+        upper = _aligned_alloc_double(MSET_LEAF_SIZE);
+        if (!upper) {
+            errno = ENOMEM;
+            return false;
+        }
+    }
+
+    size_t pos = _bound_search(leaf, count, value, true);
+    memmove(leaf + pos + 1, leaf + pos, (count - pos) * sizeof(double));
+    leaf[pos] = value;
+    ms->len++;
+    if (upper) {
+        const size_t half = MSET_LEAF_SIZE / 2;
+        memcpy(upper, leaf + half, half * sizeof(double));
+        ms->counts[i] = half;
+        ms->last[i] = leaf[half - 1];
+        _mset_insert_leaf(ms, i + 1, upper, half);
+        return true;
+    }
+    ms->counts[i] = count + 1;
+    ms->last[i] = leaf[count];
+    _mset_add(ms, i, 1);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool remove_double_multiset(multiset_d* ms, double value) {
+    if (!ms || isnan(value)) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t i = _bound_search(ms->last, ms->n_leaves, value, false);
+    if (i == ms->n_leaves) {
+        errno = ENOENT;
+        return false;
+    }
+    double* leaf = ms->leaves[i];
+    size_t count = ms->counts[i];
+    size_t pos = _bound_search(leaf, count, value, false);
+    if (leaf[pos] != value) {
+        errno = ENOENT;
+        return false;
+    }
+
+    memmove(leaf + pos, leaf + pos + 1, (count - pos - 1) * sizeof(double));
+    count--;
+    ms->len--;
+    if (count == 0) {
+        _mset_remove_leaf(ms, i);
+        return true;
+    }
+    ms->counts[i] = count;
+    ms->last[i] = leaf[count - 1];
+
+    // Merge a sparse leaf into a neighbour when the result stays half full
+    if (count < MSET_LEAF_SIZE / 4 && ms->n_leaves > 1) {
+        size_t lo = i + 1 < ms->n_leaves ? i : i - 1;
+        if (ms->counts[lo] + ms->counts[lo + 1] <= MSET_LEAF_SIZE / 2) {
+            memcpy(ms->leaves[lo] + ms->counts[lo], ms->leaves[lo + 1], 
+                   ms->counts[lo + 1] * sizeof(double));
+            ms->counts[lo] += ms->counts[lo + 1];
+            ms->last[lo] = ms->last[lo + 1];
+            _mset_remove_leaf(ms, lo + 1);
+            return true;
+        }
+    }
+    _mset_add(ms, i, (size_t)-1);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+size_t double_multiset_size(const multiset_d* ms) {
+    if (!ms) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return ms->len;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Number of values below value, or at or below it when upper is true
+ */
+static size_t _mset_rank(const multiset_d* ms, double value, bool upper) {
+    size_t i = _bound_search(ms->last, ms->n_leaves, value, upper);
+    if (i == ms->n_leaves) return ms->len;
+    return _mset_prefix(ms, i) + _bound_search(ms->leaves[i], ms->counts[i], value, upper);
+}
+// -------------------------------------------------------------------------------- 
+
+size_t rank_double_multiset(const multiset_d* ms, double value) {
+    if (!ms || isnan(value)) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return _mset_rank(ms, value, false);
+}
+// -------------------------------------------------------------------------------- 
+
+size_t count_range_double_multiset(const multiset_d* ms, double lo, double hi) {
+    if (!ms || isnan(lo) || isnan(hi)) {
         errno = EINVAL;
         return LONG_MAX;
     }
-    
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return LONG_MAX;
+    if (lo > hi) return 0;
+    return _mset_rank(ms, hi, true) - _mset_rank(ms, lo, false);
+}
+// -------------------------------------------------------------------------------- 
+
+double select_double_multiset(const multiset_d* ms, size_t k) {
+    if (!ms) {
+        errno = EINVAL;
+        return DBL_MAX;
+    }
+    if (k >= ms->len) {
+        errno = ERANGE;
+        return DBL_MAX;
+    }
+    // Descend the Fenwick tree to the last leaf whose prefix is at most k
+    size_t step = 1;
+    while (step * 2 <= ms->n_leaves) step *= 2;
+    size_t pos = 0;
+    for (; step > 0; step /= 2) {
+        if (pos + step <= ms->n_leaves && ms->fenwick[pos + step] <= k) {
+            pos += step;
+            k -= ms->fenwick[pos];
+        }
+    }
+    return ms->leaves[pos][k];
+}
+// -------------------------------------------------------------------------------- 
+
+bool foreach_range_double_multiset(const multiset_d* ms, double lo, double hi,
+                                   multiset_iterator iter, void* user_data) {
+    if (!ms || !iter || isnan(lo) || isnan(hi)) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t i = _bound_search(ms->last, ms->n_leaves, lo, false);
+    if (i == ms->n_leaves) return true;
+    size_t pos = _bound_search(ms->leaves[i], ms->counts[i], lo, false);
+    for (; i < ms->n_leaves; ++i, pos = 0) {
+        const double* leaf = ms->leaves[i];
+        for (; pos < ms->counts[i]; ++pos) {
+            if (leaf[pos] > hi) return true;
+            iter(leaf[pos], user_data);
+        }
+    }
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+double_v* get_values_double_multiset(const multiset_d* ms) {
+    if (!ms) {
+        errno = EINVAL;
+        return NULL;
+    }
+    double_v* vec = init_double_vector(ms->len > 0 ? ms->len : 1);
+    if (!vec) return NULL;
+    for (size_t i = 0; i < ms->n_leaves; ++i) {
+        memcpy(vec->data + vec->len, ms->leaves[i], ms->counts[i] * sizeof(double));
+        vec->len += ms->counts[i];
+    }
+    vec->sorted = true;
+    return vec;
+}
+// ================================================================================ 
+// ================================================================================ 
+
+// DICTIONARY IMPLEMENTATION
+
+typedef struct ddictNode {
+    char* key;
+    double value;
+    struct ddictNode* next;
+} ddictNode;
+// --------------------------------------------------------------------------------
+
+struct dict_d {
+    ddictNode* keyValues;
+    size_t hash_size;
+    size_t len;
+    size_t alloc;
+};
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief MurmurHash3-inspired hash function for strings
+ * 
+ * @param key The string key to hash
+ * @param seed Optional seed for hash randomization (helps prevent hash flooding)
+ * @return size_t The computed hash value
+ */
+static size_t hash_function(const char* key, const uint32_t seed) {
+    if (!key) {
+        return 0;
+    }
+
+    // Constants for mixing
+    const uint32_t c1 = 0xcc9e2d51;
+    const uint32_t c2 = 0x1b873593;
+    uint32_t h1 = seed;
+
+    // Process key in 4-byte chunks
+    const unsigned char* data = (const unsigned char*)key;
+    size_t len = strlen(key);
+    const size_t nblocks = len / 4;
+
+    // Body
+    const uint32_t* blocks = (const uint32_t*)(data);
+    for (size_t i = 0; i < nblocks; i++) {
+        uint32_t k1 = blocks[i];
+
+        k1 *= c1;
+        k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
+        k1 *= c2;
+
+        h1 ^= k1;
+        h1 = (h1 << 13) | (h1 >> 19);  // ROTL32(h1, 13)
+        h1 = h1 * 5 + 0xe6546b64;
+    }
+
+    // Tail
+    const unsigned char* tail = data + nblocks * 4;
+    uint32_t k1 = 0;
+
+    switch (len & 3) {
+        case 3:
+            k1 ^= tail[2] << 16;
+            /* fallthrough */
+        case 2:
+            k1 ^= tail[1] << 8;
+            /* fallthrough */
+        case 1:
+            k1 ^= tail[0];
+            k1 *= c1;
+            k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
+            k1 *= c2;
+            h1 ^= k1;
     }
 
-    if (tolerance < 0) {
+    // Finalization
+    h1 ^= len;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    h1 ^= h1 >> 16;
+
+    return (size_t)h1;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Resizes the dictionary's hash table
+ * 
+ * @param dict Pointer to the dictionary
+ * @param new_size Desired new size for the hash table
+ * @return bool true if resize successful, false otherwise
+ */
+static bool resize_dict(dict_d* dict, size_t new_size) {
+    // Input validation
+    if (!dict || new_size < dict->hash_size || new_size == 0) {
         errno = EINVAL;
-        return LONG_MAX;
+        return false;
     }
 
-    if (isnan(value) || isnan(tolerance)) {
+    // Ensure new_size is a power of 2 for better distribution
+    new_size = (size_t)pow(2, ceil(log2(new_size)));
+
+    // Use calloc for automatic zero initialization
+    ddictNode* new_table = calloc(new_size, sizeof(ddictNode));
+    if (!new_table) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    // Keep track of old table in case we need to recover
+    ddictNode* old_table = dict->keyValues;
+    const size_t old_size = dict->alloc;
+    size_t rehashed_count = 0;
+
+    // Rehash existing entries
+    for (size_t i = 0; i < old_size; i++) {
+        ddictNode* current = old_table[i].next;
+        
+        while (current) {
+            ddictNode* next = current->next;  // Save next pointer before modifying node
+
+            // Calculate new index using enhanced hash function
+            size_t new_index = hash_function(current->key, HASH_SEED) % new_size;
+
+            // Insert at the beginning of the new chain
+            current->next = new_table[new_index].next;
+            new_table[new_index].next = current;
+            
+            rehashed_count++;
+            current = next;
+        }
+    }
+
+    // Verify all entries were rehashed successfully
+    if (rehashed_count != dict->hash_size) {
+        // Cleanup and restore old state
+        for (size_t i = 0; i < new_size; i++) {
+            ddictNode* current = new_table[i].next;
+            while (current) {
+                ddictNode* next = current->next;
+                current->next = NULL;
+                current = next;
+            }
+        }
+        free(new_table);
+        errno = EAGAIN;
+        return false;
+    }
+
+    // Update the dictionary only after successful rehashing
+    dict->keyValues = new_table;
+    dict->alloc = new_size;
+
+    // Clean up old table (but not the nodes, as they were moved)
+    free(old_table);
+
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+dict_d* init_double_dict(void) {
+    // Allocate the dictionary structure
+    dict_d* dict = calloc(1, sizeof(dict_d));
+    if (!dict) {
+        errno = ENOMEM;
+        fprintf(stderr, "Failed to allocate dictionary structure\n");
+        return NULL;
+    }
+
+    // Allocate initial hash table array
+    dict->keyValues = calloc(hashSize, sizeof(ddictNode));
+    if (!dict->keyValues) {
+        errno = ENOMEM;
+        fprintf(stderr, "Failed to allocate hash table array\n");
+        free(dict);
+        return NULL;
+    }
+
+    // Initialize dictionary metadata
+    dict->hash_size = 0;   // No items yet
+    dict->len = 0;         // No occupied buckets
+    dict->alloc = hashSize;
+
+    return dict;
+}
+// --------------------------------------------------------------------------------
+
+bool insert_double_dict(dict_d* dict, const char* key, double value) {
+    if (!dict || !key) {
         errno = EINVAL;
-        return LONG_MAX;
+        return false;
     }
+
+    // Check load factor and resize if necessary using adaptive growth strategy
+    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
+        size_t new_size;
+        if (dict->alloc < VEC_THRESHOLD) {
+            new_size = dict->alloc * 2;  // Double when small
+        } else {
+            new_size = dict->alloc + VEC_FIXED_AMOUNT;  // Linear growth when large
+        }
+        
+        if (!resize_dict(dict, new_size)) {
+            return false;  // resize_dict sets appropriate errno
+        }
+    }
+
+    // Rest of the function remains the same as previous improvement...
+    const size_t index = hash_function(key, HASH_SEED) % dict->alloc;
     
-    // Sort if requested and vector has more than 1 element
-    if (sort_first && vec->len > 1) {
-        sort_double_vector(vec, FORWARD);
+    // Check for existing key
+    for (ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+        if (strcmp(current->key, key) == 0) {
+            errno = EEXIST;
+            return false;
+        }
+    }
+
+    char* new_key = strdup(key);
+    if (!new_key) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    ddictNode* new_node = malloc(sizeof(ddictNode));
+    if (!new_node) {
+        free(new_key);
+        errno = ENOMEM;
+        return false;
+    }
+
+    new_node->key = new_key;
+    new_node->value = value;
+    new_node->next = dict->keyValues[index].next;
+    dict->keyValues[index].next = new_node;
+
+    dict->hash_size++;
+    if (new_node->next == NULL) {
+        dict->len++;
+    }
+
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+double pop_double_dict(dict_d* dict, const char* key) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return FLT_MAX;
     }
+
+    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
     
-    size_t left = 0;
-    size_t right = vec->len - 1;
+    ddictNode* prev = &dict->keyValues[index];
+    ddictNode* current = prev->next;
     
-    while (left <= right) {
-        size_t mid = left + (right - left) / 2;
-        double diff = vec->data[mid] - value;
-        
-        // Check if we found a match within tolerance
-        if (fabs(diff) <= tolerance) {
-            return mid;
-        }
-        
-        if (diff < 0) {
-            left = mid + 1;
-        } else {
-            // Handle case where mid is 0 to prevent underflow
-            if (mid == 0) {
-                break;
+    while (current) {
+        if (strcmp(current->key, key) == 0) {
+            // Save value and unlink node
+            double value = current->value;
+            prev->next = current->next;
+            
+            // Update dictionary metadata
+            dict->hash_size--;
+            if (!prev->next) {  // If bucket is now empty
+                dict->len--;
             }
-            right = mid - 1;
+            
+            // Clean up node memory
+            free(current->key);
+            free(current);
+            
+            return value;
         }
+        prev = current;
+        current = current->next;
     }
-    // The value does not exist in the array 
-    return LONG_MAX;
-}
-// -------------------------------------------------------------------------------- 
 
-void update_double_vector(double_v* vec, size_t index, double replacement_value) {
-    if (!vec || !vec->data || vec->len == 0) {
-        errno = EINVAL;
-        return;
-    }
-    if (index > vec->len -1) {
-        errno = ERANGE;
-        return;
-    }
-    vec->data[index] = replacement_value;
+    errno = ENOENT;  // Set errno when key not found
+    return FLT_MAX;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-double min_double_vector(double_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
+double get_double_dict_value(const dict_d* dict, const char* key) {
+    if (!dict || !key) {
         errno = EINVAL;
-        return DBL_MAX;
+        return FLT_MAX;
     }
 
-    double min_val = DBL_MAX;
-
-#if defined(__AVX__)
-    __m256d vmin = _mm256_set1_pd(min_val);
-    size_t i = 0;
-
-    for (; i + 3 < vec->len; i += 4) {
-        __m256d v = _mm256_loadu_pd(&vec->data[i]);
-        vmin = _mm256_min_pd(vmin, v);
+    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
+    
+    for (const ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+        if (strcmp(current->key, key) == 0) {
+            return current->value;
+        }
     }
 
-    __m128d low = _mm256_castpd256_pd128(vmin);
-    __m128d high = _mm256_extractf128_pd(vmin, 1);
-    __m128d min128 = _mm_min_pd(low, high);
-    min128 = _mm_min_pd(min128, _mm_unpackhi_pd(min128, min128));
-    min_val = _mm_cvtsd_f64(min128);
-
-    for (; i < vec->len; ++i)
-        if (vec->data[i] < min_val)
-            min_val = vec->data[i];
-
-#elif defined(__SSE2__)
-    __m128d vmin = _mm_set1_pd(min_val);
-    size_t i = 0;
+    errno = ENOENT;  // Set errno when key not found
+    return FLT_MAX;
+}
+// --------------------------------------------------------------------------------
 
-    for (; i + 1 < vec->len; i += 2) {
-        __m128d v = _mm_loadu_pd(&vec->data[i]);
-        vmin = _mm_min_pd(vmin, v);
+void free_double_dict(dict_d* dict) {
+    if (!dict) {
+        return;  // Silent return on NULL - common pattern for free functions
     }
 
-    vmin = _mm_min_pd(vmin, _mm_unpackhi_pd(vmin, vmin));
-    min_val = _mm_cvtsd_f64(vmin);
-
-    for (; i < vec->len; ++i)
-        if (vec->data[i] < min_val)
-            min_val = vec->data[i];
-
-#else
-    for (size_t i = 0; i < vec->len; ++i)
-        if (vec->data[i] < min_val)
-            min_val = vec->data[i];
-#endif
+    // Free all nodes in each bucket
+    for (size_t i = 0; i < dict->alloc; i++) {
+        ddictNode* current = dict->keyValues[i].next;
+        while (current) {      
+            ddictNode* next = current->next;  // Save next pointer before freeing
+            free(current->key);
+            free(current);
+            current = next;
+        }
+    }
 
-    return min_val;
+    // Free the hash table and dictionary struct
+    free(dict->keyValues);
+    free(dict);
 }
 // -------------------------------------------------------------------------------- 
 
-double max_double_vector(double_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
-        errno = EINVAL;
-        return -DBL_MAX;
+void _free_double_dict(dict_d** dict_ptr) {
+    if (dict_ptr && *dict_ptr) {
+        free_double_dict(*dict_ptr);
+        *dict_ptr = NULL;  // Prevent use-after-free
     }
+}
+// --------------------------------------------------------------------------------
 
-    double max_val = -DBL_MAX;
-
-#if defined(__AVX__)
-    __m256d vmax = _mm256_set1_pd(max_val);
-    size_t i = 0;
-
-    for (; i + 3 < vec->len; i += 4) {
-        __m256d v = _mm256_loadu_pd(&vec->data[i]);
-        vmax = _mm256_max_pd(vmax, v);
+bool update_double_dict(dict_d* dict, const char* key, double value) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return false;
     }
 
-    // Reduce 4 values to 1 max
-    __m128d low = _mm256_castpd256_pd128(vmax);
-    __m128d high = _mm256_extractf128_pd(vmax, 1);
-    __m128d max128 = _mm_max_pd(low, high);
-    max128 = _mm_max_pd(max128, _mm_unpackhi_pd(max128, max128));
-    max_val = _mm_cvtsd_f64(max128);
-
-    // Scalar fallback for remainder
-    for (; i < vec->len; ++i)
-        if (vec->data[i] > max_val)
-            max_val = vec->data[i];
-
-#elif defined(__SSE2__)
-    __m128d vmax = _mm_set1_pd(max_val);
-    size_t i = 0;
-
-    for (; i + 1 < vec->len; i += 2) {
-        __m128d v = _mm_loadu_pd(&vec->data[i]);
-        vmax = _mm_max_pd(vmax, v);
+    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
+    
+    for (ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+        if (strcmp(current->key, key) == 0) {
+            current->value = value;
+            return true;
+        }
     }
 
-    // Reduce 2 values to 1
-    vmax = _mm_max_pd(vmax, _mm_unpackhi_pd(vmax, vmax));
-    max_val = _mm_cvtsd_f64(vmax);
-
-    for (; i < vec->len; ++i)
-        if (vec->data[i] > max_val)
-            max_val = vec->data[i];
-
-#else
-    // Pure scalar fallback
-    for (size_t i = 0; i < vec->len; ++i)
-        if (vec->data[i] > max_val)
-            max_val = vec->data[i];
-#endif
-
-    return max_val;
+    errno = ENOENT;  // More specific error code for missing key
+    return false;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-double sum_double_vector(double_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
+size_t double_dict_size(const dict_d* dict) {
+    if (!dict) {
         errno = EINVAL;
-        return DBL_MAX;
+        return SIZE_MAX;
     }
+    return dict->len;
+}
+// --------------------------------------------------------------------------------
 
-    const size_t len = vec->len;
-    const double* data = vec->data;
-
-    double sum = 0.0;
-
-#if defined(__AVX__)
-    __m256d vsum = _mm256_setzero_pd();
-    size_t i = 0;
-
-    for (; i + 3 < len; i += 4) {
-        __m256d chunk = _mm256_loadu_pd(&data[i]);
-        vsum = _mm256_add_pd(vsum, chunk);
+size_t double_dict_alloc(const dict_d* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return SIZE_MAX;
     }
+    return dict->alloc;
+}
+// --------------------------------------------------------------------------------
 
-    // Horizontal sum of 4 doubles
-    __m128d low  = _mm256_castpd256_pd128(vsum);        // lower 2 doubles
-    __m128d high = _mm256_extractf128_pd(vsum, 1);      // upper 2 doubles
-    __m128d sum128 = _mm_add_pd(low, high);             // add pairs
-    sum128 = _mm_add_pd(sum128, _mm_unpackhi_pd(sum128, sum128)); // final sum
-    sum += _mm_cvtsd_f64(sum128);
-
-    // Handle remaining elements
-    for (; i < len; ++i) {
-        sum += data[i];
+size_t double_dict_hash_size(const dict_d* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return SIZE_MAX;
     }
+    return dict->hash_size;
+}
+// -------------------------------------------------------------------------------- 
 
-#elif defined(__SSE2__)
-    __m128d vsum = _mm_setzero_pd();
-    size_t i = 0;
-
-    for (; i + 1 < len; i += 2) {
-        __m128d chunk = _mm_loadu_pd(&data[i]);
-        vsum = _mm_add_pd(vsum, chunk);
+bool has_key_double_dict(const dict_d* dict, const char* key) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return false;
     }
 
-    vsum = _mm_add_pd(vsum, _mm_unpackhi_pd(vsum, vsum)); // sum 2 doubles
-    sum += _mm_cvtsd_f64(vsum);
-
-    for (; i < len; ++i) {
-        sum += data[i];
-    }
+    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
 
-#else
-    // Fallback to scalar sum
-    for (size_t i = 0; i < len; ++i) {
-        sum += data[i];
+    for (const ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+        if (strcmp(current->key, key) == 0) {
+            return true;
+        }
     }
-#endif
 
-    return sum;
+    return false;
 }
 // -------------------------------------------------------------------------------- 
 
-double average_double_vector(double_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
+dict_d* copy_double_dict(const dict_d* dict) {
+    if (!dict) {
         errno = EINVAL;
-        return DBL_MAX;
+        return NULL;
     }
 
-    double sum = sum_double_vector(vec);
-    if (errno != 0) return DBL_MAX;
-    return sum / vec->len;
-}
-
-// -------------------------------------------------------------------------------- 
-
-double stdev_double_vector(double_v* vec) {
-    if (!vec || !vec->data || vec->len < 2) {
-        errno = ENODATA;
-        return DBL_MAX;
+    // Create new dictionary with same capacity
+    dict_d* new_dict = malloc(sizeof(dict_d));
+    if (!new_dict) {
+        errno = ENOMEM;
+        return NULL;
     }
 
-    double mean = average_double_vector(vec);
-    if (errno != 0) return DBL_MAX;
-
-    double sum_sq_diff = 0.0;
-
-#if defined(__AVX__)
-    __m256d vmean = _mm256_set1_pd(mean);
-    __m256d vsum = _mm256_setzero_pd();
-    size_t i = 0;
+    new_dict->keyValues = calloc(dict->alloc, sizeof(ddictNode));
+    if (!new_dict->keyValues) {
+        free(new_dict);
+        errno = ENOMEM;
+        return NULL;
+    }
 
-    for (; i + 3 < vec->len; i += 4) {
-        __m256d v = _mm256_loadu_pd(&vec->data[i]);
-        __m256d diff = _mm256_sub_pd(v, vmean);
-        __m256d sq = _mm256_mul_pd(diff, diff);
+    // Copy metadata
+    new_dict->alloc = dict->alloc;
+    new_dict->hash_size = 0;  // Will be incremented during insertion
+    new_dict->len = 0;        // Will be incremented during insertion
 
-        // Check for infinity in any of the 4 values
-        for (int j = 0; j < 4; ++j) {
-            if (isinf(vec->data[i + j])) return INFINITY;
+    // Copy all entries
+    for (size_t i = 0; i < dict->alloc; i++) {
+        ddictNode* current = dict->keyValues[i].next;
+        while (current) {
+            // Insert will handle incrementing hash_size and len
+            if (!insert_double_dict(new_dict, current->key, current->value)) {
+                free_double_dict(new_dict);  // Clean up on failure
+                return NULL;
+            }
+            current = current->next;
         }
-
-        vsum = _mm256_add_pd(vsum, sq);
     }
 
-    // Horizontal sum of vsum
-    __m128d low  = _mm256_castpd256_pd128(vsum);
-    __m128d high = _mm256_extractf128_pd(vsum, 1);
-    __m128d sum128 = _mm_add_pd(low, high);
-    sum128 = _mm_add_pd(sum128, _mm_unpackhi_pd(sum128, sum128));
-    sum_sq_diff += _mm_cvtsd_f64(sum128);
+    return new_dict;
+}
+// -------------------------------------------------------------------------------- 
 
-    // Remainder (scalar)
-    for (; i < vec->len; ++i) {
-        if (isinf(vec->data[i])) return INFINITY;
-        double diff = vec->data[i] - mean;
-        sum_sq_diff += diff * diff;
+bool clear_double_dict(dict_d* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
     }
 
-#elif defined(__SSE2__)
-    __m128d vmean = _mm_set1_pd(mean);
-    __m128d vsum = _mm_setzero_pd();
-    size_t i = 0;
-
-    for (; i + 1 < vec->len; i += 2) {
-        __m128d v = _mm_loadu_pd(&vec->data[i]);
-        __m128d diff = _mm_sub_pd(v, vmean);
-        __m128d sq = _mm_mul_pd(diff, diff);
-
-        for (int j = 0; j < 2; ++j) {
-            if (isinf(vec->data[i + j])) return INFINITY;
+    // Free all nodes in each bucket
+    for (size_t i = 0; i < dict->alloc; i++) {
+        ddictNode* current = dict->keyValues[i].next;
+        while (current) {
+            ddictNode* next = current->next;
+            free(current->key);
+            free(current);
+            current = next;
         }
-
-        vsum = _mm_add_pd(vsum, sq);
+        dict->keyValues[i].next = NULL;  // Reset bucket head
     }
 
-    vsum = _mm_add_pd(vsum, _mm_unpackhi_pd(vsum, vsum));
-    sum_sq_diff += _mm_cvtsd_f64(vsum);
+    // Reset dictionary metadata
+    dict->hash_size = 0;
+    dict->len = 0;
 
-    for (; i < vec->len; ++i) {
-        if (isinf(vec->data[i])) return INFINITY;
-        double diff = vec->data[i] - mean;
-        sum_sq_diff += diff * diff;
-    }
+    return true;
+}
+// -------------------------------------------------------------------------------- 
 
-#else
-    for (size_t i = 0; i < vec->len; ++i) {
-        if (isinf(vec->data[i])) return INFINITY;
-        double diff = vec->data[i] - mean;
-        sum_sq_diff += diff * diff;
+string_v* get_keys_double_dict(const dict_d* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return NULL;
     }
-#endif
-
-    return sqrt(sum_sq_diff / vec->len);
+    string_v* vec = init_str_vector(dict->hash_size);
+    if (!vec) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (ddictNode* current = dict->keyValues[i].next; current; current = current->next) {
+            if (!push_back_str_vector(vec, current->key)) {
+                free_str_vector(vec);
+                errno = ENOMEM;
+                return NULL;
+            }
+        }
+    }
+    return vec;
 }
 // -------------------------------------------------------------------------------- 
 
-double_v* cum_sum_double_vector(double_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
+double_v* get_values_double_dict(const dict_d* dict) {
+    if (!dict) {
         errno = EINVAL;
         return NULL;
     }
-
-    double_v* new_vec = init_double_vector(vec->len);
-    if (!new_vec) {
+    double_v* vec = init_double_vector(dict->hash_size);
+    if (!vec) {
         errno = ENOMEM;
         return NULL;
     }
-
-    double sum = 0.0f;
-    for (size_t i = 0; i < vec->len; ++i) {
-        double val = vec->data[i];
-        if (isnan(val)) {
-            errno = EINVAL;
-            free_double_vector(new_vec);
-            return NULL;
+    // Iterate through all buckets
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (ddictNode* current = dict->keyValues[i].next; current; current = current->next) {
+            if (!push_back_double_vector(vec, current->value)) {
+                free_double_vector(vec);
+                errno = ENOMEM;
+                return NULL;
+            }
         }
+    }
+    return vec;
+}
+// -------------------------------------------------------------------------------- 
+
+dict_d* merge_double_dict(const dict_d* dict1, const dict_d* dict2, bool overwrite) {
+    if (!dict1 || !dict2) {
+        errno = EINVAL;
+        return NULL;
+    }
 
-        sum += val;
+    // Create new dictionary with capacity for all items
+    //size_t initial_size = dict1->hash_size + dict2->hash_size;
+    dict_d* merged = init_double_dict();
+    if (!merged) {
+        return NULL;  // errno set by init_double_dict
+    }
 
-        if (isinf(sum)) {
-            // Fill rest with infinity
-            for (; i < vec->len; ++i) {
-                push_back_double_vector(new_vec, INFINITY);
+    // First, copy all entries from dict1
+    for (size_t i = 0; i < dict1->alloc; i++) {
+        for (ddictNode* current = dict1->keyValues[i].next; current; current = current->next) {
+            if (!insert_double_dict(merged, current->key, current->value)) {
+                free_double_dict(merged);
+                return NULL;
             }
-            return new_vec;
         }
+    }
 
-        if (!push_back_double_vector(new_vec, sum)) {
-            free_double_vector(new_vec);
-            return NULL;
+    // Then handle dict2 entries
+    for (size_t i = 0; i < dict2->alloc; i++) {
+        for (ddictNode* current = dict2->keyValues[i].next; current; current = current->next) {
+            double existing_value;
+            // Check if key exists in merged dictionary
+            if ((existing_value = get_double_dict_value(merged, current->key)) != FLT_MAX) {
+                if (overwrite) {
+                    // Update existing value if overwrite is true
+                    if (!update_double_dict(merged, current->key, current->value)) {
+                        free_double_dict(merged);
+                        return NULL;
+                    }
+                }
+                // If overwrite is false, keep original value
+            } else {
+                // Key doesn't exist, insert new entry
+                if (!insert_double_dict(merged, current->key, current->value)) {
+                    free_double_dict(merged);
+                    return NULL;
+                }
+            }
         }
     }
 
-    return new_vec;
+    return merged;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-double_v* copy_double_vector(const double_v* original) {
-    if (!original) {
+bool foreach_double_dict(const dict_d* dict, dict_iterator iter, void* user_data) {
+    if (!dict || !iter) {
         errno = EINVAL;
-        return NULL;
-    }
-
-    double_v* copy = init_double_vector(original->alloc);
-    if (!copy) {
-        return NULL;
+        return false;
     }
 
-    for (size_t i = 0; i < original->len; ++i) {
-        if (!push_back_double_vector(copy, original->data[i])) {
-            free_double_vector(copy);
-            return NULL;
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (ddictNode* current = dict->keyValues[i].next; current; current = current->next) {
+            iter(current->key, current->value, user_data);
         }
     }
 
-    return copy;
+    return true;
 }
 // ================================================================================ 
 // ================================================================================ 
 
-// DICTIONARY IMPLEMENTATION
-
-typedef struct ddictNode {
+typedef struct dvdictNode {
     char* key;
-    double value;
-    struct ddictNode* next;
-} ddictNode;
+    double_v* value;
+    struct dvdictNode* next;
+} dvdictNode;
 // --------------------------------------------------------------------------------
 
-struct dict_d {
-    ddictNode* keyValues;
+struct dict_dv {
+    dvdictNode* keyValues;
     size_t hash_size;
     size_t len;
     size_t alloc;
 };
 // --------------------------------------------------------------------------------
 
-/**
- * @brief MurmurHash3-inspired hash function for strings
- * 
- * @param key The string key to hash
- * @param seed Optional seed for hash randomization (helps prevent hash flooding)
- * @return size_t The computed hash value
- */
-static size_t hash_function(const char* key, const uint32_t seed) {
-    if (!key) {
-        return 0;
-    }
-
-    // Constants for mixing
-    const uint32_t c1 = 0xcc9e2d51;
-    const uint32_t c2 = 0x1b873593;
-    uint32_t h1 = seed;
-
-    // Process key in 4-byte chunks
-    const unsigned char* data = (const unsigned char*)key;
-    size_t len = strlen(key);
-    const size_t nblocks = len / 4;
-
-    // Body
-    const uint32_t* blocks = (const uint32_t*)(data);
-    for (size_t i = 0; i < nblocks; i++) {
-        uint32_t k1 = blocks[i];
-
-        k1 *= c1;
-        k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
-        k1 *= c2;
-
-        h1 ^= k1;
-        h1 = (h1 << 13) | (h1 >> 19);  // ROTL32(h1, 13)
-        h1 = h1 * 5 + 0xe6546b64;
+dict_dv* init_doublev_dict(void) {
+    // Allocate the dictionary structure
+    dict_dv* dict = calloc(1, sizeof(dict_d));
+    if (!dict) {
+        errno = ENOMEM;
+        fprintf(stderr, "Failed to allocate vector dictionary structure\n");
+        return NULL;
     }
 
-    // Tail
-    const unsigned char* tail = data + nblocks * 4;
-    uint32_t k1 = 0;
-
-    switch (len & 3) {
-        case 3:
-            k1 ^= tail[2] << 16;
-            /* fallthrough */
-        case 2:
-            k1 ^= tail[1] << 8;
-            /* fallthrough */
-        case 1:
-            k1 ^= tail[0];
-            k1 *= c1;
-            k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
-            k1 *= c2;
-            h1 ^= k1;
+    // Allocate initial hash table array
+    dict->keyValues = calloc(hashSize, sizeof(dvdictNode));
+    if (!dict->keyValues) {
+        errno = ENOMEM;
+        fprintf(stderr, "Failed to allocate hash table array\n");
+        free(dict);
+        return NULL;
     }
 
-    // Finalization
-    h1 ^= len;
-    h1 ^= h1 >> 16;
-    h1 *= 0x85ebca6b;
-    h1 ^= h1 >> 13;
-    h1 *= 0xc2b2ae35;
-    h1 ^= h1 >> 16;
+    // Initialize dictionary metadata
+    dict->hash_size = 0;   // No items yet
+    dict->len = 0;         // No occupied buckets
+    dict->alloc = hashSize;
 
-    return (size_t)h1;
+    return dict;
 }
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-/**
- * @brief Resizes the dictionary's hash table
- * 
- * @param dict Pointer to the dictionary
- * @param new_size Desired new size for the hash table
- * @return bool true if resize successful, false otherwise
- */
-static bool resize_dict(dict_d* dict, size_t new_size) {
+static bool resize_dictv(dict_dv* dict, size_t new_size) {
     // Input validation
     if (!dict || new_size < dict->hash_size || new_size == 0) {
         errno = EINVAL;
         return false;
     }
 
-    // Ensure new_size is a power of 2 for better distribution
+    // Ensure new_size is a power of 2 for better hash distribution
     new_size = (size_t)pow(2, ceil(log2(new_size)));
 
     // Use calloc for automatic zero initialization
-    ddictNode* new_table = calloc(new_size, sizeof(ddictNode));
+    dvdictNode* new_table = calloc(new_size, sizeof(dvdictNode));
     if (!new_table) {
         errno = ENOMEM;
         return false;
     }
 
-    // Keep track of old table in case we need to recover
-    ddictNode* old_table = dict->keyValues;
+    // Keep track of old table for cleanup if something fails
+    dvdictNode* old_table = dict->keyValues;
     const size_t old_size = dict->alloc;
     size_t rehashed_count = 0;
 
-    // Rehash existing entries
-    for (size_t i = 0; i < old_size; i++) {
-        ddictNode* current = old_table[i].next;
-        
+    // Rehash all existing entries into the new table
+    for (size_t i = 0; i < old_size; ++i) {
+        dvdictNode* current = old_table[i].next;
         while (current) {
-            ddictNode* next = current->next;  // Save next pointer before modifying node
+            dvdictNode* next = current->next;
 
-            // Calculate new index using enhanced hash function
             size_t new_index = hash_function(current->key, HASH_SEED) % new_size;
 
-            // Insert at the beginning of the new chain
+            // Reinsert into the new hash bucket (head insertion)
             current->next = new_table[new_index].next;
             new_table[new_index].next = current;
-            
+
             rehashed_count++;
             current = next;
         }
     }
 
-    // Verify all entries were rehashed successfully
+    // Validate rehash count matches the number of entries
     if (rehashed_count != dict->hash_size) {
-        // Cleanup and restore old state
-        for (size_t i = 0; i < new_size; i++) {
-            ddictNode* current = new_table[i].next;
+        // Rollback: disconnect moved nodes so they aren't double-freed
+        for (size_t i = 0; i < new_size; ++i) {
+            dvdictNode* current = new_table[i].next;
             while (current) {
-                ddictNode* next = current->next;
+                dvdictNode* next = current->next;
                 current->next = NULL;
                 current = next;
             }
@@ -1058,69 +6588,38 @@ static bool resize_dict(dict_d* dict, size_t new_size) {
         return false;
     }
 
-    // Update the dictionary only after successful rehashing
+    // Replace table on success
     dict->keyValues = new_table;
-    dict->alloc = new_size;
-
-    // Clean up old table (but not the nodes, as they were moved)
-    free(old_table);
-
-    return true;
-}
-// --------------------------------------------------------------------------------
-
-dict_d* init_double_dict(void) {
-    // Allocate the dictionary structure
-    dict_d* dict = calloc(1, sizeof(dict_d));
-    if (!dict) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed to allocate dictionary structure\n");
-        return NULL;
-    }
-
-    // Allocate initial hash table array
-    dict->keyValues = calloc(hashSize, sizeof(ddictNode));
-    if (!dict->keyValues) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed to allocate hash table array\n");
-        free(dict);
-        return NULL;
-    }
-
-    // Initialize dictionary metadata
-    dict->hash_size = 0;   // No items yet
-    dict->len = 0;         // No occupied buckets
-    dict->alloc = hashSize;
+    dict->alloc = new_size;
 
-    return dict;
+    // Free old hash bucket array (nodes were moved, not freed)
+    free(old_table);
+
+    return true;
 }
 // --------------------------------------------------------------------------------
 
-bool insert_double_dict(dict_d* dict, const char* key, double value) {
+bool create_doublev_dict(dict_dv* dict, char* key, size_t size) {
     if (!dict || !key) {
         errno = EINVAL;
         return false;
     }
 
-    // Check load factor and resize if necessary using adaptive growth strategy
+    // Resize if load factor exceeded
     if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
-        size_t new_size;
-        if (dict->alloc < VEC_THRESHOLD) {
-            new_size = dict->alloc * 2;  // Double when small
-        } else {
-            new_size = dict->alloc + VEC_FIXED_AMOUNT;  // Linear growth when large
-        }
-        
-        if (!resize_dict(dict, new_size)) {
-            return false;  // resize_dict sets appropriate errno
+        size_t new_size = (dict->alloc < VEC_THRESHOLD)
+                          ? dict->alloc * 2
+                          : dict->alloc + VEC_FIXED_AMOUNT;
+
+        if (!resize_dictv(dict, new_size)) {
+            return false;
         }
     }
 
-    // Rest of the function remains the same as previous improvement...
     const size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    // Check for existing key
-    for (ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+
+    // Check for key collision
+    for (dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
         if (strcmp(current->key, key) == 0) {
             errno = EEXIST;
             return false;
@@ -1133,13 +6632,22 @@ bool insert_double_dict(dict_d* dict, const char* key, double value) {
         return false;
     }
 
-    ddictNode* new_node = malloc(sizeof(ddictNode));
+    dvdictNode* new_node = malloc(sizeof(dvdictNode));
     if (!new_node) {
         free(new_key);
         errno = ENOMEM;
         return false;
     }
 
+    double_v* value = NULL;
+    value = init_double_vector(size);
+    if (!value) {
+        free(new_key);
+        free(new_node);
+        errno = ENOMEM;
+        return false;
+    }
+
     new_node->key = new_key;
     new_node->value = value;
     new_node->next = dict->keyValues[index].next;
@@ -1154,21 +6662,19 @@ bool insert_double_dict(dict_d* dict, const char* key, double value) {
 }
 // --------------------------------------------------------------------------------
 
-double pop_double_dict(dict_d* dict, const char* key) {
+bool pop_doublev_dict(dict_dv* dict, const char* key) {
     if (!dict || !key) {
         errno = EINVAL;
-        return FLT_MAX;
+        return false;
     }
 
     size_t index = hash_function(key, HASH_SEED) % dict->alloc;
     
-    ddictNode* prev = &dict->keyValues[index];
-    ddictNode* current = prev->next;
+    dvdictNode* prev = &dict->keyValues[index];
+    dvdictNode* current = prev->next;
     
     while (current) {
         if (strcmp(current->key, key) == 0) {
-            // Save value and unlink node
-            double value = current->value;
             prev->next = current->next;
             
             // Update dictionary metadata
@@ -1178,51 +6684,55 @@ double pop_double_dict(dict_d* dict, const char* key) {
             }
             
             // Clean up node memory
+            free_double_vector(current->value);
             free(current->key);
             free(current);
             
-            return value;
+            return true;
         }
         prev = current;
         current = current->next;
     }
 
     errno = ENOENT;  // Set errno when key not found
-    return FLT_MAX;
+    return false;
 }
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-double get_double_dict_value(const dict_d* dict, const char* key) {
+double_v* return_doublev_pointer(dict_dv* dict, const char* key) {
     if (!dict || !key) {
         errno = EINVAL;
-        return FLT_MAX;
+        return NULL;
     }
 
     size_t index = hash_function(key, HASH_SEED) % dict->alloc;
     
-    for (const ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+    for (const dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
         if (strcmp(current->key, key) == 0) {
             return current->value;
         }
     }
 
     errno = ENOENT;  // Set errno when key not found
-    return FLT_MAX;
+    return NULL;
 }
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-void free_double_dict(dict_d* dict) {
+void free_doublev_dict(dict_dv* dict) {
     if (!dict) {
         return;  // Silent return on NULL - common pattern for free functions
     }
 
     // Free all nodes in each bucket
     for (size_t i = 0; i < dict->alloc; i++) {
-        ddictNode* current = dict->keyValues[i].next;
+        dvdictNode* current = dict->keyValues[i].next;
         while (current) {      
-            ddictNode* next = current->next;  // Save next pointer before freeing
+            dvdictNode* next = current->next;
+
+            free_double_vector(current->value);
             free(current->key);
             free(current);
+
             current = next;
         }
     }
@@ -1233,794 +6743,2719 @@ void free_double_dict(dict_d* dict) {
 }
 // -------------------------------------------------------------------------------- 
 
-void _free_double_dict(dict_d** dict_ptr) {
+void _free_doublev_dict(dict_dv** dict_ptr) {
     if (dict_ptr && *dict_ptr) {
-        free_double_dict(*dict_ptr);
+        free_doublev_dict(*dict_ptr);
         *dict_ptr = NULL;  // Prevent use-after-free
     }
 }
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-bool update_double_dict(dict_d* dict, const char* key, double value) {
+bool has_key_doublev_dict(const dict_dv* dict, const char* key) {
     if (!dict || !key) {
         errno = EINVAL;
         return false;
     }
 
     size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    for (ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+
+    for (const dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
         if (strcmp(current->key, key) == 0) {
-            current->value = value;
             return true;
         }
     }
 
-    errno = ENOENT;  // More specific error code for missing key
     return false;
 }
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-size_t double_dict_size(const dict_d* dict) {
-    if (!dict) {
+bool insert_doublev_dict(dict_dv* dict, const char* key, double_v* value) {
+    if (!dict || !key || !value) {
         errno = EINVAL;
-        return SIZE_MAX;
+        return false;
     }
-    return dict->len;
-}
-// --------------------------------------------------------------------------------
 
-size_t double_dict_alloc(const dict_d* dict) {
-    if (!dict) {
-        errno = EINVAL;
-        return SIZE_MAX;
+    // Only allow insertion of DYNAMIC vectors
+    if (value->alloc_type != DYNAMIC) {
+        errno = EPERM;  // Operation not permitted
+        return false;
     }
-    return dict->alloc;
-}
-// --------------------------------------------------------------------------------
 
-size_t double_dict_hash_size(const dict_d* dict) {
-    if (!dict) {
-        errno = EINVAL;
-        return SIZE_MAX;
-    }
-    return dict->hash_size;
-}
-// -------------------------------------------------------------------------------- 
+    // Resize if load factor exceeded
+    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
+        size_t new_size = (dict->alloc < VEC_THRESHOLD)
+                          ? dict->alloc * 2
+                          : dict->alloc + VEC_FIXED_AMOUNT;
 
-bool has_key_double_dict(const dict_d* dict, const char* key) {
-    if (!dict || !key) {
-        errno = EINVAL;
-        return false;
+        if (!resize_dictv(dict, new_size)) {
+            return false;
+        }
     }
 
     size_t index = hash_function(key, HASH_SEED) % dict->alloc;
 
-    for (const ddictNode* current = dict->keyValues[index].next; current; current = current->next) {
+    // Check for existing key
+    for (dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
         if (strcmp(current->key, key) == 0) {
-            return true;
+            errno = EEXIST;
+            return false;
         }
     }
 
-    return false;
-}
-// -------------------------------------------------------------------------------- 
-
-dict_d* copy_double_dict(const dict_d* dict) {
-    if (!dict) {
-        errno = EINVAL;
-        return NULL;
-    }
-
-    // Create new dictionary with same capacity
-    dict_d* new_dict = malloc(sizeof(dict_d));
-    if (!new_dict) {
+    // Allocate new key string
+    char* new_key = strdup(key);
+    if (!new_key) {
         errno = ENOMEM;
-        return NULL;
+        return false;
     }
 
-    new_dict->keyValues = calloc(dict->alloc, sizeof(ddictNode));
-    if (!new_dict->keyValues) {
-        free(new_dict);
+    // Allocate node
+    dvdictNode* new_node = malloc(sizeof(dvdictNode));
+    if (!new_node) {
+        free(new_key);
         errno = ENOMEM;
-        return NULL;
+        return false;
     }
 
-    // Copy metadata
-    new_dict->alloc = dict->alloc;
-    new_dict->hash_size = 0;  // Will be incremented during insertion
-    new_dict->len = 0;        // Will be incremented during insertion
+    new_node->key = new_key;
+    new_node->value = value;
+    new_node->next = dict->keyValues[index].next;
+    dict->keyValues[index].next = new_node;
 
-    // Copy all entries
-    for (size_t i = 0; i < dict->alloc; i++) {
-        ddictNode* current = dict->keyValues[i].next;
-        while (current) {
-            // Insert will handle incrementing hash_size and len
-            if (!insert_double_dict(new_dict, current->key, current->value)) {
-                free_double_dict(new_dict);  // Clean up on failure
-                return NULL;
-            }
-            current = current->next;
-        }
+    dict->hash_size++;
+    if (new_node->next == NULL) {
+        dict->len++;
     }
 
-    return new_dict;
+    return true;
 }
 // -------------------------------------------------------------------------------- 
 
-bool clear_double_dict(dict_d* dict) {
+size_t double_dictv_size(const dict_dv* dict) {
     if (!dict) {
         errno = EINVAL;
-        return false;
+        return SIZE_MAX;
     }
+    return dict->len;
+}
+// --------------------------------------------------------------------------------
 
-    // Free all nodes in each bucket
-    for (size_t i = 0; i < dict->alloc; i++) {
-        ddictNode* current = dict->keyValues[i].next;
-        while (current) {
-            ddictNode* next = current->next;
-            free(current->key);
-            free(current);
-            current = next;
-        }
-        dict->keyValues[i].next = NULL;  // Reset bucket head
+size_t double_dictv_alloc(const dict_dv* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return SIZE_MAX;
     }
-
-    // Reset dictionary metadata
-    dict->hash_size = 0;
-    dict->len = 0;
-
-    return true;
+    return dict->alloc;
 }
 // -------------------------------------------------------------------------------- 
 
-string_v* get_keys_double_dict(const dict_d* dict) {
+size_t double_dictv_hash_size(const dict_dv* dict) {
     if (!dict) {
         errno = EINVAL;
-        return NULL;
+        return SIZE_MAX;
     }
-    string_v* vec = init_str_vector(dict->hash_size);
-    if (!vec) {
-        errno = ENOMEM;
+    return dict->hash_size;
+}
+// -------------------------------------------------------------------------------- 
+
+dict_dv* copy_doublev_dict(const dict_dv* original) {
+    if (!original) {
+        errno = EINVAL;
         return NULL;
     }
-    for (size_t i = 0; i < dict->alloc; i++) {
-        for (ddictNode* current = dict->keyValues[i].next; current; current = current->next) {
-            if (!push_back_str_vector(vec, current->key)) {
-                free_str_vector(vec);
-                errno = ENOMEM;
+
+    dict_dv* copy = init_doublev_dict();
+    if (!copy) {
+        return NULL;  // errno already set
+    }
+
+    for (size_t i = 0; i < original->alloc; ++i) {
+        dvdictNode* current = original->keyValues[i].next;
+        while (current) {
+            // if (current->value->alloc_type != DYNAMIC) {
+            //     free_doublev_dict(copy);
+            //     errno = EPERM;
+            //     return NULL;
+            // }
+
+            double_v* vec_copy = copy_double_vector(current->value);
+            if (!vec_copy) {
+                free_doublev_dict(copy);
+                return NULL;
+            }
+
+            if (!insert_doublev_dict(copy, current->key, vec_copy)) {
+                free_double_vector(vec_copy);
+                free_doublev_dict(copy);
                 return NULL;
             }
+
+            current = current->next;
         }
     }
-    return vec;
+
+    return copy;
 }
 // -------------------------------------------------------------------------------- 
 
-double_v* get_values_double_dict(const dict_d* dict) {
-    if (!dict) {
+dict_dv* merge_doublev_dict(const dict_dv* dict1, const dict_dv* dict2, bool overwrite) {
+    if (!dict1 || !dict2) {
         errno = EINVAL;
         return NULL;
     }
-    double_v* vec = init_double_vector(dict->hash_size);
-    if (!vec) {
-        errno = ENOMEM;
+
+    // Start by deep copying dict1
+    dict_dv* merged = copy_doublev_dict(dict1);
+    if (!merged) {
         return NULL;
     }
-    // Iterate through all buckets
-    for (size_t i = 0; i < dict->alloc; i++) {
-        for (ddictNode* current = dict->keyValues[i].next; current; current = current->next) {
-            if (!push_back_double_vector(vec, current->value)) {
-                free_double_vector(vec);
-                errno = ENOMEM;
+
+    // Now process dict2 entries
+    for (size_t i = 0; i < dict2->alloc; ++i) {
+        dvdictNode* current = dict2->keyValues[i].next;
+        while (current) {
+            if (!current->key || !current->value || current->value->alloc_type != DYNAMIC) {
+                free_doublev_dict(merged);
+                errno = EPERM;
+                return NULL;
+            }
+
+            bool exists = has_key_doublev_dict(merged, current->key);
+            if (exists && !overwrite) {
+                current = current->next;
+                continue;
+            }
+
+            double_v* vec_copy = copy_double_vector(current->value);
+            if (!vec_copy) {
+                free_doublev_dict(merged);
+                return NULL; // errno set by copy_double_vector
+            }
+
+            if (exists) {
+                pop_doublev_dict(merged, current->key);
+            }
+
+            if (!insert_doublev_dict(merged, current->key, vec_copy)) {
+                free_double_vector(vec_copy);
+                free_doublev_dict(merged);
                 return NULL;
             }
+
+            current = current->next;
         }
     }
-    return vec;
+
+    return merged;
 }
 // -------------------------------------------------------------------------------- 
 
-dict_d* merge_double_dict(const dict_d* dict1, const dict_d* dict2, bool overwrite) {
-    if (!dict1 || !dict2) {
+void clear_doublev_dict(dict_dv* dict) {
+    if (!dict) {
         errno = EINVAL;
-        return NULL;
+        return;
     }
 
-    // Create new dictionary with capacity for all items
-    //size_t initial_size = dict1->hash_size + dict2->hash_size;
-    dict_d* merged = init_double_dict();
-    if (!merged) {
-        return NULL;  // errno set by init_double_dict
-    }
+    for (size_t i = 0; i < dict->alloc; ++i) {
+        dvdictNode* current = dict->keyValues[i].next;
+        dict->keyValues[i].next = NULL;
 
-    // First, copy all entries from dict1
-    for (size_t i = 0; i < dict1->alloc; i++) {
-        for (ddictNode* current = dict1->keyValues[i].next; current; current = current->next) {
-            if (!insert_double_dict(merged, current->key, current->value)) {
-                free_double_dict(merged);
-                return NULL;
-            }
-        }
-    }
+        while (current) {
+            dvdictNode* next = current->next;
 
-    // Then handle dict2 entries
-    for (size_t i = 0; i < dict2->alloc; i++) {
-        for (ddictNode* current = dict2->keyValues[i].next; current; current = current->next) {
-            double existing_value;
-            // Check if key exists in merged dictionary
-            if ((existing_value = get_double_dict_value(merged, current->key)) != FLT_MAX) {
-                if (overwrite) {
-                    // Update existing value if overwrite is true
-                    if (!update_double_dict(merged, current->key, current->value)) {
-                        free_double_dict(merged);
-                        return NULL;
-                    }
-                }
-                // If overwrite is false, keep original value
-            } else {
-                // Key doesn't exist, insert new entry
-                if (!insert_double_dict(merged, current->key, current->value)) {
-                    free_double_dict(merged);
-                    return NULL;
+            if (current->value) {
+                if (current->value->alloc_type == STATIC) {
+                    free(current->value);
+                } else {
+                    free_double_vector(current->value);
                 }
             }
+
+            free(current->key);
+            free(current);
+            current = next;
         }
     }
 
-    return merged;
+    dict->hash_size = 0;
+    dict->len = 0;
 }
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-bool foreach_double_dict(const dict_d* dict, dict_iterator iter, void* user_data) {
+bool foreach_doublev_dict(const dict_dv* dict, dict_dv_iterator iter, void* user_data) {
     if (!dict || !iter) {
         errno = EINVAL;
         return false;
     }
 
-    for (size_t i = 0; i < dict->alloc; i++) {
-        for (ddictNode* current = dict->keyValues[i].next; current; current = current->next) {
+    for (size_t i = 0; i < dict->alloc; ++i) {
+        dvdictNode* current = dict->keyValues[i].next;
+        while (current) {
             iter(current->key, current->value, user_data);
+            current = current->next;
         }
     }
 
     return true;
 }
-// ================================================================================ 
-// ================================================================================ 
-
-typedef struct dvdictNode {
-    char* key;
-    double_v* value;
-    struct dvdictNode* next;
-} dvdictNode;
-// --------------------------------------------------------------------------------
-
-struct dict_dv {
-    dvdictNode* keyValues;
-    size_t hash_size;
-    size_t len;
-    size_t alloc;
-};
-// --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------- 
 
-dict_dv* init_doublev_dict(void) {
-    // Allocate the dictionary structure
-    dict_dv* dict = calloc(1, sizeof(dict_d));
+string_v* get_keys_doublev_dict(const dict_dv* dict) {
     if (!dict) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed to allocate vector dictionary structure\n");
+        errno = EINVAL;
         return NULL;
     }
 
-    // Allocate initial hash table array
-    dict->keyValues = calloc(hashSize, sizeof(dvdictNode));
-    if (!dict->keyValues) {
+    string_v* vec = init_str_vector(dict->hash_size);
+    if (!vec) {
         errno = ENOMEM;
-        fprintf(stderr, "Failed to allocate hash table array\n");
-        free(dict);
         return NULL;
     }
 
-    // Initialize dictionary metadata
-    dict->hash_size = 0;   // No items yet
-    dict->len = 0;         // No occupied buckets
-    dict->alloc = hashSize;
+    for (size_t i = 0; i < dict->alloc; ++i) {
+        for (dvdictNode* current = dict->keyValues[i].next; current; current = current->next) {
+            if (!push_back_str_vector(vec, current->key)) {
+                free_str_vector(vec);
+                errno = ENOMEM;
+                return NULL;
+            }
+        }
+    }
 
-    return dict;
+    return vec;
 }
-// -------------------------------------------------------------------------------- 
+// ================================================================================
+// ================================================================================
+// BINARY FILES
+//
+// Layout, every integer little endian and every block a multiple of 
+// BIN_ALIGN bytes so that each payload starts on a 64 byte boundary and a 
+// file can be mapped and read in place:
+//
+//   file header    BIN_ALIGN bytes: magic, version, flags, column count
+//   per column     BIN_ALIGN byte header: length, key length, column flags,
+//                  checksum; the key padded to BIN_ALIGN; the doubles padded 
+//                  to BIN_ALIGN
+//
+// The checksum is an xxHash64 style hash of the 64 bit patterns of the 
+// doubles, so it does not depend on the byte order of the host.  From version
+// 2 on it also covers the length, key length and flags of the column header 
+// and the key; version 1 files hash the doubles alone.  Payloads are
+// written and read with single large fwrite and fread calls straight from and
+// into the vector buffers, which the C library passes to write and read 
+// without copying.
+
+#define BIN_ALIGN 64
+#define BIN_VERSION 2
+#define BIN_FLAG_CHECKSUM 1u
+#define BIN_COL_SORTED 1u
+#define BIN_BUFFER_SIZE (1 << 20)  // stdio buffer for the small header blocks
+#define BIN_SWAP_BLOCK 4096        // doubles byte swapped per write on big endian hosts
+
+static const unsigned char BIN_MAGIC[8] = {'C', 'D', 'O', 'U', 'B', 'L', 'E', 0x1a};
+
+struct double_writer_d {
+    FILE* fp;
+    uint64_t columns;
+    bool checksum;
+    bool failed;
+};
+// --------------------------------------------------------------------------------
 
-static bool resize_dictv(dict_dv* dict, size_t new_size) {
-    // Input validation
-    if (!dict || new_size < dict->hash_size || new_size == 0) {
-        errno = EINVAL;
-        return false;
-    }
+struct double_reader_d {
+    FILE* fp;
+    uint32_t version;
+    uint64_t columns;
+    uint64_t next;
+    uint64_t remaining;  // Bytes left in the file, UINT64_MAX if unknown
+    bool checksum;
+    char* key;
+};
+// --------------------------------------------------------------------------------
 
-    // Ensure new_size is a power of 2 for better hash distribution
-    new_size = (size_t)pow(2, ceil(log2(new_size)));
+static bool _host_little_endian(void) {
+    const uint16_t one = 1;
+    return *(const unsigned char*)&one == 1;
+}
+// --------------------------------------------------------------------------------
 
-    // Use calloc for automatic zero initialization
-    dvdictNode* new_table = calloc(new_size, sizeof(dvdictNode));
-    if (!new_table) {
-        errno = ENOMEM;
-        return false;
-    }
+static void _put_le(unsigned char* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+// --------------------------------------------------------------------------------
 
-    // Keep track of old table for cleanup if something fails
-    dvdictNode* old_table = dict->keyValues;
-    const size_t old_size = dict->alloc;
-    size_t rehashed_count = 0;
+static uint64_t _get_le(const unsigned char* p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+// --------------------------------------------------------------------------------
 
-    // Rehash all existing entries into the new table
-    for (size_t i = 0; i < old_size; ++i) {
-        dvdictNode* current = old_table[i].next;
-        while (current) {
-            dvdictNode* next = current->next;
+static inline uint64_t _byte_swap64(uint64_t v) {
+    v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+}
+// --------------------------------------------------------------------------------
 
-            size_t new_index = hash_function(current->key, HASH_SEED) % new_size;
+static inline uint64_t _rotl64(uint64_t v, int r) {
+    return (v << r) | (v >> (64 - r));
+}
+// --------------------------------------------------------------------------------
 
-            // Reinsert into the new hash bucket (head insertion)
-            current->next = new_table[new_index].next;
-            new_table[new_index].next = current;
+static const uint64_t HASH_P1 = 0x9E3779B185EBCA87ull;
+static const uint64_t HASH_P2 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t HASH_P4 = 0x85EBCA77C2B2AE63ull;
 
-            rehashed_count++;
-            current = next;
-        }
-    }
+static inline uint64_t _hash_round(uint64_t acc, uint64_t w) {
+    return _rotl64(acc + w * HASH_P2, 31) * HASH_P1;
+}
+// --------------------------------------------------------------------------------
 
-    // Validate rehash count matches the number of entries
-    if (rehashed_count != dict->hash_size) {
-        // Rollback: disconnect moved nodes so they aren't double-freed
-        for (size_t i = 0; i < new_size; ++i) {
-            dvdictNode* current = new_table[i].next;
-            while (current) {
-                dvdictNode* next = current->next;
-                current->next = NULL;
-                current = next;
-            }
-        }
-        free(new_table);
-        errno = EAGAIN;
-        return false;
-    }
+/**
+ * @brief Hashes the bit patterns of n doubles with four independent lanes,
+ *        which keeps the multipliers busy and runs at several GB/s
+ */
+static uint64_t _bin_checksum(const double* x, size_t n) {
+    uint64_t v[4] = {HASH_P1 + HASH_P2, HASH_P2, 0, 0 - HASH_P1};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint64_t w[4];
+        memcpy(w, x + i, sizeof(w));
+        for (size_t k = 0; k < 4; ++k) v[k] = _hash_round(v[k], w[k]);
+    }
+    uint64_t h = _rotl64(v[0], 1) + _rotl64(v[1], 7) + _rotl64(v[2], 12) + _rotl64(v[3], 18);
+    for (size_t k = 0; k < 4; ++k) h = (h ^ _hash_round(0, v[k])) * HASH_P1 + HASH_P4;
+    h += (uint64_t)n * sizeof(double);
+    for (; i < n; ++i) {
+        uint64_t w;
+        memcpy(&w, x + i, sizeof(w));
+        h = _rotl64(h ^ _hash_round(0, w), 27) * HASH_P1 + HASH_P4;
+    }
+    h ^= h >> 33;
+    h *= HASH_P2;
+    h ^= h >> 29;
+    h *= HASH_P1;
+    return h ^ (h >> 32);
+}
+// --------------------------------------------------------------------------------
 
-    // Replace table on success
-    dict->keyValues = new_table;
-    dict->alloc = new_size;
+/**
+ * @brief Extends the checksum of a payload with the first 16 bytes of its 
+ *        column header and its key, so that a damaged length, flag or key is
+ *        caught as well
+ */
+static uint64_t _bin_column_checksum(uint64_t h, const unsigned char* hdr, 
+                                     const char* key, size_t key_len) {
+    for (size_t i = 0; i < 16; i += 8)
+        h = _rotl64(h ^ _hash_round(0, _get_le(hdr + i, 8)), 27) * HASH_P1 + HASH_P4;
+    for (size_t i = 0; i < key_len; i += 8) {
+        size_t m = key_len - i < 8 ? key_len - i : 8;
+        uint64_t w = 0;
+        for (size_t k = 0; k < m; ++k) w |= (uint64_t)(unsigned char)key[i + k] << (8 * k);
+        h = _rotl64(h ^ _hash_round(0, w), 27) * HASH_P1 + HASH_P4;
+    }
+    h ^= h >> 33;
+    h *= HASH_P2;
+    return h ^ (h >> 29);
+}
+// --------------------------------------------------------------------------------
 
-    // Free old hash bucket array (nodes were moved, not freed)
-    free(old_table);
+static size_t _bin_pad(size_t bytes) {
+    return (BIN_ALIGN - bytes % BIN_ALIGN) % BIN_ALIGN;
+}
+// --------------------------------------------------------------------------------
 
+/**
+ * @brief Writes n doubles in little endian order
+ */
+static bool _bin_write_doubles(FILE* fp, const double* x, size_t n) {
+    if (_host_little_endian())
+        return fwrite(x, sizeof(double), n, fp) == n;
+    uint64_t block[BIN_SWAP_BLOCK];
+    for (size_t i = 0; i < n; i += BIN_SWAP_BLOCK) {
+        size_t m = n - i < BIN_SWAP_BLOCK ? n - i : BIN_SWAP_BLOCK;
+        memcpy(block, x + i, m * sizeof(double));
+        for (size_t k = 0; k < m; ++k) block[k] = _byte_swap64(block[k]);
+        if (fwrite(block, sizeof(double), m, fp) != m) return false;
+    }
     return true;
 }
 // --------------------------------------------------------------------------------
 
-bool create_doublev_dict(dict_dv* dict, char* key, size_t size) {
-    if (!dict || !key) {
-        errno = EINVAL;
-        return false;
+/**
+ * @brief Reads n little endian doubles into x
+ */
+static bool _bin_read_doubles(FILE* fp, double* x, size_t n) {
+    if (fread(x, sizeof(double), n, fp) != n) return false;
+    if (!_host_little_endian()) {
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t w;
+            memcpy(&w, x + i, sizeof(w));
+            w = _byte_swap64(w);
+            memcpy(x + i, &w, sizeof(w));
+        }
     }
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    // Resize if load factor exceeded
-    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
-        size_t new_size = (dict->alloc < VEC_THRESHOLD)
-                          ? dict->alloc * 2
-                          : dict->alloc + VEC_FIXED_AMOUNT;
+static bool _bin_write_pad(FILE* fp, size_t bytes) {
+    static const unsigned char zeros[BIN_ALIGN] = {0};
+    size_t pad = _bin_pad(bytes);
+    return pad == 0 || fwrite(zeros, 1, pad, fp) == pad;
+}
+// --------------------------------------------------------------------------------
 
-        if (!resize_dictv(dict, new_size)) {
-            return false;
-        }
-    }
+static bool _bin_skip_pad(FILE* fp, size_t bytes) {
+    unsigned char scratch[BIN_ALIGN];
+    size_t pad = _bin_pad(bytes);
+    return pad == 0 || fread(scratch, 1, pad, fp) == pad;
+}
+// --------------------------------------------------------------------------------
 
-    const size_t index = hash_function(key, HASH_SEED) % dict->alloc;
+/**
+ * @brief Returns the size of an open file in bytes, or UINT64_MAX if it 
+ *        cannot be found, e.g. for a pipe
+ *
+ * Only ISO C calls are used, so the reader needs no POSIX feature macros.
+ */
+static uint64_t _bin_file_size(FILE* fp) {
+    long pos = ftell(fp);
+    if (pos < 0 || fseek(fp, 0, SEEK_END) != 0) return UINT64_MAX;
+    long end = ftell(fp);
+    if (fseek(fp, pos, SEEK_SET) != 0 || end < 0) return UINT64_MAX;
+    return (uint64_t)end;
+}
+// --------------------------------------------------------------------------------
 
-    // Check for key collision
-    for (dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            errno = EEXIST;
-            return false;
-        }
-    }
+static void _bin_file_header(unsigned char* hdr, bool checksum, uint64_t columns) {
+    memset(hdr, 0, BIN_ALIGN);
+    memcpy(hdr, BIN_MAGIC, sizeof(BIN_MAGIC));
+    _put_le(hdr + 8, BIN_VERSION, 4);
+    _put_le(hdr + 12, checksum ? BIN_FLAG_CHECKSUM : 0u, 4);
+    _put_le(hdr + 16, columns, 8);
+}
+// --------------------------------------------------------------------------------
 
-    char* new_key = strdup(key);
-    if (!new_key) {
+double_writer_d* open_double_writer(const char* path, bool checksum) {
+    if (!path) {
+        errno = EINVAL;
+        return NULL;
+    }
+    double_writer_d* writer = calloc(1, sizeof(double_writer_d));
+    if (!writer) {
         errno = ENOMEM;
-        return false;
+        return NULL;
+    }
+    writer->fp = fopen(path, "wb");
+    if (!writer->fp) {
+        int err = errno;
+        free(writer);
+        errno = err;
+        return NULL;
     }
+    setvbuf(writer->fp, NULL, _IOFBF, BIN_BUFFER_SIZE);
+    writer->checksum = checksum;
+
+    // The column count is written again by close_double_writer
+    unsigned char hdr[BIN_ALIGN];
+    _bin_file_header(hdr, checksum, 0);
+    if (fwrite(hdr, 1, BIN_ALIGN, writer->fp) != BIN_ALIGN) {
+        int err = errno;
+        fclose(writer->fp);
+        free(writer);
+        errno = err;
+        return NULL;
+    }
+    return writer;
+}
+// --------------------------------------------------------------------------------
 
-    dvdictNode* new_node = malloc(sizeof(dvdictNode));
-    if (!new_node) {
-        free(new_key);
-        errno = ENOMEM;
+bool write_double_column(double_writer_d* writer, const char* key, const double_v* vec) {
+    if (!writer || !vec || (!vec->data && vec->len > 0)) {
+        errno = EINVAL;
         return false;
     }
-
-    double_v* value = NULL;
-    value = init_double_vector(size);
-    if (!value) {
-        free(new_key);
-        free(new_node);
-        errno = ENOMEM;
+    if (writer->failed) {
+        errno = EIO;
         return false;
     }
-
-    new_node->key = new_key;
-    new_node->value = value;
-    new_node->next = dict->keyValues[index].next;
-    dict->keyValues[index].next = new_node;
-
-    dict->hash_size++;
-    if (new_node->next == NULL) {
-        dict->len++;
+    if (!key) key = "";
+    size_t key_len = strlen(key);
+    if (key_len > UINT32_MAX) {
+        errno = EINVAL;
+        return false;
     }
 
+    unsigned char hdr[BIN_ALIGN] = {0};
+    _put_le(hdr, vec->len, 8);
+    _put_le(hdr + 8, key_len, 4);
+    _put_le(hdr + 12, vec->sorted ? BIN_COL_SORTED : 0u, 4);
+    if (writer->checksum) {
+        uint64_t sum = _bin_checksum(vec->data, vec->len);
+        _put_le(hdr + 16, _bin_column_checksum(sum, hdr, key, key_len), 8);
+    }
+
+    FILE* fp = writer->fp;
+    bool ok = fwrite(hdr, 1, BIN_ALIGN, fp) == BIN_ALIGN &&
+              fwrite(key, 1, key_len, fp) == key_len &&
+              _bin_write_pad(fp, key_len) &&
+              _bin_write_doubles(fp, vec->data, vec->len) &&
+              _bin_write_pad(fp, vec->len * sizeof(double));
+    if (!ok) {
+        // A partly written column cannot be taken back
+        writer->failed = true;
+        if (errno == 0) errno = EIO;
+        return false;
+    }
+    writer->columns++;
     return true;
 }
 // --------------------------------------------------------------------------------
 
-bool pop_doublev_dict(dict_dv* dict, const char* key) {
-    if (!dict || !key) {
+bool close_double_writer(double_writer_d* writer) {
+    if (!writer) {
         errno = EINVAL;
         return false;
     }
-
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    dvdictNode* prev = &dict->keyValues[index];
-    dvdictNode* current = prev->next;
-    
-    while (current) {
-        if (strcmp(current->key, key) == 0) {
-            prev->next = current->next;
-            
-            // Update dictionary metadata
-            dict->hash_size--;
-            if (!prev->next) {  // If bucket is now empty
-                dict->len--;
-            }
-            
-            // Clean up node memory
-            free_double_vector(current->value);
-            free(current->key);
-            free(current);
-            
-            return true;
-        }
-        prev = current;
-        current = current->next;
-    }
-
-    errno = ENOENT;  // Set errno when key not found
-    return false;
+    bool ok = !writer->failed;
+    if (ok) {
+        unsigned char hdr[BIN_ALIGN];
+        _bin_file_header(hdr, writer->checksum, writer->columns);
+        ok = fflush(writer->fp) == 0 && fseek(writer->fp, 0, SEEK_SET) == 0 &&
+             fwrite(hdr, 1, BIN_ALIGN, writer->fp) == BIN_ALIGN;
+    }
+    int err = errno;
+    if (fclose(writer->fp) != 0) {
+        err = errno;
+        ok = false;
+    }
+    free(writer);
+    if (!ok) errno = err != 0 ? err : EIO;
+    return ok;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-double_v* return_doublev_pointer(dict_dv* dict, const char* key) {
-    if (!dict || !key) {
+double_reader_d* open_double_reader(const char* path) {
+    if (!path) {
         errno = EINVAL;
         return NULL;
     }
-
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    for (const dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            return current->value;
-        }
+    double_reader_d* reader = calloc(1, sizeof(double_reader_d));
+    if (!reader) {
+        errno = ENOMEM;
+        return NULL;
     }
-
-    errno = ENOENT;  // Set errno when key not found
-    return NULL;
-}
-// -------------------------------------------------------------------------------- 
-
-void free_doublev_dict(dict_dv* dict) {
-    if (!dict) {
-        return;  // Silent return on NULL - common pattern for free functions
+    reader->fp = fopen(path, "rb");
+    if (!reader->fp) {
+        int err = errno;
+        free(reader);
+        errno = err;
+        return NULL;
     }
-
-    // Free all nodes in each bucket
-    for (size_t i = 0; i < dict->alloc; i++) {
-        dvdictNode* current = dict->keyValues[i].next;
-        while (current) {      
-            dvdictNode* next = current->next;
-
-            free_double_vector(current->value);
-            free(current->key);
-            free(current);
-
-            current = next;
-        }
+    setvbuf(reader->fp, NULL, _IOFBF, BIN_BUFFER_SIZE);
+    reader->remaining = _bin_file_size(reader->fp);
+
+    unsigned char hdr[BIN_ALIGN];
+    int err = 0;
+    if (fread(hdr, 1, BIN_ALIGN, reader->fp) != BIN_ALIGN || 
+        memcmp(hdr, BIN_MAGIC, sizeof(BIN_MAGIC)) != 0) {
+        err = EBADMSG;
+    } else if (_get_le(hdr + 8, 4) > BIN_VERSION) {
+        err = ENOTSUP;
+    }
+    if (err != 0) {
+        fclose(reader->fp);
+        free(reader);
+        errno = err;
+        return NULL;
     }
-
-    // Free the hash table and dictionary struct
-    free(dict->keyValues);
-    free(dict);
+    reader->version = (uint32_t)_get_le(hdr + 8, 4);
+    reader->checksum = (_get_le(hdr + 12, 4) & BIN_FLAG_CHECKSUM) != 0;
+    reader->columns = _get_le(hdr + 16, 8);
+    if (reader->remaining != UINT64_MAX) reader->remaining -= BIN_ALIGN;
+    return reader;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-void _free_doublev_dict(dict_dv** dict_ptr) {
-    if (dict_ptr && *dict_ptr) {
-        free_doublev_dict(*dict_ptr);
-        *dict_ptr = NULL;  // Prevent use-after-free
+size_t double_reader_columns(const double_reader_d* reader) {
+    if (!reader) {
+        errno = EINVAL;
+        return LONG_MAX;
     }
+    return (size_t)reader->columns;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-bool has_key_doublev_dict(const dict_dv* dict, const char* key) {
-    if (!dict || !key) {
+const char* double_reader_key(const double_reader_d* reader) {
+    if (!reader || !reader->key) {
         errno = EINVAL;
-        return false;
-    }
-
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-
-    for (const dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            return true;
-        }
+        return NULL;
     }
-
-    return false;
+    return reader->key;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-bool insert_doublev_dict(dict_dv* dict, const char* key, double_v* value) {
-    if (!dict || !key || !value) {
+double_v* read_double_column(double_reader_d* reader) {
+    if (!reader) {
         errno = EINVAL;
-        return false;
+        return NULL;
     }
-
-    // Only allow insertion of DYNAMIC vectors
-    if (value->alloc_type != DYNAMIC) {
-        errno = EPERM;  // Operation not permitted
-        return false;
+    if (reader->next == reader->columns) {
+        errno = ENODATA;
+        return NULL;
     }
-
-    // Resize if load factor exceeded
-    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
-        size_t new_size = (dict->alloc < VEC_THRESHOLD)
-                          ? dict->alloc * 2
-                          : dict->alloc + VEC_FIXED_AMOUNT;
-
-        if (!resize_dictv(dict, new_size)) {
-            return false;
-        }
+    FILE* fp = reader->fp;
+    unsigned char hdr[BIN_ALIGN];
+    if (reader->remaining < BIN_ALIGN || fread(hdr, 1, BIN_ALIGN, fp) != BIN_ALIGN) {
+        errno = EBADMSG;
+        return NULL;
     }
-
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-
-    // Check for existing key
-    for (dvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            errno = EEXIST;
-            return false;
-        }
+    uint64_t left = reader->remaining - BIN_ALIGN;
+    uint64_t len = _get_le(hdr, 8);
+    size_t key_len = (size_t)_get_le(hdr + 8, 4);
+    bool sorted = (_get_le(hdr + 12, 4) & BIN_COL_SORTED) != 0;
+    uint64_t checksum = _get_le(hdr + 16, 8);
+
+    // The lengths come from the file, so a column that cannot fit in the rest
+    // of it is rejected before anything is allocated for it
+    uint64_t key_bytes = (uint64_t)key_len + _bin_pad(key_len);
+    if (len > SIZE_MAX / sizeof(double) || key_bytes > left || 
+        len > (left - key_bytes) / sizeof(double)) {
+        errno = EBADMSG;
+        return NULL;
+    }
+    size_t data_bytes = (size_t)len * sizeof(double);
+    uint64_t column_bytes = key_bytes + data_bytes + _bin_pad(data_bytes);
+    if (column_bytes > left) {
+        errno = EBADMSG;
+        return NULL;
     }
 
-    // Allocate new key string
-    char* new_key = strdup(key);
-    if (!new_key) {
+    char* key = malloc(key_len + 1);
+    if (!key) {
         errno = ENOMEM;
-        return false;
+        return NULL;
+    }
+    if (fread(key, 1, key_len, fp) != key_len || !_bin_skip_pad(fp, key_len)) {
+        free(key);
+        errno = EBADMSG;
+        return NULL;
     }
+    key[key_len] = '\0';
 
-    // Allocate node
-    dvdictNode* new_node = malloc(sizeof(dvdictNode));
-    if (!new_node) {
-        free(new_key);
-        errno = ENOMEM;
-        return false;
+    double_v* vec = init_double_vector(len > 0 ? (size_t)len : 1);
+    if (!vec) {
+        free(key);
+        return NULL;
+    }
+    int err = 0;
+    if (!_bin_read_doubles(fp, vec->data, (size_t)len) || 
+        !_bin_skip_pad(fp, data_bytes)) {
+        err = EBADMSG;
+    } else if (reader->checksum) {
+        uint64_t sum = _bin_checksum(vec->data, (size_t)len);
+        if (reader->version >= 2) sum = _bin_column_checksum(sum, hdr, key, key_len);
+        if (sum != checksum) err = EBADMSG;
+    }
+    if (err != 0) {
+        free(key);
+        free_double_vector(vec);
+        errno = err;
+        return NULL;
     }
+    vec->len = (size_t)len;
+    // The flag comes from the file, so it is only kept if the data agrees
+    vec->sorted = sorted && _is_ascending(vec->data, vec->len);
+    free(reader->key);
+    reader->key = key;
+    reader->next++;
+    if (reader->remaining != UINT64_MAX) reader->remaining = left - column_bytes;
+    return vec;
+}
+// --------------------------------------------------------------------------------
 
-    new_node->key = new_key;
-    new_node->value = value;
-    new_node->next = dict->keyValues[index].next;
-    dict->keyValues[index].next = new_node;
+void close_double_reader(double_reader_d* reader) {
+    if (!reader) {
+        errno = EINVAL;
+        return;
+    }
+    fclose(reader->fp);
+    free(reader->key);
+    free(reader);
+}
+// --------------------------------------------------------------------------------
 
-    dict->hash_size++;
-    if (new_node->next == NULL) {
-        dict->len++;
+bool save_double_vector(const double_v* vec, const char* path, bool checksum) {
+    if (!vec || !path) {
+        errno = EINVAL;
+        return false;
     }
+    double_writer_d* writer = open_double_writer(path, checksum);
+    if (!writer) return false;
+    bool ok = write_double_column(writer, NULL, vec);
+    int err = errno;
+    if (!close_double_writer(writer)) return false;
+    if (!ok) errno = err;
+    return ok;
+}
+// --------------------------------------------------------------------------------
 
-    return true;
+double_v* load_double_vector(const char* path) {
+    double_reader_d* reader = open_double_reader(path);
+    if (!reader) return NULL;
+    double_v* vec = NULL;
+    if (reader->columns != 1) errno = EBADMSG;
+    else vec = read_double_column(reader);
+    close_double_reader(reader);
+    return vec;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-size_t double_dictv_size(const dict_dv* dict) {
-    if (!dict) {
-        errno = EINVAL;
-        return SIZE_MAX;
+typedef struct {
+    double_writer_d* writer;
+    bool ok;
+    int err;
+} dv_save_ctx;
+// --------------------------------------------------------------------------------
+
+static void _save_column(const char* key, const double_v* value, void* user_data) {
+    dv_save_ctx* ctx = user_data;
+    if (!ctx->ok) return;
+    if (!write_double_column(ctx->writer, key, value)) {
+        ctx->ok = false;
+        ctx->err = errno;
     }
-    return dict->len;
 }
 // --------------------------------------------------------------------------------
 
-size_t double_dictv_alloc(const dict_dv* dict) {
-    if (!dict) {
+bool save_doublev_dict(const dict_dv* dict, const char* path, bool checksum) {
+    if (!dict || !path) {
         errno = EINVAL;
-        return SIZE_MAX;
+        return false;
     }
-    return dict->alloc;
+    dv_save_ctx ctx = {open_double_writer(path, checksum), true, 0};
+    if (!ctx.writer) return false;
+    foreach_doublev_dict(dict, _save_column, &ctx);
+    if (!close_double_writer(ctx.writer)) return false;
+    if (!ctx.ok) errno = ctx.err;
+    return ctx.ok;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-size_t double_dictv_hash_size(const dict_dv* dict) {
+dict_dv* load_doublev_dict(const char* path) {
+    double_reader_d* reader = open_double_reader(path);
+    if (!reader) return NULL;
+    dict_dv* dict = init_doublev_dict();
     if (!dict) {
-        errno = EINVAL;
-        return SIZE_MAX;
+        close_double_reader(reader);
+        return NULL;
     }
-    return dict->hash_size;
+    while (reader->next < reader->columns) {
+        double_v* vec = read_double_column(reader);
+        if (!vec || !insert_doublev_dict(dict, reader->key, vec)) {
+            int err = errno;
+            if (vec) free_double_vector(vec);
+            free_doublev_dict(dict);
+            close_double_reader(reader);
+            errno = err;
+            return NULL;
+        }
+    }
+    close_double_reader(reader);
+    return dict;
 }
-// -------------------------------------------------------------------------------- 
+// ================================================================================
+// ================================================================================
+// TEXT PARSING
+//
+// Numbers are converted straight from the text, without token copies.  Up to
+// 19 significant digits are gathered into a 64 bit integer w with a decimal
+// exponent q.  When w and 10^q are both exact doubles, one multiply or divide
+// is correctly rounded (Clinger's fast path).  Otherwise w * 10^q is rounded
+// from the product of w with a 128 bit truncated power of five, the method of
+// Eisel and Lemire, which settles the nearest double for every such w and q.
+// Only decimals with more than 19 nonzero significant digits, whose dropped
+// digits can move the result, are handed to strtod.
+
+#define PARSE_MIN_POW10 -342    // w * 10^q rounds to zero below this
+#define PARSE_MAX_POW10 308     // w * 10^q overflows above this
+#define PARSE_MAX_DIGITS 19     // significant digits that fit a uint64_t
+#define PARSE_TOKEN_BUFFER 128  // tokens copied to the stack for strtod
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+static const bool PARSE_EXACT_DOUBLES = true;
+#else
+static const bool PARSE_EXACT_DOUBLES = false;  // x87 rounds twice
+#endif
 
-dict_dv* copy_doublev_dict(const dict_dv* original) {
-    if (!original) {
-        errno = EINVAL;
-        return NULL;
+/**
+ * @brief 5^q for q in [PARSE_MIN_POW10, PARSE_MAX_POW10], normalized so the
+ *        high bit of the first word is set and truncated to 128 bits
+ */
+static const uint64_t POW5_128[PARSE_MAX_POW10 - PARSE_MIN_POW10 + 1][2] = {
+    {0xeef453d6923bd65aull, 0x113faa2906a13b3full},
+    {0x9558b4661b6565f8ull, 0x4ac7ca59a424c507ull},
+    {0xbaaee17fa23ebf76ull, 0x5d79bcf00d2df649ull},
+    {0xe95a99df8ace6f53ull, 0xf4d82c2c107973dcull},
+    {0x91d8a02bb6c10594ull, 0x79071b9b8a4be869ull},
+    {0xb64ec836a47146f9ull, 0x9748e2826cdee284ull},
+    {0xe3e27a444d8d98b7ull, 0xfd1b1b2308169b25ull},
+    {0x8e6d8c6ab0787f72ull, 0xfe30f0f5e50e20f7ull},
+    {0xb208ef855c969f4full, 0xbdbd2d335e51a935ull},
+    {0xde8b2b66b3bc4723ull, 0xad2c788035e61382ull},
+    {0x8b16fb203055ac76ull, 0x4c3bcb5021afcc31ull},
+    {0xaddcb9e83c6b1793ull, 0xdf4abe242a1bbf3dull},
+    {0xd953e8624b85dd78ull, 0xd71d6dad34a2af0dull},
+    {0x87d4713d6f33aa6bull, 0x8672648c40e5ad68ull},
+    {0xa9c98d8ccb009506ull, 0x680efdaf511f18c2ull},
+    {0xd43bf0effdc0ba48ull, 0x0212bd1b2566def2ull},
+    {0x84a57695fe98746dull, 0x014bb630f7604b57ull},
+    {0xa5ced43b7e3e9188ull, 0x419ea3bd35385e2dull},
+    {0xcf42894a5dce35eaull, 0x52064cac828675b9ull},
+    {0x818995ce7aa0e1b2ull, 0x7343efebd1940993ull},
+    {0xa1ebfb4219491a1full, 0x1014ebe6c5f90bf8ull},
+    {0xca66fa129f9b60a6ull, 0xd41a26e077774ef6ull},
+    {0xfd00b897478238d0ull, 0x8920b098955522b4ull},
+    {0x9e20735e8cb16382ull, 0x55b46e5f5d5535b0ull},
+    {0xc5a890362fddbc62ull, 0xeb2189f734aa831dull},
+    {0xf712b443bbd52b7bull, 0xa5e9ec7501d523e4ull},
+    {0x9a6bb0aa55653b2dull, 0x47b233c92125366eull},
+    {0xc1069cd4eabe89f8ull, 0x999ec0bb696e840aull},
+    {0xf148440a256e2c76ull, 0xc00670ea43ca250dull},
+    {0x96cd2a865764dbcaull, 0x380406926a5e5728ull},
+    {0xbc807527ed3e12bcull, 0xc605083704f5ecf2ull},
+    {0xeba09271e88d976bull, 0xf7864a44c633682eull},
+    {0x93445b8731587ea3ull, 0x7ab3ee6afbe0211dull},
+    {0xb8157268fdae9e4cull, 0x5960ea05bad82964ull},
+    {0xe61acf033d1a45dfull, 0x6fb92487298e33bdull},
+    {0x8fd0c16206306babull, 0xa5d3b6d479f8e056ull},
+    {0xb3c4f1ba87bc8696ull, 0x8f48a4899877186cull},
+    {0xe0b62e2929aba83cull, 0x331acdabfe94de87ull},
+    {0x8c71dcd9ba0b4925ull, 0x9ff0c08b7f1d0b14ull},
+    {0xaf8e5410288e1b6full, 0x07ecf0ae5ee44dd9ull},
+    {0xdb71e91432b1a24aull, 0xc9e82cd9f69d6150ull},
+    {0x892731ac9faf056eull, 0xbe311c083a225cd2ull},
+    {0xab70fe17c79ac6caull, 0x6dbd630a48aaf406ull},
+    {0xd64d3d9db981787dull, 0x092cbbccdad5b108ull},
+    {0x85f0468293f0eb4eull, 0x25bbf56008c58ea5ull},
+    {0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull},
+    {0xd1476e2c07286faaull, 0x1af5af660db4aee1ull},
+    {0x82cca4db847945caull, 0x50d98d9fc890ed4dull},
+    {0xa37fce126597973cull, 0xe50ff107bab528a0ull},
+    {0xcc5fc196fefd7d0cull, 0x1e53ed49a96272c8ull},
+    {0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7aull},
+    {0x9faacf3df73609b1ull, 0x77b191618c54e9acull},
+    {0xc795830d75038c1dull, 0xd59df5b9ef6a2417ull},
+    {0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1dull},
+    {0x9becce62836ac577ull, 0x4ee367f9430aec32ull},
+    {0xc2e801fb244576d5ull, 0x229c41f793cda73full},
+    {0xf3a20279ed56d48aull, 0x6b43527578c1110full},
+    {0x9845418c345644d6ull, 0x830a13896b78aaa9ull},
+    {0xbe5691ef416bd60cull, 0x23cc986bc656d553ull},
+    {0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa8ull},
+    {0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6a9ull},
+    {0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc53ull},
+    {0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff68ull},
+    {0x91376c36d99995beull, 0x23100809b9c21fa1ull},
+    {0xb58547448ffffb2dull, 0xabd40a0c2832a78aull},
+    {0xe2e69915b3fff9f9ull, 0x16c90c8f323f516cull},
+    {0x8dd01fad907ffc3bull, 0xae3da7d97f6792e3ull},
+    {0xb1442798f49ffb4aull, 0x99cd11cfdf41779cull},
+    {0xdd95317f31c7fa1dull, 0x40405643d711d583ull},
+    {0x8a7d3eef7f1cfc52ull, 0x482835ea666b2572ull},
+    {0xad1c8eab5ee43b66ull, 0xda3243650005eecfull},
+    {0xd863b256369d4a40ull, 0x90bed43e40076a82ull},
+    {0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull},
+    {0xa90de3535aaae202ull, 0x711515d0a205cb36ull},
+    {0xd3515c2831559a83ull, 0x0d5a5b44ca873e03ull},
+    {0x8412d9991ed58091ull, 0xe858790afe9486c2ull},
+    {0xa5178fff668ae0b6ull, 0x626e974dbe39a872ull},
+    {0xce5d73ff402d98e3ull, 0xfb0a3d212dc8128full},
+    {0x80fa687f881c7f8eull, 0x7ce66634bc9d0b99ull},
+    {0xa139029f6a239f72ull, 0x1c1fffc1ebc44e80ull},
+    {0xc987434744ac874eull, 0xa327ffb266b56220ull},
+    {0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa8ull},
+    {0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4a9ull},
+    {0xc4ce17b399107c22ull, 0xcb550fb4384d21d3ull},
+    {0xf6019da07f549b2bull, 0x7e2a53a146606a48ull},
+    {0x99c102844f94e0fbull, 0x2eda7444cbfc426dull},
+    {0xc0314325637a1939ull, 0xfa911155fefb5308ull},
+    {0xf03d93eebc589f88ull, 0x793555ab7eba27caull},
+    {0x96267c7535b763b5ull, 0x4bc1558b2f3458deull},
+    {0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f16ull},
+    {0xea9c227723ee8bcbull, 0x465e15a979c1cadcull},
+    {0x92a1958a7675175full, 0x0bfacd89ec191ec9ull},
+    {0xb749faed14125d36ull, 0xcef980ec671f667bull},
+    {0xe51c79a85916f484ull, 0x82b7e12780e7401aull},
+    {0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908810ull},
+    {0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa15ull},
+    {0xdfbdcece67006ac9ull, 0x67a791e093e1d49aull},
+    {0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e0ull},
+    {0xaecc49914078536dull, 0x58fae9f773886e18ull},
+    {0xda7f5bf590966848ull, 0xaf39a475506a899eull},
+    {0x888f99797a5e012dull, 0x6d8406c952429603ull},
+    {0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b83ull},
+    {0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a64ull},
+    {0x855c3be0a17fcd26ull, 0x5cf2eea09a55067full},
+    {0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481eull},
+    {0xd0601d8efc57b08bull, 0xf13b94daf124da26ull},
+    {0x823c12795db6ce57ull, 0x76c53d08d6b70858ull},
+    {0xa2cb1717b52481edull, 0x54768c4b0c64ca6eull},
+    {0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd09ull},
+    {0xfe5d54150b090b02ull, 0xd3f93b35435d7c4cull},
+    {0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6dafull},
+    {0xc6b8e9b0709f109aull, 0x359ab6419ca1091bull},
+    {0xf867241c8cc6d4c0ull, 0xc30163d203c94b62ull},
+    {0x9b407691d7fc44f8ull, 0x79e0de63425dcf1dull},
+    {0xc21094364dfb5636ull, 0x985915fc12f542e4ull},
+    {0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939dull},
+    {0x979cf3ca6cec5b5aull, 0xa705992ceecf9c42ull},
+    {0xbd8430bd08277231ull, 0x50c6ff782a838353ull},
+    {0xece53cec4a314ebdull, 0xa4f8bf5635246428ull},
+    {0x940f4613ae5ed136ull, 0x871b7795e136be99ull},
+    {0xb913179899f68584ull, 0x28e2557b59846e3full},
+    {0xe757dd7ec07426e5ull, 0x331aeada2fe589cfull},
+    {0x9096ea6f3848984full, 0x3ff0d2c85def7621ull},
+    {0xb4bca50b065abe63ull, 0x0fed077a756b53a9ull},
+    {0xe1ebce4dc7f16dfbull, 0xd3e8495912c62894ull},
+    {0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95cull},
+    {0xb080392cc4349decull, 0xbd8d794d96aacfb3ull},
+    {0xdca04777f541c567ull, 0xecf0d7a0fc5583a0ull},
+    {0x89e42caaf9491b60ull, 0xf41686c49db57244ull},
+    {0xac5d37d5b79b6239ull, 0x311c2875c522ced5ull},
+    {0xd77485cb25823ac7ull, 0x7d633293366b828bull},
+    {0x86a8d39ef77164bcull, 0xae5dff9c02033197ull},
+    {0xa8530886b54dbdebull, 0xd9f57f830283fdfcull},
+    {0xd267caa862a12d66ull, 0xd072df63c324fd7bull},
+    {0x8380dea93da4bc60ull, 0x4247cb9e59f71e6dull},
+    {0xa46116538d0deb78ull, 0x52d9be85f074e608ull},
+    {0xcd795be870516656ull, 0x67902e276c921f8bull},
+    {0x806bd9714632dff6ull, 0x00ba1cd8a3db53b6ull},
+    {0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a4ull},
+    {0xc8a883c0fdaf7df0ull, 0x6122cd128006b2cdull},
+    {0xfad2a4b13d1b5d6cull, 0x796b805720085f81ull},
+    {0x9cc3a6eec6311a63ull, 0xcbe3303674053bb0ull},
+    {0xc3f490aa77bd60fcull, 0xbedbfc4411068a9cull},
+    {0xf4f1b4d515acb93bull, 0xee92fb5515482d44ull},
+    {0x991711052d8bf3c5ull, 0x751bdd152d4d1c4aull},
+    {0xbf5cd54678eef0b6ull, 0xd262d45a78a0635dull},
+    {0xef340a98172aace4ull, 0x86fb897116c87c34ull},
+    {0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da0ull},
+    {0xbae0a846d2195712ull, 0x8974836059cca109ull},
+    {0xe998d258869facd7ull, 0x2bd1a438703fc94bull},
+    {0x91ff83775423cc06ull, 0x7b6306a34627ddcfull},
+    {0xb67f6455292cbf08ull, 0x1a3bc84c17b1d542ull},
+    {0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a93ull},
+    {0x8e938662882af53eull, 0x547eb47b7282ee9cull},
+    {0xb23867fb2a35b28dull, 0xe99e619a4f23aa43ull},
+    {0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d4ull},
+    {0x8b3c113c38f9f37eull, 0xde83bc408dd3dd04ull},
+    {0xae0b158b4738705eull, 0x9624ab50b148d445ull},
+    {0xd98ddaee19068c76ull, 0x3badd624dd9b0957ull},
+    {0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d6ull},
+    {0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4cull},
+    {0xd47487cc8470652bull, 0x7647c3200069671full},
+    {0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e073ull},
+    {0xa5fb0a17c777cf09ull, 0xf468107100525890ull},
+    {0xcf79cc9db955c2ccull, 0x7182148d4066eeb4ull},
+    {0x81ac1fe293d599bfull, 0xc6f14cd848405530ull},
+    {0xa21727db38cb002full, 0xb8ada00e5a506a7cull},
+    {0xca9cf1d206fdc03bull, 0xa6d90811f0e4851cull},
+    {0xfd442e4688bd304aull, 0x908f4a166d1da663ull},
+    {0x9e4a9cec15763e2eull, 0x9a598e4e043287feull},
+    {0xc5dd44271ad3cdbaull, 0x40eff1e1853f29fdull},
+    {0xf7549530e188c128ull, 0xd12bee59e68ef47cull},
+    {0x9a94dd3e8cf578b9ull, 0x82bb74f8301958ceull},
+    {0xc13a148e3032d6e7ull, 0xe36a52363c1faf01ull},
+    {0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac1ull},
+    {0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0b9ull},
+    {0xbcb2b812db11a5deull, 0x7415d448f6b6f0e7ull},
+    {0xebdf661791d60f56ull, 0x111b495b3464ad21ull},
+    {0x936b9fcebb25c995ull, 0xcab10dd900beec34ull},
+    {0xb84687c269ef3bfbull, 0x3d5d514f40eea742ull},
+    {0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull},
+    {0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72abull},
+    {0xb3f4e093db73a093ull, 0x59ed216765690f56ull},
+    {0xe0f218b8d25088b8ull, 0x306869c13ec3532cull},
+    {0x8c974f7383725573ull, 0x1e414218c73a13fbull},
+    {0xafbd2350644eeacfull, 0xe5d1929ef90898faull},
+    {0xdbac6c247d62a583ull, 0xdf45f746b74abf39ull},
+    {0x894bc396ce5da772ull, 0x6b8bba8c328eb783ull},
+    {0xab9eb47c81f5114full, 0x066ea92f3f326564ull},
+    {0xd686619ba27255a2ull, 0xc80a537b0efefebdull},
+    {0x8613fd0145877585ull, 0xbd06742ce95f5f36ull},
+    {0xa798fc4196e952e7ull, 0x2c48113823b73704ull},
+    {0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c5ull},
+    {0x82ef85133de648c4ull, 0x9a984d73dbe722fbull},
+    {0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbaull},
+    {0xcc963fee10b7d1b3ull, 0x318df905079926a8ull},
+    {0xffbbcfe994e5c61full, 0xfdf17746497f7052ull},
+    {0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa633ull},
+    {0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc0ull},
+    {0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b0ull},
+    {0x9c1661a651213e2dull, 0x06bea10ca65c084eull},
+    {0xc31bfa0fe5698db8ull, 0x486e494fcff30a62ull},
+    {0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfaull},
+    {0x986ddb5c6b3a76b7ull, 0xf89629465a75e01cull},
+    {0xbe89523386091465ull, 0xf6bbb397f1135823ull},
+    {0xee2ba6c0678b597full, 0x746aa07ded582e2cull},
+    {0x94db483840b717efull, 0xa8c2a44eb4571cdcull},
+    {0xba121a4650e4ddebull, 0x92f34d62616ce413ull},
+    {0xe896a0d7e51e1566ull, 0x77b020baf9c81d17ull},
+    {0x915e2486ef32cd60ull, 0x0ace1474dc1d122eull},
+    {0xb5b5ada8aaff80b8ull, 0x0d819992132456baull},
+    {0xe3231912d5bf60e6ull, 0x10e1fff697ed6c69ull},
+    {0x8df5efabc5979c8full, 0xca8d3ffa1ef463c1ull},
+    {0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb2ull},
+    {0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdeull},
+    {0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96bull},
+    {0xad4ab7112eb3929dull, 0x86c16c98d2c953c6ull},
+    {0xd89d64d57a607744ull, 0xe871c7bf077ba8b7ull},
+    {0x87625f056c7c4a8bull, 0x11471cd764ad4972ull},
+    {0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bcfull},
+    {0xd389b47879823479ull, 0x4aff1d108d4ec2c3ull},
+    {0x843610cb4bf160cbull, 0xcedf722a585139baull},
+    {0xa54394fe1eedb8feull, 0xc2974eb4ee658828ull},
+    {0xce947a3da6a9273eull, 0x733d226229feea32ull},
+    {0x811ccc668829b887ull, 0x0806357d5a3f525full},
+    {0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f7ull},
+    {0xc9bcff6034c13052ull, 0xfc89b393dd02f0b5ull},
+    {0xfc2c3f3841f17c67ull, 0xbbac2078d443ace2ull},
+    {0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0dull},
+    {0xc5029163f384a931ull, 0x0a9e795e65d4df11ull},
+    {0xf64335bcf065d37dull, 0x4d4617b5ff4a16d5ull},
+    {0x99ea0196163fa42eull, 0x504bced1bf8e4e45ull},
+    {0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d6ull},
+    {0xf07da27a82c37088ull, 0x5d767327bb4e5a4cull},
+    {0x964e858c91ba2655ull, 0x3a6a07f8d510f86full},
+    {0xbbe226efb628afeaull, 0x890489f70a55368bull},
+    {0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842eull},
+    {0x92c8ae6b464fc96full, 0x3b0b8bc90012929dull},
+    {0xb77ada0617e3bbcbull, 0x09ce6ebb40173744ull},
+    {0xe55990879ddcaabdull, 0xcc420a6a101d0515ull},
+    {0x8f57fa54c2a9eab6ull, 0x9fa946824a12232dull},
+    {0xb32df8e9f3546564ull, 0x47939822dc96abf9ull},
+    {0xdff9772470297ebdull, 0x59787e2b93bc56f7ull},
+    {0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65aull},
+    {0xaefae51477a06b03ull, 0xede622920b6b23f1ull},
+    {0xdab99e59958885c4ull, 0xe95fab368e45ecedull},
+    {0x88b402f7fd75539bull, 0x11dbcb0218ebb414ull},
+    {0xaae103b5fcd2a881ull, 0xd652bdc29f26a119ull},
+    {0xd59944a37c0752a2ull, 0x4be76d3346f0495full},
+    {0x857fcae62d8493a5ull, 0x6f70a4400c562ddbull},
+    {0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb952ull},
+    {0xd097ad07a71f26b2ull, 0x7e2000a41346a7a7ull},
+    {0x825ecc24c873782full, 0x8ed400668c0c28c8ull},
+    {0xa2f67f2dfa90563bull, 0x728900802f0f32faull},
+    {0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffb9ull},
+    {0xfea126b7d78186bcull, 0xe2f610c84987bfa8ull},
+    {0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7c9ull},
+    {0xc6ede63fa05d3143ull, 0x91503d1c79720dbbull},
+    {0xf8a95fcf88747d94ull, 0x75a44c6397ce912aull},
+    {0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abaull},
+    {0xc24452da229b021bull, 0xfbe85badce996168ull},
+    {0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull},
+    {0x97c560ba6b0919a5ull, 0xdccd879fc967d41aull},
+    {0xbdb6b8e905cb600full, 0x5400e987bbc1c920ull},
+    {0xed246723473e3813ull, 0x290123e9aab23b68ull},
+    {0x9436c0760c86e30bull, 0xf9a0b6720aaf6521ull},
+    {0xb94470938fa89bceull, 0xf808e40e8d5b3e69ull},
+    {0xe7958cb87392c2c2ull, 0xb60b1d1230b20e04ull},
+    {0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c2ull},
+    {0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af3ull},
+    {0xe2280b6c20dd5232ull, 0x25c6da63c38de1b0ull},
+    {0x8d590723948a535full, 0x579c487e5a38ad0eull},
+    {0xb0af48ec79ace837ull, 0x2d835a9df0c6d851ull},
+    {0xdcdb1b2798182244ull, 0xf8e431456cf88e65ull},
+    {0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b58ffull},
+    {0xac8b2d36eed2dac5ull, 0xe272467e3d222f3full},
+    {0xd7adf884aa879177ull, 0x5b0ed81dcc6abb0full},
+    {0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull},
+    {0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull},
+    {0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull},
+    {0x83a3eeeef9153e89ull, 0x1953cf68300424acull},
+    {0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull},
+    {0xcdb02555653131b6ull, 0x3792f412cb06794dull},
+    {0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull},
+    {0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull},
+    {0xc8de047564d20a8bull, 0xf245825a5a445275ull},
+    {0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull},
+    {0x9ced737bb6c4183dull, 0x55464dd69685606bull},
+    {0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull},
+    {0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull},
+    {0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull},
+    {0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull},
+    {0xef73d256a5c0f77cull, 0x963e66858f6d4440ull},
+    {0x95a8637627989aadull, 0xdde7001379a44aa8ull},
+    {0xbb127c53b17ec159ull, 0x5560c018580d5d52ull},
+    {0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull},
+    {0x9226712162ab070dull, 0xcab3961304ca70e8ull},
+    {0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull},
+    {0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull},
+    {0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull},
+    {0xb267ed1940f1c61cull, 0x55f038b237591ed3ull},
+    {0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull},
+    {0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull},
+    {0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull},
+    {0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull},
+    {0x881cea14545c7575ull, 0x7e50d64177da2e54ull},
+    {0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull},
+    {0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull},
+    {0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull},
+    {0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull},
+    {0xcfb11ead453994baull, 0x67de18eda5814af2ull},
+    {0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull},
+    {0xa2425ff75e14fc31ull, 0xa1258379a94d028dull},
+    {0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull},
+    {0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull},
+    {0x9e74d1b791e07e48ull, 0x775ea264cf55347eull},
+    {0xc612062576589ddaull, 0x95364afe032a819eull},
+    {0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull},
+    {0x9abe14cd44753b52ull, 0xc4926a9672793543ull},
+    {0xc16d9a0095928a27ull, 0x75b7053c0f178294ull},
+    {0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull},
+    {0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull},
+    {0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull},
+    {0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull},
+    {0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull},
+    {0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull},
+    {0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull},
+    {0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull},
+    {0xb424dc35095cd80full, 0x538484c19ef38c95ull},
+    {0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull},
+    {0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull},
+    {0xafebff0bcb24aafeull, 0xf78f69a51539d749ull},
+    {0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull},
+    {0x89705f4136b4a597ull, 0x31680a88f8953031ull},
+    {0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull},
+    {0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull},
+    {0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull},
+    {0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull},
+    {0xd1b71758e219652bull, 0xd3c36113404ea4a9ull},
+    {0x83126e978d4fdf3bull, 0x645a1cac083126eaull},
+    {0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull},
+    {0xccccccccccccccccull, 0xcccccccccccccccdull},
+    {0x8000000000000000ull, 0x0000000000000000ull},
+    {0xa000000000000000ull, 0x0000000000000000ull},
+    {0xc800000000000000ull, 0x0000000000000000ull},
+    {0xfa00000000000000ull, 0x0000000000000000ull},
+    {0x9c40000000000000ull, 0x0000000000000000ull},
+    {0xc350000000000000ull, 0x0000000000000000ull},
+    {0xf424000000000000ull, 0x0000000000000000ull},
+    {0x9896800000000000ull, 0x0000000000000000ull},
+    {0xbebc200000000000ull, 0x0000000000000000ull},
+    {0xee6b280000000000ull, 0x0000000000000000ull},
+    {0x9502f90000000000ull, 0x0000000000000000ull},
+    {0xba43b74000000000ull, 0x0000000000000000ull},
+    {0xe8d4a51000000000ull, 0x0000000000000000ull},
+    {0x9184e72a00000000ull, 0x0000000000000000ull},
+    {0xb5e620f480000000ull, 0x0000000000000000ull},
+    {0xe35fa931a0000000ull, 0x0000000000000000ull},
+    {0x8e1bc9bf04000000ull, 0x0000000000000000ull},
+    {0xb1a2bc2ec5000000ull, 0x0000000000000000ull},
+    {0xde0b6b3a76400000ull, 0x0000000000000000ull},
+    {0x8ac7230489e80000ull, 0x0000000000000000ull},
+    {0xad78ebc5ac620000ull, 0x0000000000000000ull},
+    {0xd8d726b7177a8000ull, 0x0000000000000000ull},
+    {0x878678326eac9000ull, 0x0000000000000000ull},
+    {0xa968163f0a57b400ull, 0x0000000000000000ull},
+    {0xd3c21bcecceda100ull, 0x0000000000000000ull},
+    {0x84595161401484a0ull, 0x0000000000000000ull},
+    {0xa56fa5b99019a5c8ull, 0x0000000000000000ull},
+    {0xcecb8f27f4200f3aull, 0x0000000000000000ull},
+    {0x813f3978f8940984ull, 0x4000000000000000ull},
+    {0xa18f07d736b90be5ull, 0x5000000000000000ull},
+    {0xc9f2c9cd04674edeull, 0xa400000000000000ull},
+    {0xfc6f7c4045812296ull, 0x4d00000000000000ull},
+    {0x9dc5ada82b70b59dull, 0xf020000000000000ull},
+    {0xc5371912364ce305ull, 0x6c28000000000000ull},
+    {0xf684df56c3e01bc6ull, 0xc732000000000000ull},
+    {0x9a130b963a6c115cull, 0x3c7f400000000000ull},
+    {0xc097ce7bc90715b3ull, 0x4b9f100000000000ull},
+    {0xf0bdc21abb48db20ull, 0x1e86d40000000000ull},
+    {0x96769950b50d88f4ull, 0x1314448000000000ull},
+    {0xbc143fa4e250eb31ull, 0x17d955a000000000ull},
+    {0xeb194f8e1ae525fdull, 0x5dcfab0800000000ull},
+    {0x92efd1b8d0cf37beull, 0x5aa1cae500000000ull},
+    {0xb7abc627050305adull, 0xf14a3d9e40000000ull},
+    {0xe596b7b0c643c719ull, 0x6d9ccd05d0000000ull},
+    {0x8f7e32ce7bea5c6full, 0xe4820023a2000000ull},
+    {0xb35dbf821ae4f38bull, 0xdda2802c8a800000ull},
+    {0xe0352f62a19e306eull, 0xd50b2037ad200000ull},
+    {0x8c213d9da502de45ull, 0x4526f422cc340000ull},
+    {0xaf298d050e4395d6ull, 0x9670b12b7f410000ull},
+    {0xdaf3f04651d47b4cull, 0x3c0cdd765f114000ull},
+    {0x88d8762bf324cd0full, 0xa5880a69fb6ac800ull},
+    {0xab0e93b6efee0053ull, 0x8eea0d047a457a00ull},
+    {0xd5d238a4abe98068ull, 0x72a4904598d6d880ull},
+    {0x85a36366eb71f041ull, 0x47a6da2b7f864750ull},
+    {0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull},
+    {0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6dull},
+    {0x82818f1281ed449full, 0xbff8f10e7a8921a4ull},
+    {0xa321f2d7226895c7ull, 0xaff72d52192b6a0dull},
+    {0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764490ull},
+    {0xfee50b7025c36a08ull, 0x02f236d04753d5b4ull},
+    {0x9f4f2726179a2245ull, 0x01d762422c946590ull},
+    {0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef5ull},
+    {0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb2ull},
+    {0x9b934c3b330c8577ull, 0x63cc55f49f88eb2full},
+    {0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fbull},
+    {0xf316271c7fc3908aull, 0x8bef464e3945ef7aull},
+    {0x97edd871cfda3a56ull, 0x97758bf0e3cbb5acull},
+    {0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea317ull},
+    {0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bddull},
+    {0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6aull},
+    {0xb975d6b6ee39e436ull, 0xb3e2fd538e122b44ull},
+    {0xe7d34c64a9c85d44ull, 0x60dbbca87196b616ull},
+    {0x90e40fbeea1d3a4aull, 0xbc8955e946fe31cdull},
+    {0xb51d13aea4a488ddull, 0x6babab6398bdbe41ull},
+    {0xe264589a4dcdab14ull, 0xc696963c7eed2dd1ull},
+    {0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca2ull},
+    {0xb0de65388cc8ada8ull, 0x3b25a55f43294bcbull},
+    {0xdd15fe86affad912ull, 0x49ef0eb713f39ebeull},
+    {0x8a2dbf142dfcc7abull, 0x6e3569326c784337ull},
+    {0xacb92ed9397bf996ull, 0x49c2c37f07965404ull},
+    {0xd7e77a8f87daf7fbull, 0xdc33745ec97be906ull},
+    {0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull},
+    {0xa8acd7c0222311bcull, 0xc40832ea0d68ce0cull},
+    {0xd2d80db02aabd62bull, 0xf50a3fa490c30190ull},
+    {0x83c7088e1aab65dbull, 0x792667c6da79e0faull},
+    {0xa4b8cab1a1563f52ull, 0x577001b891185938ull},
+    {0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f86ull},
+    {0x80b05e5ac60b6178ull, 0x544f8158315b05b4ull},
+    {0xa0dc75f1778e39d6ull, 0x696361ae3db1c721ull},
+    {0xc913936dd571c84cull, 0x03bc3a19cd1e38e9ull},
+    {0xfb5878494ace3a5full, 0x04ab48a04065c723ull},
+    {0x9d174b2dcec0e47bull, 0x62eb0d64283f9c76ull},
+    {0xc45d1df942711d9aull, 0x3ba5d0bd324f8394ull},
+    {0xf5746577930d6500ull, 0xca8f44ec7ee36479ull},
+    {0x9968bf6abbe85f20ull, 0x7e998b13cf4e1ecbull},
+    {0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67eull},
+    {0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101eull},
+    {0x95d04aee3b80ece5ull, 0xbba1f1d158724a12ull},
+    {0xbb445da9ca61281full, 0x2a8a6e45ae8edc97ull},
+    {0xea1575143cf97226ull, 0xf52d09d71a3293bdull},
+    {0x924d692ca61be758ull, 0x593c2626705f9c56ull},
+    {0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836cull},
+    {0xe498f455c38b997aull, 0x0b6dfb9c0f956447ull},
+    {0x8edf98b59a373fecull, 0x4724bd4189bd5eacull},
+    {0xb2977ee300c50fe7ull, 0x58edec91ec2cb657ull},
+    {0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3edull},
+    {0x8b865b215899f46cull, 0xbd79e0d20082ee74ull},
+    {0xae67f1e9aec07187ull, 0xecd8590680a3aa11ull},
+    {0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull},
+    {0x884134fe908658b2ull, 0x3109058d147fdcddull},
+    {0xaa51823e34a7eedeull, 0xbd4b46f0599fd415ull},
+    {0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91aull},
+    {0x850fadc09923329eull, 0x03e2cf6bc604ddb0ull},
+    {0xa6539930bf6bff45ull, 0x84db8346b786151cull},
+    {0xcfe87f7cef46ff16ull, 0xe612641865679a63ull},
+    {0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07eull},
+    {0xa26da3999aef7749ull, 0xe3be5e330f38f09dull},
+    {0xcb090c8001ab551cull, 0x5cadf5bfd3072cc5ull},
+    {0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f6ull},
+    {0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afaull},
+    {0xc646d63501a1511dull, 0xb281e1fd541501b8ull},
+    {0xf7d88bc24209a565ull, 0x1f225a7ca91a4226ull},
+    {0x9ae757596946075full, 0x3375788de9b06958ull},
+    {0xc1a12d2fc3978937ull, 0x0052d6b1641c83aeull},
+    {0xf209787bb47d6b84ull, 0xc0678c5dbd23a49aull},
+    {0x9745eb4d50ce6332ull, 0xf840b7ba963646e0ull},
+    {0xbd176620a501fbffull, 0xb650e5a93bc3d898ull},
+    {0xec5d3fa8ce427affull, 0xa3e51f138ab4cebeull},
+    {0x93ba47c980e98cdfull, 0xc66f336c36b10137ull},
+    {0xb8a8d9bbe123f017ull, 0xb80b0047445d4184ull},
+    {0xe6d3102ad96cec1dull, 0xa60dc059157491e5ull},
+    {0x9043ea1ac7e41392ull, 0x87c89837ad68db2full},
+    {0xb454e4a179dd1877ull, 0x29babe4598c311fbull},
+    {0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67aull},
+    {0x8ce2529e2734bb1dull, 0x1899e4a65f58660cull},
+    {0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full},
+    {0xdc21a1171d42645dull, 0x76707543f4fa1f73ull},
+    {0x899504ae72497ebaull, 0x6a06494a791c53a8ull},
+    {0xabfa45da0edbde69ull, 0x0487db9d17636892ull},
+    {0xd6f8d7509292d603ull, 0x45a9d2845d3c42b6ull},
+    {0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b2ull},
+    {0xa7f26836f282b732ull, 0x8e6cac7768d7141eull},
+    {0xd1ef0244af2364ffull, 0x3207d795430cd926ull},
+    {0x8335616aed761f1full, 0x7f44e6bd49e807b8ull},
+    {0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a6ull},
+    {0xcd036837130890a1ull, 0x36dba887c37a8c0full},
+    {0x802221226be55a64ull, 0xc2494954da2c9789ull},
+    {0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6cull},
+    {0xc83553c5c8965d3dull, 0x6f92829494e5acc7ull},
+    {0xfa42a8b73abbf48cull, 0xcb772339ba1f17f9ull},
+    {0x9c69a97284b578d7ull, 0xff2a760414536efbull},
+    {0xc38413cf25e2d70dull, 0xfef5138519684abaull},
+    {0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d69ull},
+    {0x98bf2f79d5993802ull, 0xef2f773ffbd97a61ull},
+    {0xbeeefb584aff8603ull, 0xaafb550ffacfd8faull},
+    {0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf38ull},
+    {0x952ab45cfa97a0b2ull, 0xdd945a747bf26183ull},
+    {0xba756174393d88dfull, 0x94f971119aeef9e4ull},
+    {0xe912b9d1478ceb17ull, 0x7a37cd5601aab85dull},
+    {0x91abb422ccb812eeull, 0xac62e055c10ab33aull},
+    {0xb616a12b7fe617aaull, 0x577b986b314d6009ull},
+    {0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80bull},
+    {0x8e41ade9fbebc27dull, 0x14588f13be847307ull},
+    {0xb1d219647ae6b31cull, 0x596eb2d8ae258fc8ull},
+    {0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bbull},
+    {0x8aec23d680043beeull, 0x25de7bb9480d5854ull},
+    {0xada72ccc20054ae9ull, 0xaf561aa79a10ae6aull},
+    {0xd910f7ff28069da4ull, 0x1b2ba1518094da04ull},
+    {0x87aa9aff79042286ull, 0x90fb44d2f05d0842ull},
+    {0xa99541bf57452b28ull, 0x353a1607ac744a53ull},
+    {0xd3fa922f2d1675f2ull, 0x42889b8997915ce8ull},
+    {0x847c9b5d7c2e09b7ull, 0x69956135febada11ull},
+    {0xa59bc234db398c25ull, 0x43fab9837e699095ull},
+    {0xcf02b2c21207ef2eull, 0x94f967e45e03f4bbull},
+    {0x8161afb94b44f57dull, 0x1d1be0eebac278f5ull},
+    {0xa1ba1ba79e1632dcull, 0x6462d92a69731732ull},
+    {0xca28a291859bbf93ull, 0x7d7b8f7503cfdcfeull},
+    {0xfcb2cb35e702af78ull, 0x5cda735244c3d43eull},
+    {0x9defbf01b061adabull, 0x3a0888136afa64a7ull},
+    {0xc56baec21c7a1916ull, 0x088aaa1845b8fdd0ull},
+    {0xf6c69a72a3989f5bull, 0x8aad549e57273d45ull},
+    {0x9a3c2087a63f6399ull, 0x36ac54e2f678864bull},
+    {0xc0cb28a98fcf3c7full, 0x84576a1bb416a7ddull},
+    {0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d5ull},
+    {0x969eb7c47859e743ull, 0x9f644ae5a4b1b325ull},
+    {0xbc4665b596706114ull, 0x873d5d9f0dde1feeull},
+    {0xeb57ff22fc0c7959ull, 0xa90cb506d155a7eaull},
+    {0x9316ff75dd87cbd8ull, 0x09a7f12442d588f2ull},
+    {0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb2full},
+    {0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull},
+    {0x8fa475791a569d10ull, 0xf96e017d694487bcull},
+    {0xb38d92d760ec4455ull, 0x37c981dcc395a9acull},
+    {0xe070f78d3927556aull, 0x85bbe253f47b1417ull},
+    {0x8c469ab843b89562ull, 0x93956d7478ccec8eull},
+    {0xaf58416654a6babbull, 0x387ac8d1970027b2ull},
+    {0xdb2e51bfe9d0696aull, 0x06997b05fcc0319eull},
+    {0x88fcf317f22241e2ull, 0x441fece3bdf81f03ull},
+    {0xab3c2fddeeaad25aull, 0xd527e81cad7626c3ull},
+    {0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b074ull},
+    {0x85c7056562757456ull, 0xf6872d5667844e49ull},
+    {0xa738c6bebb12d16cull, 0xb428f8ac016561dbull},
+    {0xd106f86e69d785c7ull, 0xe13336d701beba52ull},
+    {0x82a45b450226b39cull, 0xecc0024661173473ull},
+    {0xa34d721642b06084ull, 0x27f002d7f95d0190ull},
+    {0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f4ull},
+    {0xff290242c83396ceull, 0x7e67047175a15271ull},
+    {0x9f79a169bd203e41ull, 0x0f0062c6e984d386ull},
+    {0xc75809c42c684dd1ull, 0x52c07b78a3e60868ull},
+    {0xf92e0c3537826145ull, 0xa7709a56ccdf8a82ull},
+    {0x9bbcc7a142b17ccbull, 0x88a66076400bb691ull},
+    {0xc2abf989935ddbfeull, 0x6acff893d00ea435ull},
+    {0xf356f7ebf83552feull, 0x0583f6b8c4124d43ull},
+    {0x98165af37b2153deull, 0xc3727a337a8b704aull},
+    {0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5cull},
+    {0xeda2ee1c7064130cull, 0x1162def06f79df73ull},
+    {0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba8ull},
+    {0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull},
+    {0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0437ull},
+    {0x910ab1d4db9914a0ull, 0x1d9c9892400a22a2ull},
+    {0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4bull},
+    {0xe2a0b5dc971f303aull, 0x2e44ae64840fd61dull},
+    {0x8da471a9de737e24ull, 0x5ceaecfed289e5d2ull},
+    {0xb10d8e1456105dadull, 0x7425a83e872c5f47ull},
+    {0xdd50f1996b947518ull, 0xd12f124e28f77719ull},
+    {0x8a5296ffe33cc92full, 0x82bd6b70d99aaa6full},
+    {0xace73cbfdc0bfb7bull, 0x636cc64d1001550bull},
+    {0xd8210befd30efa5aull, 0x3c47f7e05401aa4eull},
+    {0x8714a775e3e95c78ull, 0x65acfaec34810a71ull},
+    {0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0dull},
+    {0xd31045a8341ca07cull, 0x1ede48111209a050ull},
+    {0x83ea2b892091e44dull, 0x934aed0aab460432ull},
+    {0xa4e4b66b68b65d60ull, 0xf81da84d5617853full},
+    {0xce1de40642e3f4b9ull, 0x36251260ab9d668eull},
+    {0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b426019ull},
+    {0xa1075a24e4421730ull, 0xb24cf65b8612f81full},
+    {0xc94930ae1d529cfcull, 0xdee033f26797b627ull},
+    {0xfb9b7cd9a4a7443cull, 0x169840ef017da3b1ull},
+    {0x9d412e0806e88aa5ull, 0x8e1f289560ee864eull},
+    {0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e2ull},
+    {0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dbull},
+    {0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef29ull},
+    {0xbff610b0cc6edd3full, 0x17fd090a58d32af3ull},
+    {0xeff394dcff8a948eull, 0xddfc4b4cef07f5b0ull},
+    {0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull},
+    {0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f1ull},
+    {0xea53df5fd18d5513ull, 0x84c86189216dc5edull},
+    {0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb4ull},
+    {0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a1ull},
+    {0xe4d5e82392a40515ull, 0x0fabaf3feaa5334aull},
+    {0x8f05b1163ba6832dull, 0x29cb4d87f2a7400eull},
+    {0xb2c71d5bca9023f8ull, 0x743e20e9ef511012ull},
+    {0xdf78e4b2bd342cf6ull, 0x914da9246b255416ull},
+    {0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548eull},
+    {0xae9672aba3d0c320ull, 0xa184ac2473b529b1ull},
+    {0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741eull},
+    {0x8865899617fb1871ull, 0x7e2fa67c7a658892ull},
+    {0xaa7eebfb9df9de8dull, 0xddbb901b98feeab7ull},
+    {0xd51ea6fa85785631ull, 0x552a74227f3ea565ull},
+    {0x8533285c936b35deull, 0xd53a88958f87275full},
+    {0xa67ff273b8460356ull, 0x8a892abaf368f137ull},
+    {0xd01fef10a657842cull, 0x2d2b7569b0432d85ull},
+    {0x8213f56a67f6b29bull, 0x9c3b29620e29fc73ull},
+    {0xa298f2c501f45f42ull, 0x8349f3ba91b47b8full},
+    {0xcb3f2f7642717713ull, 0x241c70a936219a73ull},
+    {0xfe0efb53d30dd4d7ull, 0xed238cd383aa0110ull},
+    {0x9ec95d1463e8a506ull, 0xf4363804324a40aaull},
+    {0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d5ull},
+    {0xf81aa16fdc1b81daull, 0xdd94b7868e94050aull},
+    {0x9b10a4e5e9913128ull, 0xca7cf2b4191c8326ull},
+    {0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f0ull},
+    {0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull},
+    {0x976e41088617ca01ull, 0xd5be0503e085d813ull},
+    {0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e18ull},
+    {0xec9c459d51852ba2ull, 0xddf8e7d60ed1219eull},
+    {0x93e1ab8252f33b45ull, 0xcabb90e5c942b503ull},
+    {0xb8da1662e7b00a17ull, 0x3d6a751f3b936243ull},
+    {0xe7109bfba19c0c9dull, 0x0cc512670a783ad4ull},
+    {0x906a617d450187e2ull, 0x27fb2b80668b24c5ull},
+    {0xb484f9dc9641e9daull, 0xb1f9f660802dedf6ull},
+    {0xe1a63853bbd26451ull, 0x5e7873f8a0396973ull},
+    {0x8d07e33455637eb2ull, 0xdb0b487b6423e1e8ull},
+    {0xb049dc016abc5e5full, 0x91ce1a9a3d2cda62ull},
+    {0xdc5c5301c56b75f7ull, 0x7641a140cc7810fbull},
+    {0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9dull},
+    {0xac2820d9623bf429ull, 0x546345fa9fbdcd44ull},
+    {0xd732290fbacaf133ull, 0xa97c177947ad4095ull},
+    {0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485dull},
+    {0xa81f301449ee8c70ull, 0x5c68f256bfff5a74ull},
+    {0xd226fc195c6a2f8cull, 0x73832eec6fff3111ull},
+    {0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eabull},
+    {0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e55ull},
+    {0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ebull},
+    {0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b3ull},
+    {0xa0555e361951c366ull, 0xd7e105bcc332621full},
+    {0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa7ull},
+    {0xfa856334878fc150ull, 0xb14f98f6f0feb951ull},
+    {0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d3ull},
+    {0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull},
+    {0xf4a642e14c6262c8ull, 0xcd27bb612758c0faull},
+    {0x98e7e9cccfbd7dbdull, 0x8038d51cb897789cull},
+    {0xbf21e44003acdd2cull, 0xe0470a63e6bd56c3ull},
+    {0xeeea5d5004981478ull, 0x1858ccfce06cac74ull},
+    {0x95527a5202df0ccbull, 0x0f37801e0c43ebc8ull},
+    {0xbaa718e68396cffdull, 0xd30560258f54e6baull},
+    {0xe950df20247c83fdull, 0x47c6b82ef32a2069ull},
+    {0x91d28b7416cdd27eull, 0x4cdc331d57fa5441ull},
+    {0xb6472e511c81471dull, 0xe0133fe4adf8e952ull},
+    {0xe3d8f9e563a198e5ull, 0x58180fddd97723a6ull},
+    {0x8e679c2f5e44ff8full, 0x570f09eaa7ea7648ull}
+};
+
+static const double EXACT_POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} dv_u128;
+// --------------------------------------------------------------------------------
+
+static inline dv_u128 _mul_64x64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 dv_uint128;
+    dv_uint128 p = (dv_uint128)a * b;
+    return (dv_u128){(uint64_t)(p >> 64), (uint64_t)p};
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    return (dv_u128){p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), 
+                     (mid << 32) | (uint32_t)p0};
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline int _leading_zeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for (; !(x >> 63); x <<= 1) ++n;
+    return n;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline bool _is_digit(char c) {
+    return (unsigned)(c - '0') < 10;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the double nearest to w * 10^q, ties to even
+ *
+ * @param w A nonzero integer below 10^19
+ * @param q A decimal exponent in [PARSE_MIN_POW10, PARSE_MAX_POW10]
+ */
+static double _eisel_lemire(uint64_t w, int64_t q) {
+    int lz = _leading_zeros64(w);
+    w <<= lz;
+    const uint64_t* pow5 = POW5_128[q - PARSE_MIN_POW10];
+    dv_u128 product = _mul_64x64(w, pow5[0]);
+    // Only 55 bits are kept; when the 9 below them are all ones the dropped
+    // second word of the power could carry into them, so it is added in
+    if ((product.hi & 0x1FF) == 0x1FF) {
+        dv_u128 second = _mul_64x64(w, pow5[1]);
+        product.lo += second.hi;
+        if (second.hi > product.lo) product.hi++;
+    }
+    int upper = (int)(product.hi >> 63);
+    int shift = upper + 9;
+    uint64_t mantissa = product.hi >> shift;
+    // floor(q * log2(10)) + 63 is the binary exponent of 10^q scaled to 64 bits
+    int64_t power2 = ((217706 * q) >> 16) + 63 + upper - lz + 1023;
+    if (power2 <= 0) {
+        // Subnormal, rounded at the bit the exponent leaves for it
+        if (1 - power2 >= 64) return 0.0;
+        mantissa >>= 1 - power2;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < (1ull << 52) ? 0 : 1;
+    } else {
+        // A product with nothing below the kept bits is an exact halfway 
+        // case, which only happens for small q; it rounds to even
+        if (product.lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+            (mantissa << shift) == product.hi)
+            mantissa &= ~1ull;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        if (mantissa >= (2ull << 52)) {
+            mantissa = 1ull << 52;
+            power2++;
+        }
+        mantissa &= ~(1ull << 52);
+        if (power2 >= 0x7FF) return INFINITY;
     }
+    uint64_t bits = mantissa | ((uint64_t)power2 << 52);
+    double value;
+    memcpy(&value, &bits, sizeof value);
+    return value;
+}
+// --------------------------------------------------------------------------------
 
-    dict_dv* copy = init_doublev_dict();
-    if (!copy) {
-        return NULL;  // errno already set
+#if defined(DV_HAS_STRTOD_L)
+static locale_t _c_locale = (locale_t)0;
+static pthread_once_t _c_locale_once = PTHREAD_ONCE_INIT;
+
+static void _init_c_locale(void) {
+    _c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+}
+#endif
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Converts a NUL terminated decimal with '.' as the decimal point, 
+ *        whatever locale the program has selected
+ *
+ * strtod_l with a C locale created once is used where it exists.  Elsewhere
+ * the '.' is replaced with the single character decimal point of the current
+ * locale before calling strtod, so buf may be changed.
+ */
+static double _strtod_c(char* buf) {
+#if defined(DV_HAS_STRTOD_L)
+    pthread_once(&_c_locale_once, _init_c_locale);
+    if (_c_locale != (locale_t)0) return strtod_l(buf, NULL, _c_locale);
+#endif
+    const char* point = localeconv()->decimal_point;
+    if (point[0] != '.' && point[0] != '\0' && point[1] == '\0') {
+        char* dot = strchr(buf, '.');
+        if (dot) *dot = point[0];
     }
+    return strtod(buf, NULL);
+}
+// --------------------------------------------------------------------------------
 
-    for (size_t i = 0; i < original->alloc; ++i) {
-        dvdictNode* current = original->keyValues[i].next;
-        while (current) {
-            // if (current->value->alloc_type != DYNAMIC) {
-            //     free_doublev_dict(copy);
-            //     errno = EPERM;
-            //     return NULL;
-            // }
+/**
+ * @brief Converts [p, end), already checked to be a decimal, with strtod
+ *
+ * @return 0, or ENOMEM if a long token cannot be copied
+ */
+static int _strtod_token(const char* p, const char* end, double* out) {
+    char stack[PARSE_TOKEN_BUFFER];
+    size_t n = (size_t)(end - p);
+    char* buf = n < sizeof stack ? stack : malloc(n + 1);
+    if (!buf) return ENOMEM;
+    memcpy(buf, p, n);
+    buf[n] = '\0';
+    int saved = errno;
+    *out = _strtod_c(buf);
+    errno = saved;  // ERANGE from overflow or underflow is not a failure here
+    if (buf != stack) free(buf);
+    return 0;
+}
+// --------------------------------------------------------------------------------
 
-            double_v* vec_copy = copy_double_vector(current->value);
-            if (!vec_copy) {
-                free_doublev_dict(copy);
-                return NULL;
-            }
+/**
+ * @brief Matches inf, infinity or nan without regard to case
+ */
+static bool _parse_special(const char** pp, const char* end, bool negative, double* out) {
+    const char* p = *pp;
+    size_t n = (size_t)(end - p);
+    size_t i = 0;
+    static const char infinity[] = "infinity";
+    while (i < 8 && i < n && (p[i] | 0x20) == infinity[i]) ++i;
+    if (i == 3 || i == 8) {
+        *out = negative ? -INFINITY : INFINITY;
+        *pp = p + i;
+        return true;
+    }
+    if (n >= 3 && (p[0] | 0x20) == 'n' && (p[1] | 0x20) == 'a' && (p[2] | 0x20) == 'n') {
+        *out = negative ? -NAN : NAN;
+        *pp = p + 3;
+        return true;
+    }
+    return false;
+}
+// --------------------------------------------------------------------------------
 
-            if (!insert_doublev_dict(copy, current->key, vec_copy)) {
-                free_double_vector(vec_copy);
-                free_doublev_dict(copy);
-                return NULL;
+/**
+ * @brief Parses the decimal number at *pp and advances *pp past it
+ *
+ * The grammar is an optional sign, digits with an optional decimal point, at
+ * least one digit in all, and an optional exponent; or inf, infinity and nan
+ * in any case.  The caller checks what follows the number.
+ *
+ * @return 0 if a number was read, EILSEQ if none starts at *pp, or ENOMEM
+ */
+static int _parse_decimal(const char** pp, const char* end, double* out) {
+    const char* start = *pp;
+    const char* p = start;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    if (p < end && !_is_digit(*p) && *p != '.') {
+        *pp = p;
+        return _parse_special(pp, end, negative, out) ? 0 : EILSEQ;
+    }
+
+    uint64_t w = 0;
+    int64_t q = 0;
+    int digits = 0;  // significant digits held in w
+    bool any = false, truncated = false;
+    for (; p < end && _is_digit(*p); ++p) {
+        any = true;
+        if (digits < PARSE_MAX_DIGITS) {
+            w = w * 10 + (uint64_t)(*p - '0');
+            digits += w != 0;
+        } else {
+            q++;
+            truncated |= *p != '0';
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && _is_digit(*p); ++p) {
+            any = true;
+            if (digits < PARSE_MAX_DIGITS) {
+                w = w * 10 + (uint64_t)(*p - '0');
+                digits += w != 0;
+                q--;
+            } else {
+                truncated |= *p != '0';
             }
-
-            current = current->next;
         }
     }
+    if (!any) return EILSEQ;
+    if (p < end && (*p | 0x20) == 'e') {
+        const char* e = p + 1;
+        bool e_negative = false;
+        if (e < end && (*e == '-' || *e == '+')) e_negative = *e++ == '-';
+        if (e == end || !_is_digit(*e)) return EILSEQ;
+        int64_t exponent = 0;
+        for (; e < end && _is_digit(*e); ++e)
+            if (exponent < 100000) exponent = exponent * 10 + (*e - '0');
+        q += e_negative ? -exponent : exponent;
+        p = e;
+    }
+    *pp = p;
 
-    return copy;
+    double value;
+    if (w == 0)
+        value = 0.0;
+    else if (truncated)
+        return _strtod_token(start, p, out);
+    else if (PARSE_EXACT_DOUBLES && q >= -22 && q <= 22 && w <= (1ull << 53))
+        value = q < 0 ? (double)w / EXACT_POW10[-q] : (double)w * EXACT_POW10[q];
+    else if (q < PARSE_MIN_POW10)
+        value = 0.0;
+    else if (q > PARSE_MAX_POW10)
+        value = INFINITY;
+    else
+        value = _eisel_lemire(w, q);
+    *out = negative ? -value : value;
+    return 0;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-dict_dv* merge_doublev_dict(const dict_dv* dict1, const dict_dv* dict2, bool overwrite) {
-    if (!dict1 || !dict2) {
+size_t parse_double_buffer(const char* text, size_t len, const char* delim,
+                           double_v* vec, size_t* error_pos) {
+    if ((!text && len > 0) || !delim || !vec || !vec->data) {
         errno = EINVAL;
-        return NULL;
+        return LONG_MAX;
     }
-
-    // Start by deep copying dict1
-    dict_dv* merged = copy_doublev_dict(dict1);
-    if (!merged) {
-        return NULL;
+    bool sep[256] = {false};
+    sep[' '] = sep['\t'] = sep['\n'] = sep['\v'] = sep['\f'] = sep['\r'] = true;
+    for (const unsigned char* d = (const unsigned char*)delim; *d; ++d) sep[*d] = true;
+
+    const char* p = text;
+    const char* end = text + len;
+    size_t count = 0;
+    for (;;) {
+        while (p < end && sep[(unsigned char)*p]) ++p;
+        if (p == end) break;
+        const char* token = p;
+        double value;
+        int err = _parse_decimal(&p, end, &value);
+        if (!err && p < end && !sep[(unsigned char)*p]) err = EILSEQ;
+        if (!err && vec->len >= vec->alloc && !_grow_double_vector(vec, vec->len + 1))
+            err = errno;
+        if (err) {
+            if (error_pos) *error_pos = (size_t)(token - text);
+            errno = err;
+            return count;
+        }
+        vec->sorted = vec->len == 0 || 
+                      (vec->sorted && _in_order(vec->data[vec->len - 1], value));
+        vec->data[vec->len++] = value;
+        count++;
     }
+    if (error_pos) *error_pos = len;
+    return count;
+}
+// --------------------------------------------------------------------------------
 
-    // Now process dict2 entries
-    for (size_t i = 0; i < dict2->alloc; ++i) {
-        dvdictNode* current = dict2->keyValues[i].next;
-        while (current) {
-            if (!current->key || !current->value || current->value->alloc_type != DYNAMIC) {
-                free_doublev_dict(merged);
-                errno = EPERM;
-                return NULL;
-            }
+size_t parse_doubles_into_vector(const string_t* str, const char* delim,
+                                 double_v* vec, size_t* error_pos) {
+    const char* text = get_string(str);
+    if (!text) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return parse_double_buffer(text, string_size(str), delim, vec, error_pos);
+}
+// ================================================================================
+// ================================================================================
+// TEXT FORMATTING
+//
+// Doubles are written with the fewest significant digits that read back to 
+// the same double, found with the Schubfach method of Giulietti: the value and
+// the two ends of its rounding interval are scaled by one 128 bit power of 
+// ten so that the shortest decimal in the interval can be read off directly,
+// with no loop over digit counts and no big integers.  The text is laid out 
+// as printf("%.17g") lays it out, only shorter.  Values are formatted into a 
+// chunk on the stack and appended to the string a chunk at a time.
+
+#define FORMAT_MIN_POW10 -292   // 10^-k for the smallest subnormal
+#define FORMAT_MAX_CHARS 48     // a formatted double and the slack of its copies
+#define FORMAT_CHUNK 16384      // bytes formatted between appends
 
-            bool exists = has_key_doublev_dict(merged, current->key);
-            if (exists && !overwrite) {
-                current = current->next;
-                continue;
-            }
+/**
+ * @brief floor(10^e * 2^(127 - floor(log2(10^e)))) + 1 for e in 
+ *        [FORMAT_MIN_POW10, 324], high word first
+ */
+static const uint64_t POW10_128[324 - FORMAT_MIN_POW10 + 1][2] = {
+    {0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7bull},
+    {0x9faacf3df73609b1ull, 0x77b191618c54e9adull},
+    {0xc795830d75038c1dull, 0xd59df5b9ef6a2418ull},
+    {0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1eull},
+    {0x9becce62836ac577ull, 0x4ee367f9430aec33ull},
+    {0xc2e801fb244576d5ull, 0x229c41f793cda740ull},
+    {0xf3a20279ed56d48aull, 0x6b43527578c11110ull},
+    {0x9845418c345644d6ull, 0x830a13896b78aaaaull},
+    {0xbe5691ef416bd60cull, 0x23cc986bc656d554ull},
+    {0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa9ull},
+    {0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6aaull},
+    {0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc54ull},
+    {0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff69ull},
+    {0x91376c36d99995beull, 0x23100809b9c21fa2ull},
+    {0xb58547448ffffb2dull, 0xabd40a0c2832a78bull},
+    {0xe2e69915b3fff9f9ull, 0x16c90c8f323f516dull},
+    {0x8dd01fad907ffc3bull, 0xae3da7d97f6792e4ull},
+    {0xb1442798f49ffb4aull, 0x99cd11cfdf41779dull},
+    {0xdd95317f31c7fa1dull, 0x40405643d711d584ull},
+    {0x8a7d3eef7f1cfc52ull, 0x482835ea666b2573ull},
+    {0xad1c8eab5ee43b66ull, 0xda3243650005eed0ull},
+    {0xd863b256369d4a40ull, 0x90bed43e40076a83ull},
+    {0x873e4f75e2224e68ull, 0x5a7744a6e804a292ull},
+    {0xa90de3535aaae202ull, 0x711515d0a205cb37ull},
+    {0xd3515c2831559a83ull, 0x0d5a5b44ca873e04ull},
+    {0x8412d9991ed58091ull, 0xe858790afe9486c3ull},
+    {0xa5178fff668ae0b6ull, 0x626e974dbe39a873ull},
+    {0xce5d73ff402d98e3ull, 0xfb0a3d212dc81290ull},
+    {0x80fa687f881c7f8eull, 0x7ce66634bc9d0b9aull},
+    {0xa139029f6a239f72ull, 0x1c1fffc1ebc44e81ull},
+    {0xc987434744ac874eull, 0xa327ffb266b56221ull},
+    {0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa9ull},
+    {0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4aaull},
+    {0xc4ce17b399107c22ull, 0xcb550fb4384d21d4ull},
+    {0xf6019da07f549b2bull, 0x7e2a53a146606a49ull},
+    {0x99c102844f94e0fbull, 0x2eda7444cbfc426eull},
+    {0xc0314325637a1939ull, 0xfa911155fefb5309ull},
+    {0xf03d93eebc589f88ull, 0x793555ab7eba27cbull},
+    {0x96267c7535b763b5ull, 0x4bc1558b2f3458dfull},
+    {0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f17ull},
+    {0xea9c227723ee8bcbull, 0x465e15a979c1caddull},
+    {0x92a1958a7675175full, 0x0bfacd89ec191ecaull},
+    {0xb749faed14125d36ull, 0xcef980ec671f667cull},
+    {0xe51c79a85916f484ull, 0x82b7e12780e7401bull},
+    {0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908811ull},
+    {0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa16ull},
+    {0xdfbdcece67006ac9ull, 0x67a791e093e1d49bull},
+    {0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e1ull},
+    {0xaecc49914078536dull, 0x58fae9f773886e19ull},
+    {0xda7f5bf590966848ull, 0xaf39a475506a899full},
+    {0x888f99797a5e012dull, 0x6d8406c952429604ull},
+    {0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b84ull},
+    {0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a65ull},
+    {0x855c3be0a17fcd26ull, 0x5cf2eea09a550680ull},
+    {0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481full},
+    {0xd0601d8efc57b08bull, 0xf13b94daf124da27ull},
+    {0x823c12795db6ce57ull, 0x76c53d08d6b70859ull},
+    {0xa2cb1717b52481edull, 0x54768c4b0c64ca6full},
+    {0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd0aull},
+    {0xfe5d54150b090b02ull, 0xd3f93b35435d7c4dull},
+    {0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6db0ull},
+    {0xc6b8e9b0709f109aull, 0x359ab6419ca1091cull},
+    {0xf867241c8cc6d4c0ull, 0xc30163d203c94b63ull},
+    {0x9b407691d7fc44f8ull, 0x79e0de63425dcf1eull},
+    {0xc21094364dfb5636ull, 0x985915fc12f542e5ull},
+    {0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939eull},
+    {0x979cf3ca6cec5b5aull, 0xa705992ceecf9c43ull},
+    {0xbd8430bd08277231ull, 0x50c6ff782a838354ull},
+    {0xece53cec4a314ebdull, 0xa4f8bf5635246429ull},
+    {0x940f4613ae5ed136ull, 0x871b7795e136be9aull},
+    {0xb913179899f68584ull, 0x28e2557b59846e40ull},
+    {0xe757dd7ec07426e5ull, 0x331aeada2fe589d0ull},
+    {0x9096ea6f3848984full, 0x3ff0d2c85def7622ull},
+    {0xb4bca50b065abe63ull, 0x0fed077a756b53aaull},
+    {0xe1ebce4dc7f16dfbull, 0xd3e8495912c62895ull},
+    {0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95dull},
+    {0xb080392cc4349decull, 0xbd8d794d96aacfb4ull},
+    {0xdca04777f541c567ull, 0xecf0d7a0fc5583a1ull},
+    {0x89e42caaf9491b60ull, 0xf41686c49db57245ull},
+    {0xac5d37d5b79b6239ull, 0x311c2875c522ced6ull},
+    {0xd77485cb25823ac7ull, 0x7d633293366b828cull},
+    {0x86a8d39ef77164bcull, 0xae5dff9c02033198ull},
+    {0xa8530886b54dbdebull, 0xd9f57f830283fdfdull},
+    {0xd267caa862a12d66ull, 0xd072df63c324fd7cull},
+    {0x8380dea93da4bc60ull, 0x4247cb9e59f71e6eull},
+    {0xa46116538d0deb78ull, 0x52d9be85f074e609ull},
+    {0xcd795be870516656ull, 0x67902e276c921f8cull},
+    {0x806bd9714632dff6ull, 0x00ba1cd8a3db53b7ull},
+    {0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a5ull},
+    {0xc8a883c0fdaf7df0ull, 0x6122cd128006b2ceull},
+    {0xfad2a4b13d1b5d6cull, 0x796b805720085f82ull},
+    {0x9cc3a6eec6311a63ull, 0xcbe3303674053bb1ull},
+    {0xc3f490aa77bd60fcull, 0xbedbfc4411068a9dull},
+    {0xf4f1b4d515acb93bull, 0xee92fb5515482d45ull},
+    {0x991711052d8bf3c5ull, 0x751bdd152d4d1c4bull},
+    {0xbf5cd54678eef0b6ull, 0xd262d45a78a0635eull},
+    {0xef340a98172aace4ull, 0x86fb897116c87c35ull},
+    {0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da1ull},
+    {0xbae0a846d2195712ull, 0x8974836059cca10aull},
+    {0xe998d258869facd7ull, 0x2bd1a438703fc94cull},
+    {0x91ff83775423cc06ull, 0x7b6306a34627ddd0ull},
+    {0xb67f6455292cbf08ull, 0x1a3bc84c17b1d543ull},
+    {0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a94ull},
+    {0x8e938662882af53eull, 0x547eb47b7282ee9dull},
+    {0xb23867fb2a35b28dull, 0xe99e619a4f23aa44ull},
+    {0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d5ull},
+    {0x8b3c113c38f9f37eull, 0xde83bc408dd3dd05ull},
+    {0xae0b158b4738705eull, 0x9624ab50b148d446ull},
+    {0xd98ddaee19068c76ull, 0x3badd624dd9b0958ull},
+    {0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d7ull},
+    {0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4dull},
+    {0xd47487cc8470652bull, 0x7647c32000696720ull},
+    {0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e074ull},
+    {0xa5fb0a17c777cf09ull, 0xf468107100525891ull},
+    {0xcf79cc9db955c2ccull, 0x7182148d4066eeb5ull},
+    {0x81ac1fe293d599bfull, 0xc6f14cd848405531ull},
+    {0xa21727db38cb002full, 0xb8ada00e5a506a7dull},
+    {0xca9cf1d206fdc03bull, 0xa6d90811f0e4851dull},
+    {0xfd442e4688bd304aull, 0x908f4a166d1da664ull},
+    {0x9e4a9cec15763e2eull, 0x9a598e4e043287ffull},
+    {0xc5dd44271ad3cdbaull, 0x40eff1e1853f29feull},
+    {0xf7549530e188c128ull, 0xd12bee59e68ef47dull},
+    {0x9a94dd3e8cf578b9ull, 0x82bb74f8301958cfull},
+    {0xc13a148e3032d6e7ull, 0xe36a52363c1faf02ull},
+    {0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac2ull},
+    {0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0baull},
+    {0xbcb2b812db11a5deull, 0x7415d448f6b6f0e8ull},
+    {0xebdf661791d60f56ull, 0x111b495b3464ad22ull},
+    {0x936b9fcebb25c995ull, 0xcab10dd900beec35ull},
+    {0xb84687c269ef3bfbull, 0x3d5d514f40eea743ull},
+    {0xe65829b3046b0afaull, 0x0cb4a5a3112a5113ull},
+    {0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72acull},
+    {0xb3f4e093db73a093ull, 0x59ed216765690f57ull},
+    {0xe0f218b8d25088b8ull, 0x306869c13ec3532dull},
+    {0x8c974f7383725573ull, 0x1e414218c73a13fcull},
+    {0xafbd2350644eeacfull, 0xe5d1929ef90898fbull},
+    {0xdbac6c247d62a583ull, 0xdf45f746b74abf3aull},
+    {0x894bc396ce5da772ull, 0x6b8bba8c328eb784ull},
+    {0xab9eb47c81f5114full, 0x066ea92f3f326565ull},
+    {0xd686619ba27255a2ull, 0xc80a537b0efefebeull},
+    {0x8613fd0145877585ull, 0xbd06742ce95f5f37ull},
+    {0xa798fc4196e952e7ull, 0x2c48113823b73705ull},
+    {0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c6ull},
+    {0x82ef85133de648c4ull, 0x9a984d73dbe722fcull},
+    {0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbbull},
+    {0xcc963fee10b7d1b3ull, 0x318df905079926a9ull},
+    {0xffbbcfe994e5c61full, 0xfdf17746497f7053ull},
+    {0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa634ull},
+    {0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc1ull},
+    {0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b1ull},
+    {0x9c1661a651213e2dull, 0x06bea10ca65c084full},
+    {0xc31bfa0fe5698db8ull, 0x486e494fcff30a63ull},
+    {0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfbull},
+    {0x986ddb5c6b3a76b7ull, 0xf89629465a75e01dull},
+    {0xbe89523386091465ull, 0xf6bbb397f1135824ull},
+    {0xee2ba6c0678b597full, 0x746aa07ded582e2dull},
+    {0x94db483840b717efull, 0xa8c2a44eb4571cddull},
+    {0xba121a4650e4ddebull, 0x92f34d62616ce414ull},
+    {0xe896a0d7e51e1566ull, 0x77b020baf9c81d18ull},
+    {0x915e2486ef32cd60ull, 0x0ace1474dc1d122full},
+    {0xb5b5ada8aaff80b8ull, 0x0d819992132456bbull},
+    {0xe3231912d5bf60e6ull, 0x10e1fff697ed6c6aull},
+    {0x8df5efabc5979c8full, 0xca8d3ffa1ef463c2ull},
+    {0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb3ull},
+    {0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdfull},
+    {0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96cull},
+    {0xad4ab7112eb3929dull, 0x86c16c98d2c953c7ull},
+    {0xd89d64d57a607744ull, 0xe871c7bf077ba8b8ull},
+    {0x87625f056c7c4a8bull, 0x11471cd764ad4973ull},
+    {0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bd0ull},
+    {0xd389b47879823479ull, 0x4aff1d108d4ec2c4ull},
+    {0x843610cb4bf160cbull, 0xcedf722a585139bbull},
+    {0xa54394fe1eedb8feull, 0xc2974eb4ee658829ull},
+    {0xce947a3da6a9273eull, 0x733d226229feea33ull},
+    {0x811ccc668829b887ull, 0x0806357d5a3f5260ull},
+    {0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f8ull},
+    {0xc9bcff6034c13052ull, 0xfc89b393dd02f0b6ull},
+    {0xfc2c3f3841f17c67ull, 0xbbac2078d443ace3ull},
+    {0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0eull},
+    {0xc5029163f384a931ull, 0x0a9e795e65d4df12ull},
+    {0xf64335bcf065d37dull, 0x4d4617b5ff4a16d6ull},
+    {0x99ea0196163fa42eull, 0x504bced1bf8e4e46ull},
+    {0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d7ull},
+    {0xf07da27a82c37088ull, 0x5d767327bb4e5a4dull},
+    {0x964e858c91ba2655ull, 0x3a6a07f8d510f870ull},
+    {0xbbe226efb628afeaull, 0x890489f70a55368cull},
+    {0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842full},
+    {0x92c8ae6b464fc96full, 0x3b0b8bc90012929eull},
+    {0xb77ada0617e3bbcbull, 0x09ce6ebb40173745ull},
+    {0xe55990879ddcaabdull, 0xcc420a6a101d0516ull},
+    {0x8f57fa54c2a9eab6ull, 0x9fa946824a12232eull},
+    {0xb32df8e9f3546564ull, 0x47939822dc96abfaull},
+    {0xdff9772470297ebdull, 0x59787e2b93bc56f8ull},
+    {0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65bull},
+    {0xaefae51477a06b03ull, 0xede622920b6b23f2ull},
+    {0xdab99e59958885c4ull, 0xe95fab368e45eceeull},
+    {0x88b402f7fd75539bull, 0x11dbcb0218ebb415ull},
+    {0xaae103b5fcd2a881ull, 0xd652bdc29f26a11aull},
+    {0xd59944a37c0752a2ull, 0x4be76d3346f04960ull},
+    {0x857fcae62d8493a5ull, 0x6f70a4400c562ddcull},
+    {0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb953ull},
+    {0xd097ad07a71f26b2ull, 0x7e2000a41346a7a8ull},
+    {0x825ecc24c873782full, 0x8ed400668c0c28c9ull},
+    {0xa2f67f2dfa90563bull, 0x728900802f0f32fbull},
+    {0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffbaull},
+    {0xfea126b7d78186bcull, 0xe2f610c84987bfa9ull},
+    {0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7caull},
+    {0xc6ede63fa05d3143ull, 0x91503d1c79720dbcull},
+    {0xf8a95fcf88747d94ull, 0x75a44c6397ce912bull},
+    {0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abbull},
+    {0xc24452da229b021bull, 0xfbe85badce996169ull},
+    {0xf2d56790ab41c2a2ull, 0xfae27299423fb9c4ull},
+    {0x97c560ba6b0919a5ull, 0xdccd879fc967d41bull},
+    {0xbdb6b8e905cb600full, 0x5400e987bbc1c921ull},
+    {0xed246723473e3813ull, 0x290123e9aab23b69ull},
+    {0x9436c0760c86e30bull, 0xf9a0b6720aaf6522ull},
+    {0xb94470938fa89bceull, 0xf808e40e8d5b3e6aull},
+    {0xe7958cb87392c2c2ull, 0xb60b1d1230b20e05ull},
+    {0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c3ull},
+    {0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af4ull},
+    {0xe2280b6c20dd5232ull, 0x25c6da63c38de1b1ull},
+    {0x8d590723948a535full, 0x579c487e5a38ad0full},
+    {0xb0af48ec79ace837ull, 0x2d835a9df0c6d852ull},
+    {0xdcdb1b2798182244ull, 0xf8e431456cf88e66ull},
+    {0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b5900ull},
+    {0xac8b2d36eed2dac5ull, 0xe272467e3d222f40ull},
+    {0xd7adf884aa879177ull, 0x5b0ed81dcc6abb10ull},
+    {0x86ccbb52ea94baeaull, 0x98e947129fc2b4eaull},
+    {0xa87fea27a539e9a5ull, 0x3f2398d747b36225ull},
+    {0xd29fe4b18e88640eull, 0x8eec7f0d19a03aaeull},
+    {0x83a3eeeef9153e89ull, 0x1953cf68300424adull},
+    {0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd8ull},
+    {0xcdb02555653131b6ull, 0x3792f412cb06794eull},
+    {0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd1ull},
+    {0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec5ull},
+    {0xc8de047564d20a8bull, 0xf245825a5a445276ull},
+    {0xfb158592be068d2eull, 0xeed6e2f0f0d56713ull},
+    {0x9ced737bb6c4183dull, 0x55464dd69685606cull},
+    {0xc428d05aa4751e4cull, 0xaa97e14c3c26b887ull},
+    {0xf53304714d9265dfull, 0xd53dd99f4b3066a9ull},
+    {0x993fe2c6d07b7fabull, 0xe546a8038efe402aull},
+    {0xbf8fdb78849a5f96ull, 0xde98520472bdd034ull},
+    {0xef73d256a5c0f77cull, 0x963e66858f6d4441ull},
+    {0x95a8637627989aadull, 0xdde7001379a44aa9ull},
+    {0xbb127c53b17ec159ull, 0x5560c018580d5d53ull},
+    {0xe9d71b689dde71afull, 0xaab8f01e6e10b4a7ull},
+    {0x9226712162ab070dull, 0xcab3961304ca70e9ull},
+    {0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d23ull},
+    {0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506bull},
+    {0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb243ull},
+    {0xb267ed1940f1c61cull, 0x55f038b237591ed4ull},
+    {0xdf01e85f912e37a3ull, 0x6b6c46dec52f6689ull},
+    {0x8b61313bbabce2c6ull, 0x2323ac4b3b3da016ull},
+    {0xae397d8aa96c1b77ull, 0xabec975e0a0d081bull},
+    {0xd9c7dced53c72255ull, 0x96e7bd358c904a22ull},
+    {0x881cea14545c7575ull, 0x7e50d64177da2e55ull},
+    {0xaa242499697392d2ull, 0xdde50bd1d5d0b9eaull},
+    {0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e865ull},
+    {0x84ec3c97da624ab4ull, 0xbd5af13bef0b113full},
+    {0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58full},
+    {0xcfb11ead453994baull, 0x67de18eda5814af3ull},
+    {0x81ceb32c4b43fcf4ull, 0x80eacf948770ced8ull},
+    {0xa2425ff75e14fc31ull, 0xa1258379a94d028eull},
+    {0xcad2f7f5359a3b3eull, 0x096ee45813a04331ull},
+    {0xfd87b5f28300ca0dull, 0x8bca9d6e188853fdull},
+    {0x9e74d1b791e07e48ull, 0x775ea264cf55347eull},
+    {0xc612062576589ddaull, 0x95364afe032a819eull},
+    {0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull},
+    {0x9abe14cd44753b52ull, 0xc4926a9672793543ull},
+    {0xc16d9a0095928a27ull, 0x75b7053c0f178294ull},
+    {0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull},
+    {0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull},
+    {0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull},
+    {0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull},
+    {0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull},
+    {0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull},
+    {0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull},
+    {0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull},
+    {0xb424dc35095cd80full, 0x538484c19ef38c95ull},
+    {0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull},
+    {0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull},
+    {0xafebff0bcb24aafeull, 0xf78f69a51539d749ull},
+    {0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull},
+    {0x89705f4136b4a597ull, 0x31680a88f8953031ull},
+    {0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull},
+    {0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull},
+    {0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull},
+    {0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull},
+    {0xd1b71758e219652bull, 0xd3c36113404ea4a9ull},
+    {0x83126e978d4fdf3bull, 0x645a1cac083126eaull},
+    {0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull},
+    {0xccccccccccccccccull, 0xcccccccccccccccdull},
+    {0x8000000000000000ull, 0x0000000000000001ull},
+    {0xa000000000000000ull, 0x0000000000000001ull},
+    {0xc800000000000000ull, 0x0000000000000001ull},
+    {0xfa00000000000000ull, 0x0000000000000001ull},
+    {0x9c40000000000000ull, 0x0000000000000001ull},
+    {0xc350000000000000ull, 0x0000000000000001ull},
+    {0xf424000000000000ull, 0x0000000000000001ull},
+    {0x9896800000000000ull, 0x0000000000000001ull},
+    {0xbebc200000000000ull, 0x0000000000000001ull},
+    {0xee6b280000000000ull, 0x0000000000000001ull},
+    {0x9502f90000000000ull, 0x0000000000000001ull},
+    {0xba43b74000000000ull, 0x0000000000000001ull},
+    {0xe8d4a51000000000ull, 0x0000000000000001ull},
+    {0x9184e72a00000000ull, 0x0000000000000001ull},
+    {0xb5e620f480000000ull, 0x0000000000000001ull},
+    {0xe35fa931a0000000ull, 0x0000000000000001ull},
+    {0x8e1bc9bf04000000ull, 0x0000000000000001ull},
+    {0xb1a2bc2ec5000000ull, 0x0000000000000001ull},
+    {0xde0b6b3a76400000ull, 0x0000000000000001ull},
+    {0x8ac7230489e80000ull, 0x0000000000000001ull},
+    {0xad78ebc5ac620000ull, 0x0000000000000001ull},
+    {0xd8d726b7177a8000ull, 0x0000000000000001ull},
+    {0x878678326eac9000ull, 0x0000000000000001ull},
+    {0xa968163f0a57b400ull, 0x0000000000000001ull},
+    {0xd3c21bcecceda100ull, 0x0000000000000001ull},
+    {0x84595161401484a0ull, 0x0000000000000001ull},
+    {0xa56fa5b99019a5c8ull, 0x0000000000000001ull},
+    {0xcecb8f27f4200f3aull, 0x0000000000000001ull},
+    {0x813f3978f8940984ull, 0x4000000000000001ull},
+    {0xa18f07d736b90be5ull, 0x5000000000000001ull},
+    {0xc9f2c9cd04674edeull, 0xa400000000000001ull},
+    {0xfc6f7c4045812296ull, 0x4d00000000000001ull},
+    {0x9dc5ada82b70b59dull, 0xf020000000000001ull},
+    {0xc5371912364ce305ull, 0x6c28000000000001ull},
+    {0xf684df56c3e01bc6ull, 0xc732000000000001ull},
+    {0x9a130b963a6c115cull, 0x3c7f400000000001ull},
+    {0xc097ce7bc90715b3ull, 0x4b9f100000000001ull},
+    {0xf0bdc21abb48db20ull, 0x1e86d40000000001ull},
+    {0x96769950b50d88f4ull, 0x1314448000000001ull},
+    {0xbc143fa4e250eb31ull, 0x17d955a000000001ull},
+    {0xeb194f8e1ae525fdull, 0x5dcfab0800000001ull},
+    {0x92efd1b8d0cf37beull, 0x5aa1cae500000001ull},
+    {0xb7abc627050305adull, 0xf14a3d9e40000001ull},
+    {0xe596b7b0c643c719ull, 0x6d9ccd05d0000001ull},
+    {0x8f7e32ce7bea5c6full, 0xe4820023a2000001ull},
+    {0xb35dbf821ae4f38bull, 0xdda2802c8a800001ull},
+    {0xe0352f62a19e306eull, 0xd50b2037ad200001ull},
+    {0x8c213d9da502de45ull, 0x4526f422cc340001ull},
+    {0xaf298d050e4395d6ull, 0x9670b12b7f410001ull},
+    {0xdaf3f04651d47b4cull, 0x3c0cdd765f114001ull},
+    {0x88d8762bf324cd0full, 0xa5880a69fb6ac801ull},
+    {0xab0e93b6efee0053ull, 0x8eea0d047a457a01ull},
+    {0xd5d238a4abe98068ull, 0x72a4904598d6d881ull},
+    {0x85a36366eb71f041ull, 0x47a6da2b7f864751ull},
+    {0xa70c3c40a64e6c51ull, 0x999090b65f67d925ull},
+    {0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6eull},
+    {0x82818f1281ed449full, 0xbff8f10e7a8921a5ull},
+    {0xa321f2d7226895c7ull, 0xaff72d52192b6a0eull},
+    {0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764491ull},
+    {0xfee50b7025c36a08ull, 0x02f236d04753d5b5ull},
+    {0x9f4f2726179a2245ull, 0x01d762422c946591ull},
+    {0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef6ull},
+    {0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb3ull},
+    {0x9b934c3b330c8577ull, 0x63cc55f49f88eb30ull},
+    {0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fcull},
+    {0xf316271c7fc3908aull, 0x8bef464e3945ef7bull},
+    {0x97edd871cfda3a56ull, 0x97758bf0e3cbb5adull},
+    {0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea318ull},
+    {0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bdeull},
+    {0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6bull},
+    {0xb975d6b6ee39e436ull, 0xb3e2fd538e122b45ull},
+    {0xe7d34c64a9c85d44ull, 0x60dbbca87196b617ull},
+    {0x90e40fbeea1d3a4aull, 0xbc8955e946fe31ceull},
+    {0xb51d13aea4a488ddull, 0x6babab6398bdbe42ull},
+    {0xe264589a4dcdab14ull, 0xc696963c7eed2dd2ull},
+    {0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca3ull},
+    {0xb0de65388cc8ada8ull, 0x3b25a55f43294bccull},
+    {0xdd15fe86affad912ull, 0x49ef0eb713f39ebfull},
+    {0x8a2dbf142dfcc7abull, 0x6e3569326c784338ull},
+    {0xacb92ed9397bf996ull, 0x49c2c37f07965405ull},
+    {0xd7e77a8f87daf7fbull, 0xdc33745ec97be907ull},
+    {0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a4ull},
+    {0xa8acd7c0222311bcull, 0xc40832ea0d68ce0dull},
+    {0xd2d80db02aabd62bull, 0xf50a3fa490c30191ull},
+    {0x83c7088e1aab65dbull, 0x792667c6da79e0fbull},
+    {0xa4b8cab1a1563f52ull, 0x577001b891185939ull},
+    {0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f87ull},
+    {0x80b05e5ac60b6178ull, 0x544f8158315b05b5ull},
+    {0xa0dc75f1778e39d6ull, 0x696361ae3db1c722ull},
+    {0xc913936dd571c84cull, 0x03bc3a19cd1e38eaull},
+    {0xfb5878494ace3a5full, 0x04ab48a04065c724ull},
+    {0x9d174b2dcec0e47bull, 0x62eb0d64283f9c77ull},
+    {0xc45d1df942711d9aull, 0x3ba5d0bd324f8395ull},
+    {0xf5746577930d6500ull, 0xca8f44ec7ee3647aull},
+    {0x9968bf6abbe85f20ull, 0x7e998b13cf4e1eccull},
+    {0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67full},
+    {0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101full},
+    {0x95d04aee3b80ece5ull, 0xbba1f1d158724a13ull},
+    {0xbb445da9ca61281full, 0x2a8a6e45ae8edc98ull},
+    {0xea1575143cf97226ull, 0xf52d09d71a3293beull},
+    {0x924d692ca61be758ull, 0x593c2626705f9c57ull},
+    {0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836dull},
+    {0xe498f455c38b997aull, 0x0b6dfb9c0f956448ull},
+    {0x8edf98b59a373fecull, 0x4724bd4189bd5eadull},
+    {0xb2977ee300c50fe7ull, 0x58edec91ec2cb658ull},
+    {0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3eeull},
+    {0x8b865b215899f46cull, 0xbd79e0d20082ee75ull},
+    {0xae67f1e9aec07187ull, 0xecd8590680a3aa12ull},
+    {0xda01ee641a708de9ull, 0xe80e6f4820cc9496ull},
+    {0x884134fe908658b2ull, 0x3109058d147fdcdeull},
+    {0xaa51823e34a7eedeull, 0xbd4b46f0599fd416ull},
+    {0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91bull},
+    {0x850fadc09923329eull, 0x03e2cf6bc604ddb1ull},
+    {0xa6539930bf6bff45ull, 0x84db8346b786151dull},
+    {0xcfe87f7cef46ff16ull, 0xe612641865679a64ull},
+    {0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07full},
+    {0xa26da3999aef7749ull, 0xe3be5e330f38f09eull},
+    {0xcb090c8001ab551cull, 0x5cadf5bfd3072cc6ull},
+    {0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f7ull},
+    {0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afbull},
+    {0xc646d63501a1511dull, 0xb281e1fd541501b9ull},
+    {0xf7d88bc24209a565ull, 0x1f225a7ca91a4227ull},
+    {0x9ae757596946075full, 0x3375788de9b06959ull},
+    {0xc1a12d2fc3978937ull, 0x0052d6b1641c83afull},
+    {0xf209787bb47d6b84ull, 0xc0678c5dbd23a49bull},
+    {0x9745eb4d50ce6332ull, 0xf840b7ba963646e1ull},
+    {0xbd176620a501fbffull, 0xb650e5a93bc3d899ull},
+    {0xec5d3fa8ce427affull, 0xa3e51f138ab4cebfull},
+    {0x93ba47c980e98cdfull, 0xc66f336c36b10138ull},
+    {0xb8a8d9bbe123f017ull, 0xb80b0047445d4185ull},
+    {0xe6d3102ad96cec1dull, 0xa60dc059157491e6ull},
+    {0x9043ea1ac7e41392ull, 0x87c89837ad68db30ull},
+    {0xb454e4a179dd1877ull, 0x29babe4598c311fcull},
+    {0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67bull},
+    {0x8ce2529e2734bb1dull, 0x1899e4a65f58660dull},
+    {0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f90ull},
+    {0xdc21a1171d42645dull, 0x76707543f4fa1f74ull},
+    {0x899504ae72497ebaull, 0x6a06494a791c53a9ull},
+    {0xabfa45da0edbde69ull, 0x0487db9d17636893ull},
+    {0xd6f8d7509292d603ull, 0x45a9d2845d3c42b7ull},
+    {0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b3ull},
+    {0xa7f26836f282b732ull, 0x8e6cac7768d7141full},
+    {0xd1ef0244af2364ffull, 0x3207d795430cd927ull},
+    {0x8335616aed761f1full, 0x7f44e6bd49e807b9ull},
+    {0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a7ull},
+    {0xcd036837130890a1ull, 0x36dba887c37a8c10ull},
+    {0x802221226be55a64ull, 0xc2494954da2c978aull},
+    {0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6dull},
+    {0xc83553c5c8965d3dull, 0x6f92829494e5acc8ull},
+    {0xfa42a8b73abbf48cull, 0xcb772339ba1f17faull},
+    {0x9c69a97284b578d7ull, 0xff2a760414536efcull},
+    {0xc38413cf25e2d70dull, 0xfef5138519684abbull},
+    {0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d6aull},
+    {0x98bf2f79d5993802ull, 0xef2f773ffbd97a62ull},
+    {0xbeeefb584aff8603ull, 0xaafb550ffacfd8fbull},
+    {0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf39ull},
+    {0x952ab45cfa97a0b2ull, 0xdd945a747bf26184ull},
+    {0xba756174393d88dfull, 0x94f971119aeef9e5ull},
+    {0xe912b9d1478ceb17ull, 0x7a37cd5601aab85eull},
+    {0x91abb422ccb812eeull, 0xac62e055c10ab33bull},
+    {0xb616a12b7fe617aaull, 0x577b986b314d600aull},
+    {0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80cull},
+    {0x8e41ade9fbebc27dull, 0x14588f13be847308ull},
+    {0xb1d219647ae6b31cull, 0x596eb2d8ae258fc9ull},
+    {0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bcull},
+    {0x8aec23d680043beeull, 0x25de7bb9480d5855ull},
+    {0xada72ccc20054ae9ull, 0xaf561aa79a10ae6bull},
+    {0xd910f7ff28069da4ull, 0x1b2ba1518094da05ull},
+    {0x87aa9aff79042286ull, 0x90fb44d2f05d0843ull},
+    {0xa99541bf57452b28ull, 0x353a1607ac744a54ull},
+    {0xd3fa922f2d1675f2ull, 0x42889b8997915ce9ull},
+    {0x847c9b5d7c2e09b7ull, 0x69956135febada12ull},
+    {0xa59bc234db398c25ull, 0x43fab9837e699096ull},
+    {0xcf02b2c21207ef2eull, 0x94f967e45e03f4bcull},
+    {0x8161afb94b44f57dull, 0x1d1be0eebac278f6ull},
+    {0xa1ba1ba79e1632dcull, 0x6462d92a69731733ull},
+    {0xca28a291859bbf93ull, 0x7d7b8f7503cfdcffull},
+    {0xfcb2cb35e702af78ull, 0x5cda735244c3d43full},
+    {0x9defbf01b061adabull, 0x3a0888136afa64a8ull},
+    {0xc56baec21c7a1916ull, 0x088aaa1845b8fdd1ull},
+    {0xf6c69a72a3989f5bull, 0x8aad549e57273d46ull},
+    {0x9a3c2087a63f6399ull, 0x36ac54e2f678864cull},
+    {0xc0cb28a98fcf3c7full, 0x84576a1bb416a7deull},
+    {0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d6ull},
+    {0x969eb7c47859e743ull, 0x9f644ae5a4b1b326ull},
+    {0xbc4665b596706114ull, 0x873d5d9f0dde1fefull},
+    {0xeb57ff22fc0c7959ull, 0xa90cb506d155a7ebull},
+    {0x9316ff75dd87cbd8ull, 0x09a7f12442d588f3ull},
+    {0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb30ull},
+    {0xe5d3ef282a242e81ull, 0x8f1668c8a86da5fbull},
+    {0x8fa475791a569d10ull, 0xf96e017d694487bdull},
+    {0xb38d92d760ec4455ull, 0x37c981dcc395a9adull},
+    {0xe070f78d3927556aull, 0x85bbe253f47b1418ull},
+    {0x8c469ab843b89562ull, 0x93956d7478ccec8full},
+    {0xaf58416654a6babbull, 0x387ac8d1970027b3ull},
+    {0xdb2e51bfe9d0696aull, 0x06997b05fcc0319full},
+    {0x88fcf317f22241e2ull, 0x441fece3bdf81f04ull},
+    {0xab3c2fddeeaad25aull, 0xd527e81cad7626c4ull},
+    {0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b075ull},
+    {0x85c7056562757456ull, 0xf6872d5667844e4aull},
+    {0xa738c6bebb12d16cull, 0xb428f8ac016561dcull},
+    {0xd106f86e69d785c7ull, 0xe13336d701beba53ull},
+    {0x82a45b450226b39cull, 0xecc0024661173474ull},
+    {0xa34d721642b06084ull, 0x27f002d7f95d0191ull},
+    {0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f5ull},
+    {0xff290242c83396ceull, 0x7e67047175a15272ull},
+    {0x9f79a169bd203e41ull, 0x0f0062c6e984d387ull},
+    {0xc75809c42c684dd1ull, 0x52c07b78a3e60869ull},
+    {0xf92e0c3537826145ull, 0xa7709a56ccdf8a83ull},
+    {0x9bbcc7a142b17ccbull, 0x88a66076400bb692ull},
+    {0xc2abf989935ddbfeull, 0x6acff893d00ea436ull},
+    {0xf356f7ebf83552feull, 0x0583f6b8c4124d44ull},
+    {0x98165af37b2153deull, 0xc3727a337a8b704bull},
+    {0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5dull},
+    {0xeda2ee1c7064130cull, 0x1162def06f79df74ull},
+    {0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba9ull},
+    {0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173693ull},
+    {0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0438ull},
+    {0x910ab1d4db9914a0ull, 0x1d9c9892400a22a3ull},
+    {0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4cull},
+    {0xe2a0b5dc971f303aull, 0x2e44ae64840fd61eull},
+    {0x8da471a9de737e24ull, 0x5ceaecfed289e5d3ull},
+    {0xb10d8e1456105dadull, 0x7425a83e872c5f48ull},
+    {0xdd50f1996b947518ull, 0xd12f124e28f7771aull},
+    {0x8a5296ffe33cc92full, 0x82bd6b70d99aaa70ull},
+    {0xace73cbfdc0bfb7bull, 0x636cc64d1001550cull},
+    {0xd8210befd30efa5aull, 0x3c47f7e05401aa4full},
+    {0x8714a775e3e95c78ull, 0x65acfaec34810a72ull},
+    {0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0eull},
+    {0xd31045a8341ca07cull, 0x1ede48111209a051ull},
+    {0x83ea2b892091e44dull, 0x934aed0aab460433ull},
+    {0xa4e4b66b68b65d60ull, 0xf81da84d56178540ull},
+    {0xce1de40642e3f4b9ull, 0x36251260ab9d668full},
+    {0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b42601aull},
+    {0xa1075a24e4421730ull, 0xb24cf65b8612f820ull},
+    {0xc94930ae1d529cfcull, 0xdee033f26797b628ull},
+    {0xfb9b7cd9a4a7443cull, 0x169840ef017da3b2ull},
+    {0x9d412e0806e88aa5ull, 0x8e1f289560ee864full},
+    {0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e3ull},
+    {0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dcull},
+    {0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef2aull},
+    {0xbff610b0cc6edd3full, 0x17fd090a58d32af4ull},
+    {0xeff394dcff8a948eull, 0xddfc4b4cef07f5b1ull},
+    {0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98full},
+    {0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f2ull},
+    {0xea53df5fd18d5513ull, 0x84c86189216dc5eeull},
+    {0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb5ull},
+    {0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a2ull},
+    {0xe4d5e82392a40515ull, 0x0fabaf3feaa5334bull},
+    {0x8f05b1163ba6832dull, 0x29cb4d87f2a7400full},
+    {0xb2c71d5bca9023f8ull, 0x743e20e9ef511013ull},
+    {0xdf78e4b2bd342cf6ull, 0x914da9246b255417ull},
+    {0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548full},
+    {0xae9672aba3d0c320ull, 0xa184ac2473b529b2ull},
+    {0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741full},
+    {0x8865899617fb1871ull, 0x7e2fa67c7a658893ull},
+    {0xaa7eebfb9df9de8dull, 0xddbb901b98feeab8ull},
+    {0xd51ea6fa85785631ull, 0x552a74227f3ea566ull},
+    {0x8533285c936b35deull, 0xd53a88958f872760ull},
+    {0xa67ff273b8460356ull, 0x8a892abaf368f138ull},
+    {0xd01fef10a657842cull, 0x2d2b7569b0432d86ull},
+    {0x8213f56a67f6b29bull, 0x9c3b29620e29fc74ull},
+    {0xa298f2c501f45f42ull, 0x8349f3ba91b47b90ull},
+    {0xcb3f2f7642717713ull, 0x241c70a936219a74ull},
+    {0xfe0efb53d30dd4d7ull, 0xed238cd383aa0111ull},
+    {0x9ec95d1463e8a506ull, 0xf4363804324a40abull},
+    {0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d6ull},
+    {0xf81aa16fdc1b81daull, 0xdd94b7868e94050bull},
+    {0x9b10a4e5e9913128ull, 0xca7cf2b4191c8327ull},
+    {0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f1ull},
+    {0xf24a01a73cf2dccfull, 0xbc633b39673c8cedull},
+    {0x976e41088617ca01ull, 0xd5be0503e085d814ull},
+    {0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e19ull},
+    {0xec9c459d51852ba2ull, 0xddf8e7d60ed1219full},
+    {0x93e1ab8252f33b45ull, 0xcabb90e5c942b504ull},
+    {0xb8da1662e7b00a17ull, 0x3d6a751f3b936244ull},
+    {0xe7109bfba19c0c9dull, 0x0cc512670a783ad5ull},
+    {0x906a617d450187e2ull, 0x27fb2b80668b24c6ull},
+    {0xb484f9dc9641e9daull, 0xb1f9f660802dedf7ull},
+    {0xe1a63853bbd26451ull, 0x5e7873f8a0396974ull},
+    {0x8d07e33455637eb2ull, 0xdb0b487b6423e1e9ull},
+    {0xb049dc016abc5e5full, 0x91ce1a9a3d2cda63ull},
+    {0xdc5c5301c56b75f7ull, 0x7641a140cc7810fcull},
+    {0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9eull},
+    {0xac2820d9623bf429ull, 0x546345fa9fbdcd45ull},
+    {0xd732290fbacaf133ull, 0xa97c177947ad4096ull},
+    {0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485eull},
+    {0xa81f301449ee8c70ull, 0x5c68f256bfff5a75ull},
+    {0xd226fc195c6a2f8cull, 0x73832eec6fff3112ull},
+    {0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eacull},
+    {0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e56ull},
+    {0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ecull},
+    {0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b4ull},
+    {0xa0555e361951c366ull, 0xd7e105bcc3326220ull},
+    {0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa8ull},
+    {0xfa856334878fc150ull, 0xb14f98f6f0feb952ull},
+    {0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d4ull},
+    {0xc3b8358109e84f07ull, 0x0a862f80ec4700c9ull},
+    {0xf4a642e14c6262c8ull, 0xcd27bb612758c0fbull},
+    {0x98e7e9cccfbd7dbdull, 0x8038d51cb897789dull},
+    {0xbf21e44003acdd2cull, 0xe0470a63e6bd56c4ull},
+    {0xeeea5d5004981478ull, 0x1858ccfce06cac75ull},
+    {0x95527a5202df0ccbull, 0x0f37801e0c43ebc9ull},
+    {0xbaa718e68396cffdull, 0xd30560258f54e6bbull},
+    {0xe950df20247c83fdull, 0x47c6b82ef32a206aull},
+    {0x91d28b7416cdd27eull, 0x4cdc331d57fa5442ull},
+    {0xb6472e511c81471dull, 0xe0133fe4adf8e953ull},
+    {0xe3d8f9e563a198e5ull, 0x58180fddd97723a7ull},
+    {0x8e679c2f5e44ff8full, 0x570f09eaa7ea7649ull},
+    {0xb201833b35d63f73ull, 0x2cd2cc6551e513dbull},
+    {0xde81e40a034bcf4full, 0xf8077f7ea65e58d2ull},
+    {0x8b112e86420f6191ull, 0xfb04afaf27faf783ull},
+    {0xadd57a27d29339f6ull, 0x79c5db9af1f9b564ull},
+    {0xd94ad8b1c7380874ull, 0x18375281ae7822bdull},
+    {0x87cec76f1c830548ull, 0x8f2293910d0b15b6ull},
+    {0xa9c2794ae3a3c69aull, 0xb2eb3875504ddb23ull},
+    {0xd433179d9c8cb841ull, 0x5fa60692a46151ecull},
+    {0x849feec281d7f328ull, 0xdbc7c41ba6bcd334ull},
+    {0xa5c7ea73224deff3ull, 0x12b9b522906c0801ull},
+    {0xcf39e50feae16befull, 0xd768226b34870a01ull},
+    {0x81842f29f2cce375ull, 0xe6a1158300d46641ull},
+    {0xa1e53af46f801c53ull, 0x60495ae3c1097fd1ull},
+    {0xca5e89b18b602368ull, 0x385bb19cb14bdfc5ull},
+    {0xfcf62c1dee382c42ull, 0x46729e03dd9ed7b6ull},
+    {0x9e19db92b4e31ba9ull, 0x6c07a2c26a8346d2ull}
+};
 
-            double_v* vec_copy = copy_double_vector(current->value);
-            if (!vec_copy) {
-                free_doublev_dict(merged);
-                return NULL; // errno set by copy_double_vector
-            }
+static const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
-            if (exists) {
-                pop_doublev_dict(merged, current->key);
-            }
+/**
+ * @brief Returns the high 64 bits of g * cp, with the lowest bit set if any
+ *        of the bits below them were nonzero
+ */
+static inline uint64_t _round_to_odd(const uint64_t g[2], uint64_t cp) {
+    dv_u128 x = _mul_64x64(g[1], cp);
+    dv_u128 y = _mul_64x64(g[0], cp);
+    uint64_t mid = y.lo + x.hi;
+    uint64_t high = y.hi + (mid < y.lo);
+    return high | (mid > 1);
+}
+// --------------------------------------------------------------------------------
 
-            if (!insert_doublev_dict(merged, current->key, vec_copy)) {
-                free_double_vector(vec_copy);
-                free_doublev_dict(merged);
-                return NULL;
-            }
+/**
+ * @brief Finds the shortest digits * 10^exponent that rounds to a finite, 
+ *        nonzero double, the closest one when several are as short
+ *
+ * @param fraction The 52 stored fraction bits of the double
+ * @param biased The 11 bit biased exponent of the double
+ */
+static void _shortest_decimal(uint64_t fraction, uint32_t biased, 
+                              uint64_t* digits, int* exponent) {
+    uint64_t c = biased ? (1ull << 52) | fraction : fraction;
+    int64_t q = biased ? (int64_t)biased - 1075 : -1074;
+    // Integers below 2^53 are their own shortest decimal
+    if (q <= 0 && q > -53 && (c & ((1ull << -q) - 1)) == 0) {
+        *digits = c >> -q;
+        *exponent = 0;
+        return;
+    }
 
-            current = current->next;
+    // The rounding interval is [cbl, cbr] * 2^(q - 2), open when c is odd;
+    // its lower half is narrower at a power of two
+    bool even = (c & 1) == 0;
+    bool closer = fraction == 0 && biased > 1;
+    uint64_t cbl = 4 * c - 2 + closer;
+    uint64_t cb = 4 * c;
+    uint64_t cbr = 4 * c + 2;
+
+    // k = floor(log10(2^q)), or of 3/4 2^q at a power of two, so that the 
+    // interval scaled by 10^-k holds at most one multiple of 10
+    int64_t k = (q * 1262611 - (closer ? 524031 : 0)) >> 22;
+    int h = (int)(q + ((-k * 1741647) >> 19) + 1);
+    const uint64_t* g = POW10_128[-k - FORMAT_MIN_POW10];
+    uint64_t vbl = _round_to_odd(g, cbl << h);
+    uint64_t vb = _round_to_odd(g, cb << h);
+    uint64_t vbr = _round_to_odd(g, cbr << h);
+    uint64_t lower = vbl + !even;
+    uint64_t upper = vbr - !even;
+
+    // One digit fewer if exactly one neighboring multiple of 10 is inside
+    uint64_t s = vb / 4;
+    if (s >= 10) {
+        uint64_t sp = s / 10;
+        bool up_inside = lower <= 40 * sp;
+        bool wp_inside = 40 * sp + 40 <= upper;
+        if (up_inside != wp_inside) {
+            *digits = sp + wp_inside;
+            *exponent = (int)k + 1;
+            return;
         }
     }
+    bool u_inside = lower <= 4 * s;
+    bool w_inside = 4 * s + 4 <= upper;
+    if (u_inside != w_inside) {
+        *digits = s + w_inside;
+        *exponent = (int)k;
+        return;
+    }
+    // Both neighbors are inside: take the closer, ties to even
+    uint64_t mid = 4 * s + 2;
+    bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+    *digits = s + round_up;
+    *exponent = (int)k;
+}
+// --------------------------------------------------------------------------------
 
-    return merged;
+/**
+ * @brief Writes the decimal digits of v so that they end just before end and
+ *        returns a pointer to the first
+ *
+ * Blocks of eight digits are split into independent halves and pairs, which
+ * keeps the chain of divisions short.
+ */
+static char* _write_digits(uint64_t v, char* end) {
+    while (v >= 100000000) {
+        uint32_t block = (uint32_t)(v % 100000000);
+        v /= 100000000;
+        uint32_t high = block / 10000, low = block % 10000;
+        end -= 8;
+        memcpy(end, DIGIT_PAIRS + 2 * (high / 100), 2);
+        memcpy(end + 2, DIGIT_PAIRS + 2 * (high % 100), 2);
+        memcpy(end + 4, DIGIT_PAIRS + 2 * (low / 100), 2);
+        memcpy(end + 6, DIGIT_PAIRS + 2 * (low % 100), 2);
+    }
+    uint32_t rest = (uint32_t)v;
+    while (rest >= 100) {
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + 2 * (rest % 100), 2);
+        rest /= 100;
+    }
+    if (rest >= 10) {
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + 2 * rest, 2);
+    } else {
+        *--end = (char)('0' + rest);
+    }
+    return end;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-void clear_doublev_dict(dict_dv* dict) {
-    if (!dict) {
-        errno = EINVAL;
-        return;
-    }
+/**
+ * @brief Writes the shortest text of value to out, which must hold 
+ *        FORMAT_MAX_CHARS bytes, and returns its length
+ *
+ * The layout follows %g with a precision of 17: plain notation when the 
+ * decimal exponent is in [-4, 17) and d.ddde+XX otherwise.
+ */
+static size_t _format_double(double value, char* out) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    char* p = out;
+    if (bits >> 63) *p++ = '-';
+    uint64_t fraction = bits & ((1ull << 52) - 1);
+    uint32_t biased = (uint32_t)(bits >> 52) & 0x7FF;
+    if (biased == 0x7FF) {
+        memcpy(p, fraction ? "nan" : "inf", 3);
+        return (size_t)(p - out) + 3;
+    }
+    if (biased == 0 && fraction == 0) {
+        *p++ = '0';
+        return (size_t)(p - out);
+    }
+
+    uint64_t digits;
+    int exponent;
+    _shortest_decimal(fraction, biased, &digits, &exponent);
+    // Schubfach leaves up to 16 trailing zeros, removed in halving steps
+    if (digits % 10000000000000000ull == 0) { digits /= 10000000000000000ull; exponent += 16; }
+    if (digits % 100000000 == 0) { digits /= 100000000; exponent += 8; }
+    if (digits % 10000 == 0) { digits /= 10000; exponent += 4; }
+    if (digits % 100 == 0) { digits /= 100; exponent += 2; }
+    if (digits % 10 == 0) { digits /= 10; exponent += 1; }
+
+    // Copies have fixed lengths so that they compile to a few moves; text 
+    // and out have room for the bytes copied past the digits
+    char text[40];
+    char* d = _write_digits(digits, text + 20);
+    int n = (int)(text + 20 - d);
+    int x = n + exponent - 1;  // decimal exponent of the first digit
+
+    if (x < -4 || x >= 17) {
+        p[0] = d[0];
+        p[1] = '.';
+        memcpy(p + 2, d + 1, 16);
+        p += n > 1 ? n + 1 : 1;
+        *p++ = 'e';
+        *p++ = x < 0 ? '-' : '+';
+        unsigned e = (unsigned)(x < 0 ? -x : x);
+        if (e >= 100) *p++ = (char)('0' + e / 100);
+        memcpy(p, DIGIT_PAIRS + 2 * (e % 100), 2);
+        p += 2;
+    } else if (exponent >= 0) {
+        memcpy(p, d, 17);
+        memset(p + n, '0', 16);
+        p += n + exponent;
+    } else if (x >= 0) {
+        memcpy(p, d, 17);
+        p[x + 1] = '.';
+        memcpy(p + x + 2, d + x + 1, 16);
+        p += n + 1;
+    } else {
+        memcpy(p, "0.0000", 6);
+        p += 1 - x;
+        memcpy(p, d, 17);
+        p += n;
+    }
+    return (size_t)(p - out);
+}
+// --------------------------------------------------------------------------------
 
-    for (size_t i = 0; i < dict->alloc; ++i) {
-        dvdictNode* current = dict->keyValues[i].next;
-        dict->keyValues[i].next = NULL;
+typedef struct {
+    string_t* out;
+    const char* delim;
+    size_t delim_len;
+    size_t used;
+    bool ok;
+    char buf[FORMAT_CHUNK + 1];
+} dv_format_ctx;
+// --------------------------------------------------------------------------------
 
-        while (current) {
-            dvdictNode* next = current->next;
+// The chunk itself is left uninitialized
+static void _format_init(dv_format_ctx* ctx, string_t* out, const char* delim) {
+    ctx->out = out;
+    ctx->delim = delim;
+    ctx->delim_len = strlen(delim);
+    ctx->used = 0;
+    ctx->ok = true;
+}
+// --------------------------------------------------------------------------------
 
-            if (current->value) {
-                if (current->value->alloc_type == STATIC) {
-                    free(current->value);
-                } else {
-                    free_double_vector(current->value);
-                }
-            }
+static void _format_flush(dv_format_ctx* ctx) {
+    if (ctx->used == 0 || !ctx->ok) return;
+    ctx->buf[ctx->used] = '\0';
+    ctx->ok = string_lit_concat(ctx->out, ctx->buf);
+    ctx->used = 0;
+}
+// --------------------------------------------------------------------------------
 
-            free(current->key);
-            free(current);
-            current = next;
+/**
+ * @brief Appends n bytes of a null terminated text through the chunk
+ */
+static void _format_text(dv_format_ctx* ctx, const char* text, size_t n) {
+    if (ctx->used + n > FORMAT_CHUNK) {
+        _format_flush(ctx);
+        if (n > FORMAT_CHUNK) {
+            // Only an unusually long key or delimiter skips the chunk
+            if (ctx->ok) ctx->ok = string_lit_concat(ctx->out, text);
+            return;
         }
     }
+    memcpy(ctx->buf + ctx->used, text, n);
+    ctx->used += n;
+}
+// --------------------------------------------------------------------------------
 
-    dict->hash_size = 0;
-    dict->len = 0;
+static inline void _format_value(dv_format_ctx* ctx, double value) {
+    if (ctx->used + FORMAT_MAX_CHARS > FORMAT_CHUNK) _format_flush(ctx);
+    ctx->used += _format_double(value, ctx->buf + ctx->used);
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-bool foreach_doublev_dict(const dict_dv* dict, dict_dv_iterator iter, void* user_data) {
-    if (!dict || !iter) {
+bool format_double_vector(const double_v* vec, const char* delim, string_t* out) {
+    if (!vec || !vec->data || !delim || !get_string(out)) {
         errno = EINVAL;
         return false;
     }
-
-    for (size_t i = 0; i < dict->alloc; ++i) {
-        dvdictNode* current = dict->keyValues[i].next;
-        while (current) {
-            iter(current->key, current->value, user_data);
-            current = current->next;
-        }
+    dv_format_ctx ctx;
+    _format_init(&ctx, out, delim);
+    for (size_t i = 0; i < vec->len && ctx.ok; ++i) {
+        if (i > 0) _format_text(&ctx, delim, ctx.delim_len);
+        _format_value(&ctx, vec->data[i]);
     }
+    _format_flush(&ctx);
+    return ctx.ok;
+}
+// --------------------------------------------------------------------------------
 
-    return true;
+static void _format_entry(const char* key, double value, void* user_data) {
+    dv_format_ctx* ctx = user_data;
+    if (!ctx->ok) return;
+    _format_text(ctx, key, strlen(key));
+    _format_text(ctx, ctx->delim, ctx->delim_len);
+    _format_value(ctx, value);
+    _format_text(ctx, "\n", 1);
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
-string_v* get_keys_doublev_dict(const dict_dv* dict) {
-    if (!dict) {
+bool format_double_dict(const dict_d* dict, const char* delim, string_t* out) {
+    if (!dict || !delim || !get_string(out)) {
         errno = EINVAL;
-        return NULL;
-    }
-
-    string_v* vec = init_str_vector(dict->hash_size);
-    if (!vec) {
-        errno = ENOMEM;
-        return NULL;
-    }
-
-    for (size_t i = 0; i < dict->alloc; ++i) {
-        for (dvdictNode* current = dict->keyValues[i].next; current; current = current->next) {
-            if (!push_back_str_vector(vec, current->key)) {
-                free_str_vector(vec);
-                errno = ENOMEM;
-                return NULL;
-            }
-        }
+        return false;
     }
-
-    return vec;
+    dv_format_ctx ctx;
+    _format_init(&ctx, out, delim);
+    foreach_double_dict(dict, _format_entry, &ctx);
+    _format_flush(&ctx);
+    return ctx.ok;
 }
 // ================================================================================
 // ================================================================================
@@ -27,6 +27,16 @@ extern "C" {
 // ================================================================================ 
 // ================================================================================ 
 
+/**
+ * @macro DOUBLE_VECTOR_ALIGNMENT
+ * @brief Byte alignment of the data buffer of dynamically allocated vectors
+ *
+ * 64 bytes is a cache line and the width of an AVX-512 register, so buffers
+ * returned by c_double_ptr can be used with aligned SIMD loads.
+ */
+#define DOUBLE_VECTOR_ALIGNMENT 64
+// --------------------------------------------------------------------------------    
+
 #ifndef ITER_DIR_H
 #define ITER_DIR_H
     /**
@@ -51,29 +61,218 @@ extern "C" {
     /**
      * @enum alloc_t 
      * @brief An enum to discern if an array is statically or allocated 
+     *
+     * MAPPED vectors point into a memory mapped file, see 
+     * open_mapped_double_vector.  VIEW vectors borrow a window of another 
+     * vector or array, see view_double_vector.
      */
     typedef enum {
         STATIC,
-        DYNAMIC
+        DYNAMIC,
+        MAPPED,
+        VIEW
     } alloc_t;
 
 #endif /*ALLOC_H*/
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum growth_t
+ * @brief Describes how a dynamically allocated vector grows when it runs out of space
+ *
+ * @attribute GROWTH_DEFAULT Double the capacity while it is below VEC_THRESHOLD,
+ *            then grow by a factor of 1.5
+ * @attribute GROWTH_GEOMETRIC Multiply the capacity by a user supplied factor
+ * @attribute GROWTH_FIXED Add a user supplied number of elements
+ * @attribute GROWTH_MREMAP Geometric growth, but large buffers are backed by an
+ *            anonymous mmap and grown with mremap so the kernel can move pages
+ *            instead of copying them.  Falls back to GROWTH_GEOMETRIC on
+ *            platforms without mremap
+ */
+typedef enum {
+    GROWTH_DEFAULT,
+    GROWTH_GEOMETRIC,
+    GROWTH_FIXED,
+    GROWTH_MREMAP
+} growth_t;
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum simd_level_t
+ * @brief The instruction sets used by the vectorized kernels
+ *
+ * @attribute SIMD_SCALAR Portable C loops
+ * @attribute SIMD_SSE2 128 bit SSE2 kernels
+ * @attribute SIMD_AVX2 256 bit AVX2 kernels that use FMA
+ * @attribute SIMD_AVX512 512 bit AVX-512F kernels, also requires AVX2
+ */
+typedef enum {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+} simd_level_t;
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum sum_mode_t
+ * @brief Selects how sums of a vector are accumulated
+ *
+ * @attribute SUM_NAIVE Plain SIMD accumulation, fastest
+ * @attribute SUM_COMPENSATED Vectorized Kahan-Babuska-Neumaier summation whose 
+ *            error does not grow with the vector length
+ */
+typedef enum {
+    SUM_NAIVE,
+    SUM_COMPENSATED
+} sum_mode_t;
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum scan_op_t
+ * @brief Selects the operation of a cumulative scan
+ *
+ * @attribute SCAN_SUM Running sum, compensated when the vector uses SUM_COMPENSATED
+ * @attribute SCAN_PROD Running product
+ * @attribute SCAN_MIN Running minimum
+ * @attribute SCAN_MAX Running maximum
+ */
+typedef enum {
+    SCAN_SUM,
+    SCAN_PROD,
+    SCAN_MIN,
+    SCAN_MAX
+} scan_op_t;
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum arith_op_t
+ * @brief Selects the element-wise operation between two vectors
+ *
+ * @attribute ARITH_ADD a[i] + b[i]
+ * @attribute ARITH_SUB a[i] - b[i]
+ * @attribute ARITH_MUL a[i] * b[i]
+ * @attribute ARITH_DIV a[i] / b[i]
+ */
+typedef enum {
+    ARITH_ADD,
+    ARITH_SUB,
+    ARITH_MUL,
+    ARITH_DIV
+} arith_op_t;
+// --------------------------------------------------------------------------------    
 
 /**
-* @struct float_v
-* @brief Dynamic array (vector) container for float objects
+ * @enum norm_t
+ * @brief Selects the vector norm computed by norm_double_vector
+ *
+ * @attribute NORM_L1 Sum of the absolute values
+ * @attribute NORM_L2 Euclidean length, the square root of the sum of squares
+ * @attribute NORM_INF Largest absolute value
+ */
+typedef enum {
+    NORM_L1,
+    NORM_L2,
+    NORM_INF
+} norm_t;
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum map_mode_t
+ * @brief Selects how open_mapped_double_vector maps a file
+ *
+ * @attribute MAPPED_READ_ONLY The pages are shared with the file and cannot be
+ *            written
+ * @attribute MAPPED_COPY_ON_WRITE Writes go to private copies of the touched 
+ *            pages and never reach the file
+ * @attribute MAPPED_READ_WRITE Writes go to the file, see 
+ *            sync_mapped_double_vector
+ */
+typedef enum {
+    MAPPED_READ_ONLY,
+    MAPPED_COPY_ON_WRITE,
+    MAPPED_READ_WRITE
+} map_mode_t;
+// --------------------------------------------------------------------------------    
+
+/**
+ * @enum map_advice_t
+ * @brief Access pattern hint passed to madvise by advise_mapped_double_vector
+ *
+ * @attribute ADVICE_NORMAL Default read ahead
+ * @attribute ADVICE_SEQUENTIAL Aggressive read ahead; pages behind the reader 
+ *            may be dropped early
+ * @attribute ADVICE_RANDOM No read ahead
+ * @attribute ADVICE_WILLNEED Start reading the whole file in the background
+ * @attribute ADVICE_DONTNEED The pages are not needed soon and may be dropped;
+ *            rejected for MAPPED_COPY_ON_WRITE, whose dropped pages would lose
+ *            their changes
+ */
+typedef enum {
+    ADVICE_NORMAL,
+    ADVICE_SEQUENTIAL,
+    ADVICE_RANDOM,
+    ADVICE_WILLNEED,
+    ADVICE_DONTNEED
+} map_advice_t;
+// --------------------------------------------------------------------------------    
+
+/**
+* @struct double_v
+* @brief Dynamic array (vector) container for double objects
 *
 * This structure manages a resizable array of double objects with automatic
-* memory management and capacity handling.
+* memory management and capacity handling.  The growth fields are zero for
+* arrays created with init_double_array, which selects GROWTH_DEFAULT.
+*
+* The sorted flag is set by sort_double_vector and is_sorted_double_vector and
+* kept by the library functions only while the data stays ascending, e.g. a
+* push_back of a value that is not smaller than the last one or any pop.  Writes
+* through data or c_double_ptr bypass this tracking; c_double_ptr clears the 
+* flag, and code that writes through data directly must clear it as well.
+*
+* In deque mode (set_double_vector_deque) pop_front_double_vector advances
+* data instead of moving the elements, and push_front_double_vector fills the
+* head elements freed in front of data.  alloc always counts the capacity 
+* from data, so the buffer holds head + alloc elements starting at data - head.
 */
 typedef struct {
     double* data;
     size_t len;
     size_t alloc;
     alloc_t alloc_type;
+    growth_t growth;       /**< Growth policy used when the vector is full */
+    double growth_factor;  /**< Multiplier for GROWTH_GEOMETRIC and GROWTH_MREMAP */
+    size_t growth_step;    /**< Number of elements added by GROWTH_FIXED */
+    bool anon_mmap;        /**< true if data was obtained from mmap rather than malloc */
+    sum_mode_t sum_mode;   /**< Summation used by sum, average, stdev and cum_sum */
+    bool sorted;           /**< true if data is known to be ascending with NaN last */
+    size_t head;           /**< Free elements in front of data, non zero only in deque mode */
+    bool deque;            /**< true if pop_front and push_front work in O(1) */
+    map_mode_t map_mode;   /**< Access of a MAPPED vector */
 } double_v;
 // --------------------------------------------------------------------------------
 
+/**
+* @struct double_stats_t
+* @brief Summary statistics returned by describe_double_vector
+*
+* NaN values are skipped and only counted.  The variance is the population
+* variance, matching stdev_double_vector.
+*/
+typedef struct {
+    size_t count;      /**< Number of values that are not NaN */
+    size_t nan_count;  /**< Number of NaN values that were skipped */
+    size_t inf_count;  /**< Number of +/- Inf values, included in the other fields */
+    double min;
+    double max;
+    double sum;
+    double mean;
+    double variance;
+    double stdev;
+} double_stats_t;
+// --------------------------------------------------------------------------------
+
 /**
 * @function init_double_vector
 * @brief Initializes a new dynamically allocated double vector with specified initial capacity
@@ -104,6 +303,46 @@ double_v* init_double_vector(size_t buffer);
 double* c_double_ptr(double_v* vec);
 // -------------------------------------------------------------------------------- 
 
+/**
+ * @brief Returns a VIEW of len elements of vec starting at start, without 
+ *        copying them
+ *
+ * The view is returned by value and owns nothing, so it is not freed.  Every 
+ * function that reads a vector or changes its elements in place accepts it, 
+ * e.g. sum_double_vector, describe_double_vector, sort_double_vector or 
+ * affine_double_vector, and changes are seen by vec.  Its length is fixed: 
+ * functions that add or remove elements fail with EINVAL.  Writes through 
+ * the view cannot be tracked in vec, so the sorted flag of vec is cleared as 
+ * by c_double_ptr, and later changes to vec cannot be tracked in the view, so
+ * the view is never marked sorted; is_sorted_double_vector sets its flag in 
+ * one scan.  The view stays valid until vec is resized, reallocated or freed.
+ * Windows, chunks and sliding windows are views at successive offsets.  A 
+ * view of a MAPPED_READ_ONLY mapping is read only as well.
+ *
+ * @param vec The vector to borrow from, which may itself be a view
+ * @param start Index of the first element of the view
+ * @param len Number of elements in the view
+ * @return A VIEW vector, or one with data NULL after an error, which every
+ *         function rejects.  Sets errno to EINVAL if vec is NULL and ERANGE if
+ *         the range does not lie within vec
+ */
+double_v view_double_vector(double_v* vec, size_t start, size_t len);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Returns a VIEW of len doubles of an existing array
+ *
+ * The array is not copied and must outlive the view.  The view behaves as 
+ * one returned by view_double_vector and is not marked sorted.
+ *
+ * @param data The first element of the array
+ * @param len Number of elements in the view
+ * @return A VIEW vector, or one with data NULL and errno set to EINVAL if 
+ *         data is NULL
+ */
+double_v view_double_array(double* data, size_t len);
+// -------------------------------------------------------------------------------- 
+
 /**
 * @function push_back_double_vector
 * @brief Adds a double value to the end of the vector
@@ -147,6 +386,40 @@ bool push_front_double_vector(double_v* vec, const double value);
 bool insert_double_vector(double_v* vec, const double value, size_t index);
 // --------------------------------------------------------------------------------
 
+/**
+* @function extend_double_vector
+* @brief Appends n values from a C array to the end of the vector
+*
+* The vector is grown at most once and the values are copied with a single
+* memcpy, which makes this the preferred way to load large batches of data.
+* src may point into vec itself.
+*
+* @param vec Target double vector
+* @param src Pointer to the values to append
+* @param n Number of values to append
+* @return true if successful, false on error
+*         Sets errno to EINVAL for NULL inputs or when a static array is too
+*         small, ERANGE on size overflow or ENOMEM on allocation failure
+*/
+bool extend_double_vector(double_v* vec, const double* src, size_t n);
+// --------------------------------------------------------------------------------
+
+/**
+* @function append_double_vector
+* @brief Appends the contents of one double vector to the end of another
+*
+* Equivalent to extend_double_vector(vec, other->data, other->len).  other may
+* be the same vector as vec.
+*
+* @param vec Target double vector
+* @param other Vector or array whose values are appended
+* @return true if successful, false on error
+*         Sets errno to EINVAL for NULL inputs or when a static array is too
+*         small, ERANGE on size overflow or ENOMEM on allocation failure
+*/
+bool append_double_vector(double_v* vec, const double_v* other);
+// --------------------------------------------------------------------------------
+
 /**
 * @function double_vector_index
 * @brief Retrieves pointer to string_t at specified index
@@ -181,13 +454,29 @@ const size_t double_vector_size(const double_v* vec);
 const size_t double_vector_alloc(const double_v* vec);
 // --------------------------------------------------------------------------------
 
+/**
+* @function double_vector_alignment
+* @brief Returns the byte alignment of the data buffer of a vector
+*
+* Dynamically allocated vectors are aligned to at least
+* DOUBLE_VECTOR_ALIGNMENT bytes, except after pop_front_double_vector in deque
+* mode, which linearize_double_vector undoes.  Static arrays report the alignment the
+* compiler happened to give them.  The result is capped at 4096 bytes.
+*
+* @param vec Double vector to query
+* @return The largest power of two that divides the address of the data buffer,
+*         or 0 on error.  Sets errno to EINVAL for NULL input
+*/
+size_t double_vector_alignment(const double_v* vec);
+// --------------------------------------------------------------------------------
+
 /**
 * @function pop_back_double_vector
 * @brief Removes and returns last double value in vector
 *
 * @param vec Source double vector
 * @return Pointer to removed double object, or NULL if vector empty
-*         Sets errno to EINVAL for NULL input
+*         Sets errno to EINVAL for NULL input or a MAPPED or VIEW vector
 */
 double pop_back_double_vector(double_v* vec);
 // -------------------------------------------------------------------------------- 
@@ -200,7 +489,7 @@ double pop_back_double_vector(double_v* vec);
 *
 * @param vec Source string vector
 * @return Pointer to removed double object, or NULL if vector empty
-*         Sets errno to EINVAL for NULL input
+*         Sets errno to EINVAL for NULL input or a MAPPED or VIEW vector
 */
 double pop_front_double_vector(double_v* vec);
 // --------------------------------------------------------------------------------
@@ -214,11 +503,79 @@ double pop_front_double_vector(double_v* vec);
 * @param vec Source double vector
 * @param index Position to remove from
 * @return Pointer to removed double_t object, or NULL on error
-*         Sets errno to EINVAL for NULL input or ERANGE if index out of bounds
+*         Sets errno to EINVAL for NULL input or a MAPPED or VIEW vector, or 
+*         ERANGE if index out of bounds
 */
 double pop_any_double_vector(double_v* vec, size_t index);
 // --------------------------------------------------------------------------------
 
+/**
+* @function erase_range_double_vector
+* @brief Removes count elements starting at start
+*
+* The tail is moved once, so erasing a range costs O(len) regardless of count.
+*
+* @param vec Target double vector
+* @param start Index of the first element to remove
+* @param count Number of elements to remove
+* @return true if successful, false otherwise.
+*         Sets errno to EINVAL for NULL input or a MAPPED or VIEW vector, or 
+*         ERANGE if the range extends past the end of the vector
+*/
+bool erase_range_double_vector(double_v* vec, size_t start, size_t count);
+// --------------------------------------------------------------------------------
+
+/**
+* @function remove_value_double_vector
+* @brief Removes every element equal to value or within tol of it
+*
+* The remaining elements keep their order and are compacted in one pass.  A 
+* sorted vector removes its one run of matches with a binary search and a 
+* single move.  A NaN value removes the NaN elements.
+*
+* @param vec Target double vector
+* @param value Value to remove
+* @param tol Largest distance from value that still matches, at least 0
+* @return The number of removed elements, or LONG_MAX on error.
+*         Sets errno to EINVAL for NULL input, a MAPPED or VIEW vector or a 
+*         negative or NaN tol
+*/
+size_t remove_value_double_vector(double_v* vec, double value, double tol);
+// --------------------------------------------------------------------------------
+
+/**
+* @function remove_nan_double_vector
+* @brief Removes every NaN element, keeping the order of the others
+*
+* @param vec Target double vector
+* @return The number of removed elements, or LONG_MAX on error.
+*         Sets errno to EINVAL for NULL input or a MAPPED or VIEW vector
+*/
+size_t remove_nan_double_vector(double_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+* @brief Predicate called with each value and the user_data of remove_if
+*/
+typedef bool (*double_predicate)(double value, void* user_data);
+
+/**
+* @function remove_if_double_vector
+* @brief Removes every element for which pred returns true
+*
+* pred is called once per element, in order.  The remaining elements keep 
+* their order and are compacted in one pass.
+*
+* @param vec Target double vector
+* @param pred Predicate selecting the elements to remove
+* @param user_data Passed through to pred
+* @return The number of removed elements, or LONG_MAX on error.
+*         Sets errno to EINVAL for NULL input, a MAPPED or VIEW vector or a 
+*         NULL pred
+*/
+size_t remove_if_double_vector(double_v* vec, double_predicate pred, void* user_data);
+// --------------------------------------------------------------------------------
+
 /**
 * @function free_double_vector
 * @brief Frees all memory associated with string vector
@@ -227,7 +584,8 @@ double pop_any_double_vector(double_v* vec, size_t index);
 *
 * @param vec Double vector to free
 * @return void
-*         Sets errno to EINVAL for NULL input
+*         Sets errno to EINVAL for NULL input and for STATIC and VIEW vectors,
+*         which own no heap memory
 */
 void free_double_vector(double_v* vec);
 // --------------------------------------------------------------------------------
@@ -244,175 +602,1260 @@ void free_double_vector(double_v* vec);
 void _free_double_vector(double_v** vec);
 // --------------------------------------------------------------------------------
 
-#if defined(__GNUC__) || defined (__clang__)
-    /**
-     * @macro FLTVEC_GBC
-     * @brief A macro for enabling automatic cleanup of double vector objects.
-     *
-     * This macro uses the cleanup attribute to automatically call `_free_double_vector`
-     * when the scope ends, ensuring proper memory management.
-     */
-    #define DBLEVEC_GBC __attribute__((cleanup(_free_double_vector)))
-#endif
-// -------------------------------------------------------------------------------- 
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro FLTVEC_GBC
+     * @brief A macro for enabling automatic cleanup of double vector objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_double_vector`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define DBLEVEC_GBC __attribute__((cleanup(_free_double_vector)))
+#endif
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function reverse_double_vector
+ * @brief Reverses the order of elements in a double vector in place.
+ *
+ * The function reverses the order of elements by swapping elements from the
+ * beginning and end of the vector until the middle is reached.
+ *
+ * @param vec double vector to reverse
+ * @return void
+ *         Sets errno to EINVAL if vec is NULL or invalid, or EPERM for 
+ *         a MAPPED_READ_ONLY mapping
+ */
+void reverse_double_vector(double_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function swap_double
+ * @brief Swaps the contents of two double objects.
+ *
+ * Performs an in-place swap of double values
+ *
+ * @param a Pointer to first double object
+ * @param b Pointer to second double object
+ * @return void
+ *         Sets errno to EINVAL if either input is NULL
+ */
+void swap_double(double* a, double* b);
+// --------------------------------------------------------------------------------
+
+/**
+* @function sort_double_vector
+* @brief Sorts a double vector in ascending or descending order.
+*
+* Vectors of 2048 or more elements are sorted with an O(n) LSD radix sort on
+* the IEEE-754 bit patterns, which needs one scratch buffer of len doubles.
+* Smaller vectors, or any vector when the scratch buffer cannot be allocated,
+* use a QuickSort with a vectorized partition and a bitonic sorting network
+* for small ranges. Sort direction is determined by the iter_dir parameter.
+* NaN values are placed at the end in both directions.
+*
+* Vectors of at least double_parallel_threshold() elements are split into one
+* run per thread (see set_double_thread_count); the runs are radix sorted in
+* parallel and combined with parallel merges.
+*
+* A vector that carries the sorted flag is returned as it is for FORWARD and
+* only reversed for REVERSE.  A FORWARD sort sets the flag.
+*
+* @param vec double vector to sort
+* @param direction FORWARD for ascending order, REVERSE for descending
+* @return void
+*         Sets errno to EINVAL if vec is NULL or invalid, or EPERM if the 
+*         elements must move but lie in a MAPPED_READ_ONLY mapping
+*/
+void sort_double_vector(double_v* vec, iter_dir direction);
+// --------------------------------------------------------------------------------
+
+/**
+* @function is_sorted_double_vector
+* @brief Tests whether a vector is in ascending order with NaN values last
+*
+* Returns immediately when the vector carries the sorted flag.  Otherwise the
+* data is scanned once and a positive result is recorded in the flag, so later
+* calls, binary searches and FORWARD sorts are free.
+*
+* @param vec double vector or array to test
+* @return true if the data is ascending, false otherwise.  Sets errno to 
+*         EINVAL and returns false if vec is NULL
+*/
+bool is_sorted_double_vector(double_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+* @function argsort_double_vector
+* @brief Returns the permutation that sorts a vector, leaving the vector unchanged
+*
+* Element i of the result is the position in vec of the i-th value in sorted
+* order, so permute_double_vector(vec, perm) sorts vec and the same permutation
+* can reorder other vectors of the same length to match.  The sort is a stable
+* LSD radix sort: equal values keep their original order and NaN values are 
+* placed last in both directions.
+*
+* @param vec double vector or array to rank
+* @param direction FORWARD for ascending order, REVERSE for descending
+* @return A malloc'ed array of vec->len indices that the caller must free, or 
+*         NULL on failure.  Sets errno to EINVAL if vec is NULL or empty and 
+*         ENOMEM if memory cannot be allocated
+*/
+size_t* argsort_double_vector(const double_v* vec, iter_dir direction);
+// --------------------------------------------------------------------------------
+
+/**
+* @function permute_double_vector
+* @brief Reorders a vector in place so that element i becomes the old element perm[i]
+*
+* The permutation is applied cycle by cycle without copying the data, using one
+* bit of temporary memory per element.  Works with dynamic vectors and static 
+* arrays.
+*
+* @param vec double vector or array to reorder
+* @param perm Array of vec->len distinct indices smaller than vec->len
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec or
+*         perm is NULL or perm is not a permutation of 0 .. len - 1, in which 
+*         case vec is unchanged, EPERM for a MAPPED_READ_ONLY mapping and 
+*         ENOMEM if memory cannot be allocated
+*/
+bool permute_double_vector(double_v* vec, const size_t* perm);
+// --------------------------------------------------------------------------------
+
+/**
+* @function nth_double_vector
+* @brief Returns the value that a FORWARD sort would place at index k
+*
+* Uses an introselect built on the vectorized quicksort partition, which runs
+* in linear expected time and falls back to the O(n) radix sort if the ranges 
+* stop shrinking.  NaN values rank last, so a k past the last numeric value 
+* returns NaN.
+*
+* @param vec double vector or array to search
+* @param k Zero based rank of the value to return
+* @param in_place If true the data of vec is reordered: NaN values move to the
+*        end and the value at index k is the one a sort would place there, with
+*        no larger value before it and no smaller value after it.  If false the
+*        values are copied to a scratch buffer and vec is unchanged
+* @return The k-th smallest value, or DBL_MAX on failure.  Sets errno to EINVAL 
+*         if vec is NULL, ENODATA if vec is empty, ERANGE if k >= len, EPERM if
+*         in_place is set for a MAPPED_READ_ONLY mapping and ENOMEM if the 
+*         scratch buffer cannot be allocated
+*/
+double nth_double_vector(double_v* vec, size_t k, bool in_place);
+// --------------------------------------------------------------------------------
+
+/**
+* @function median_double_vector
+* @brief Returns the median of the values that are not NaN in linear expected time
+*
+* For an even number of values the two middle values are averaged.  Returns
+* NaN if every value is NaN.
+*
+* @param vec double vector or array to search
+* @param in_place If true the data of vec is reordered around the median, 
+*        otherwise a scratch buffer is used and vec is unchanged
+* @return The median, or DBL_MAX on failure.  Sets errno to EINVAL if vec is 
+*         NULL, ENODATA if vec is empty, EPERM if in_place is set for a 
+*         MAPPED_READ_ONLY mapping and ENOMEM if the scratch buffer cannot be
+*         allocated
+*/
+double median_double_vector(double_v* vec, bool in_place);
+// --------------------------------------------------------------------------------
+
+/**
+* @function percentiles_double_vector
+* @brief Computes several percentiles of the values that are not NaN in one call
+*
+* Percentile q is interpolated linearly between the two values around 
+* position q / 100 * (n - 1) of the sorted data, the default method of NumPy.  
+* The ranks needed by all percentiles are selected in ascending order, each 
+* search starting past the previous rank, so a set of percentiles costs little
+* more than one.  Outputs are NaN if every value is NaN.
+*
+* @param vec double vector or array to search
+* @param qs Array of nq percentiles between 0 and 100
+* @param nq Number of percentiles
+* @param out Array of nq doubles that receives the results in the order of qs
+* @param in_place If true the data of vec is reordered, otherwise a scratch
+*        buffer is used and vec is unchanged
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec, qs
+*         or out is NULL or a percentile is outside [0, 100], ENODATA if vec is
+*         empty, EPERM if in_place is set for a MAPPED_READ_ONLY mapping and 
+*         ENOMEM if memory cannot be allocated
+*/
+bool percentiles_double_vector(double_v* vec, const double* qs, size_t nq, 
+                               double* out, bool in_place);
+// --------------------------------------------------------------------------------
+
+/**
+* @function topk_double_vector
+* @brief Returns the k largest or smallest values of a vector without a full sort
+*
+* The k values are found with one selection and only they are sorted, so the
+* cost is O(n + k log k).  NaN values are never returned; if fewer than k 
+* values are not NaN the result holds all of them.
+*
+* @param vec double vector or array to search
+* @param k Number of values to return, between 1 and len
+* @param direction FORWARD returns the k smallest values in ascending order, 
+*        REVERSE the k largest values in descending order
+* @param in_place If true the data of vec is reordered, otherwise a scratch
+*        buffer is used and vec is unchanged
+* @return A new dynamically allocated vector that the caller must free, or NULL
+*         on failure.  Sets errno to EINVAL if vec is NULL, ENODATA if vec is 
+*         empty, ERANGE if k is 0 or larger than len, EPERM if in_place is set
+*         for a MAPPED_READ_ONLY mapping and ENOMEM if memory cannot be 
+*         allocated
+*/
+double_v* topk_double_vector(double_v* vec, size_t k, iter_dir direction, bool in_place);
+// --------------------------------------------------------------------------------
+
+/**
+* @function trim_double_vector
+* @brief Trims all un-necessary memory from a vector
+*
+* @param vec double vector to trim
+* @return void
+*         Sets errno to EINVAL if vec is NULL or invalid
+*/
+void trim_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function reserve_double_vector
+* @brief Ensures that a vector can hold at least capacity elements without reallocating
+*
+* The buffer is grown to exactly capacity if it is currently smaller.  The new
+* capacity is not initialized, it becomes defined as values are added.  The
+* length of the vector is not changed.
+*
+* @param vec double vector to reserve space in
+* @param capacity The minimum number of elements the vector must be able to hold
+* @return true if successful, false otherwise.
+*         Sets errno to EINVAL if vec is NULL or a static array is too small,
+*         ERANGE on size overflow, or ENOMEM on allocation failure
+*/
+bool reserve_double_vector(double_v* vec, size_t capacity);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function resize_double_vector
+* @brief Changes the number of elements in a vector
+*
+* Growing the vector sets the new elements to 0.0 and applies the growth policy
+* once.  Shrinking the vector only changes the length, use trim_double_vector
+* to release memory.
+*
+* @param vec double vector to resize
+* @param new_len The new number of elements
+* @return true if successful, false otherwise.
+*         Sets errno to EINVAL if vec is NULL, MAPPED or a VIEW or a static 
+*         array is too small, ERANGE on size overflow, or ENOMEM on allocation
+*         failure
+*/
+bool resize_double_vector(double_v* vec, size_t new_len);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function set_double_vector_growth
+* @brief Selects the growth policy of a dynamically allocated vector
+*
+* param is the growth factor for GROWTH_GEOMETRIC and GROWTH_MREMAP and must
+* be larger than 1.0.  For GROWTH_FIXED it is the number of elements added on
+* each growth step and must be at least 1.  It is ignored for GROWTH_DEFAULT.
+*
+* @param vec A dynamically allocated double vector
+* @param policy The growth policy
+* @param param The growth factor or step described above
+* @return true if successful, false otherwise.
+*         Sets errno to EINVAL for a NULL or static vector or an invalid param
+*/
+bool set_double_vector_growth(double_v* vec, growth_t policy, double param);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function set_double_vector_deque
+* @brief Turns deque mode on or off
+*
+* In deque mode pop_front_double_vector and push_front_double_vector run in
+* amortized O(1) time by moving data within the buffer rather than moving the
+* elements.  The freed front space is reused by push_back once it reaches half
+* the length, so a FIFO workload keeps a bounded buffer.  Turning the mode off
+* moves the elements back to the start of the buffer.
+*
+* @param vec A double vector, dynamic or static
+* @param enable true to turn deque mode on
+* @return true if successful, false otherwise with errno set to EINVAL for a
+*         NULL vector or a VIEW, or EPERM for a MAPPED_READ_ONLY mapping
+*/
+bool set_double_vector_deque(double_v* vec, bool enable);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function linearize_double_vector
+* @brief Moves the elements of a deque to the start of its buffer
+*
+* After pop_front in deque mode data may not be aligned to 
+* DOUBLE_VECTOR_ALIGNMENT.  This call restores the aligned, contiguous layout 
+* that the SIMD kernels prefer and makes the front space available at the back.
+* It does nothing for a vector that has no free space in front.
+*
+* @param vec A double vector
+* @return vec->data, or NULL with errno set to EINVAL for a NULL vector
+*/
+double* linearize_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function open_mapped_double_vector
+* @brief Maps a file of raw doubles into memory as a MAPPED vector
+*
+* The file must hold native byte order doubles and nothing else.  No data is
+* read up front; pages are loaded by the operating system when they are first
+* touched, so a file larger than the physical memory can be reduced, searched
+* or scanned with every function that only reads the vector.  The vector has
+* len == alloc and cannot grow or shrink: functions that add or remove 
+* elements fail with EINVAL.  With MAPPED_READ_ONLY, functions that change the
+* elements in place, such as sort_double_vector or affine_double_vector, fail
+* with EPERM and leave the file untouched.  The sorted flag
+* starts cleared; is_sorted_double_vector sets it without writing.  Free the 
+* vector with close_mapped_double_vector or free_double_vector.
+*
+* @param path Path of the file
+* @param mode How the file is mapped
+* @return A pointer to the vector, or NULL on failure.  Sets errno to EINVAL 
+*         if path is NULL, mode is invalid or the file size is not a multiple
+*         of sizeof(double), ENODATA if the file is empty, ENOMEM if memory 
+*         cannot be allocated and ENOSYS on platforms without mmap.  Errors of
+*         open and mmap are passed through
+*/
+double_v* open_mapped_double_vector(const char* path, map_mode_t mode);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function sync_mapped_double_vector
+* @brief Writes the modified pages of a MAPPED_READ_WRITE vector to its file
+*
+* Blocks until the data is written.  Read only and copy-on-write mappings have
+* nothing to write and return true.
+*
+* @param vec A MAPPED vector
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec is
+*         not a MAPPED vector; errors of msync are passed through
+*/
+bool sync_mapped_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function advise_mapped_double_vector
+* @brief Tells the operating system how a MAPPED vector will be accessed
+*
+* ADVICE_SEQUENTIAL suits reductions and scans, ADVICE_RANDOM suits binary
+* searches of a sorted file.  The advice is only a hint; a build where madvise
+* is not declared, such as a strict ISO C build on glibc, checks it and then
+* ignores it.
+*
+* @param vec A MAPPED vector
+* @param advice The expected access pattern
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec is
+*         not a MAPPED vector, advice is invalid or ADVICE_DONTNEED is given
+*         for a copy-on-write mapping; errors of madvise are passed through
+*/
+bool advise_mapped_double_vector(double_v* vec, map_advice_t advice);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function close_mapped_double_vector
+* @brief Unmaps the file of a MAPPED vector and frees the vector
+*
+* Changes of a MAPPED_READ_WRITE vector reach the file even without a prior
+* sync_mapped_double_vector; the sync only controls when.
+*
+* @param vec A MAPPED vector
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec is
+*         not a MAPPED vector; errors of munmap are passed through
+*/
+bool close_mapped_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function binary_search_double_vector
+* @brief Searches a double vector to find the index where a value exists
+*
+* @param vec double vector object
+* @param value The value to search for
+* @param tolerance The double tolerance for finding a value 
+* @param sort_first true if the vector or array needs to be sorted, false otherwise.
+*        The sort is skipped when the vector is known to be sorted already
+* @return The index where a value exists, LONG_MAX if the value is not in the array.
+*         Sets errno to EINVAL if vec is NULL or invalid, ENODATA if the array is 
+*         not populated, or EPERM if sort_first must sort a MAPPED_READ_ONLY
+*         mapping
+*/
+size_t binary_search_double_vector(double_v* vec, double value, double tolerance, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function lower_bound_double_vector
+* @brief Returns the first position whose value is not less than value
+*
+* The data must be ascending with NaN last, as left by a FORWARD sort.  The 
+* search is a branchless binary search whose running time does not depend on
+* the data.  A NaN query returns the position of the first NaN.
+*
+* @param vec double vector or array to search
+* @param value The value to locate
+* @param sort_first true to sort the vector first, which is skipped when the 
+*        vector is known to be sorted
+* @return A position between 0 and len, or LONG_MAX on failure.  Sets errno to
+*         EINVAL if vec is NULL, or EPERM if sort_first must sort a 
+*         MAPPED_READ_ONLY mapping
+*/
+size_t lower_bound_double_vector(double_v* vec, double value, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function upper_bound_double_vector
+* @brief Returns the first position whose value is greater than value
+*
+* The data must be ascending with NaN last.  A NaN query returns len.
+*
+* @param vec double vector or array to search
+* @param value The value to locate
+* @param sort_first true to sort the vector first, which is skipped when the 
+*        vector is known to be sorted
+* @return A position between 0 and len, or LONG_MAX on failure.  Sets errno to
+*         EINVAL if vec is NULL, or EPERM if sort_first must sort a 
+*         MAPPED_READ_ONLY mapping
+*/
+size_t upper_bound_double_vector(double_v* vec, double value, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function equal_range_double_vector
+* @brief Finds the range of positions whose values equal value
+*
+* On success [*first, *last) holds every value equal to value, and both are 
+* the insertion point when there is none.  The data must be ascending with 
+* NaN last; a NaN query returns the range of NaN values.
+*
+* @param vec double vector or array to search
+* @param value The value to locate
+* @param first Receives the lower bound
+* @param last Receives the upper bound
+* @param sort_first true to sort the vector first, which is skipped when the 
+*        vector is known to be sorted
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec, 
+*         first or last is NULL, or EPERM if sort_first must sort a 
+*         MAPPED_READ_ONLY mapping
+*/
+bool equal_range_double_vector(double_v* vec, double value, size_t* first, 
+                               size_t* last, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function lower_bound_batch_double_vector
+* @brief Computes lower_bound_double_vector for every value of a query vector
+*
+* Queries are searched eight at a time in lockstep, so the cache misses of 
+* different queries overlap instead of being paid one after another.
+*
+* @param vec double vector or array to search, ascending with NaN last
+* @param queries Values to locate, in any order
+* @param out Array of queries->len positions that receives the results
+* @param sort_first true to sort vec first, which is skipped when the vector is
+*        known to be sorted
+* @return true if successful, false otherwise.  Sets errno to EINVAL if any 
+*         argument is NULL, or EPERM if sort_first must sort a MAPPED_READ_ONLY
+*         mapping
+*/
+bool lower_bound_batch_double_vector(double_v* vec, const double_v* queries, 
+                                     size_t* out, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function upper_bound_batch_double_vector
+* @brief Computes upper_bound_double_vector for every value of a query vector
+*
+* @param vec double vector or array to search, ascending with NaN last
+* @param queries Values to locate, in any order
+* @param out Array of queries->len positions that receives the results
+* @param sort_first true to sort vec first, which is skipped when the vector is
+*        known to be sorted
+* @return true if successful, false otherwise.  Sets errno to EINVAL if any 
+*         argument is NULL, or EPERM if sort_first must sort a MAPPED_READ_ONLY
+*         mapping
+*/
+bool upper_bound_batch_double_vector(double_v* vec, const double_v* queries, 
+                                     size_t* out, bool sort_first);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function update_double_vector
+* @brief Replaces the value of a vector at a specific index
+*
+* @param vec double vector object
+* @param index The index where data will be replaced
+* @param replacement_value The replacement value
+* @return void, Sets errno to EINVAL if vec does not exsist, or ERANGE 
+*         if the index is out of bounds, or EPERM for a MAPPED_READ_ONLY mapping
+*/
+void update_double_vector(double_v* vec, size_t index, double replacement_value);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function double_simd_level
+ * @brief Returns the instruction set used by the vectorized kernels
+ *
+ * On x86-64 builds made with GCC or Clang the best level supported by the CPU
+ * is selected once when the library is loaded.  Other builds use the best
+ * level enabled by the compile flags.
+ *
+ * @return The SIMD level of the active kernels
+ */
+simd_level_t double_simd_level(void);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function set_double_simd_level
+ * @brief Forces the vectorized kernels to a specific instruction set
+ *
+ * Intended for testing and for reproducing results across machines.  The
+ * level may not be higher than what the CPU and build support.  The change
+ * is global and should be made before other threads use the library.
+ *
+ * @param level The SIMD level to use
+ * @return true if successful, false otherwise.  Sets errno to EINVAL for an
+ *         unknown level and ENOTSUP for a level the host cannot run
+ */
+bool set_double_simd_level(simd_level_t level);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function double_thread_count
+ * @brief Returns the number of threads used by parallel reductions
+ *
+ * @return The configured thread count, or the number of online CPUs if no 
+ *         count was set.  Always 1 on platforms without POSIX threads
+ */
+size_t double_thread_count(void);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function set_double_thread_count
+ * @brief Sets the number of threads used by parallel reductions
+ *
+ * min, max, sum, average and stdev split vectors of at least 
+ * double_parallel_threshold() elements into fixed size chunks that are 
+ * processed by a library managed thread pool.  Partial results are combined 
+ * in chunk order and the chunk size does not depend on the thread count, so 
+ * results are identical for every thread count.  sort_double_vector uses the
+ * same pool and threshold.  Must not be called while another thread is 
+ * running a reduction or sort.
+ *
+ * @param threads Number of threads including the caller, 1 to disable 
+ *        threading or 0 to use one thread per online CPU
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if 
+ *         threads is larger than 256
+ */
+bool set_double_thread_count(size_t threads);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function double_parallel_threshold
+ * @brief Returns the smallest vector length that is reduced in parallel
+ *
+ * @return The threshold in elements
+ */
+size_t double_parallel_threshold(void);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function set_double_parallel_threshold
+ * @brief Sets the smallest vector length that is reduced in parallel
+ *
+ * The default of 2^21 elements (16 MB) keeps small vectors on the calling 
+ * thread, where the cost of waking the pool would dominate.  Vectors below 
+ * the threshold are reduced in a single pass, so their sums can differ in 
+ * the last bits from the chunked parallel result.
+ *
+ * @param elements The new threshold in elements
+ */
+void set_double_parallel_threshold(size_t elements);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function min_double_vector 
+ * @brief Returns the minimum value in a vector or array 
+ *
+ * @param vec A double vector or array object 
+ * @return The minimum value in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+double min_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function max_double_vector 
+ * @brief Returns the maximum value in a vector or array 
+ *
+ * @param vec A double vector or array object 
+ * @return The maximum value in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+double max_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function set_double_vector_sum_mode
+ * @brief Selects the summation used by sum, average, stdev and cum_sum on a vector
+ *
+ * SUM_COMPENSATED carries a per lane error term, so the result is accurate to a
+ * few ulps independent of the vector length, at roughly twice the cost of 
+ * SUM_NAIVE.  Works with dynamic vectors and static arrays.
+ *
+ * @param vec A double vector or array object 
+ * @param mode The summation mode
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec 
+ *         is NULL or mode is not a valid sum_mode_t
+ */
+bool set_double_vector_sum_mode(double_v* vec, sum_mode_t mode);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function sum_double_vector 
+ * @brief Returns the summation of all values in a vector or array
+ *
+ * @param vec A double vector or array object 
+ * @return The summation of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+double sum_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function average_double_vector 
+ * @brief Returns the average of all values in a vector or array
+ *
+ * @param vec A double vector or array object 
+ * @return The average of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+double average_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function stdev_double_vector 
+ * @brief Returns the standard deviation of all values in a vector or array
+ *
+ * @param vec A double vector or array object 
+ * @return The standard deviation of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+double stdev_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function describe_double_vector 
+ * @brief Computes count, min, max, sum, mean, variance and standard deviation 
+ *        in a single pass over the data
+ *
+ * Cheaper than calling the individual reduction functions when more than one
+ * statistic is needed.  NaN values are skipped and counted in nan_count.  If
+ * every value is NaN the floating point fields are NaN, and if any value is
+ * infinite the variance and stdev are INFINITY.
+ *
+ * @param vec A double vector or array object 
+ * @return The statistics of vec.  Sets errno to EINVAL and returns a zeroed 
+ *         structure if vec or vec->data is NULL, or if length is 0
+ */
+double_stats_t describe_double_vector(const double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function cum_sum_double_vector 
+ * @brief Returns a dynamically allocated array containing the cumulative sum of all 
+ *        values in vec
+ *
+ * The sum is computed with scan_into_double_vector, so it is vectorized and 
+ * parallel for large vectors.  Once the running sum overflows, the rest of the
+ * result is INFINITY.  Use scan_double_vector to avoid the allocation.
+ *
+ * @param vec A double vector or array object 
+ * @return A double_v object with the cumulative sum of all values in vec.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, if length is 0 or if vec holds a NaN and returns NULL
+ */
+double_v* cum_sum_double_vector(double_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function scan_double_vector
+ * @brief Replaces every value with the running sum, product, minimum or maximum
+ *
+ * The scan is done in SIMD registers with the block carry kept off the 
+ * critical path, and vectors of at least double_parallel_threshold() 
+ * elements are scanned on the thread pool in two passes over fixed chunks.
+ * The additions are therefore grouped differently than in a sequential loop,
+ * and sums and products may differ from it in the last bits.  SCAN_SUM on a
+ * vector set to SUM_COMPENSATED uses a serial compensated scan instead.  
+ * NaN propagates to every later position and no allocation is made.
+ *
+ * @param vec A double vector or array object, overwritten with the scan
+ * @param op SCAN_SUM, SCAN_PROD, SCAN_MIN or SCAN_MAX
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec is 
+ *         NULL or op is not a valid scan_op_t, or EPERM for a MAPPED_READ_ONLY
+ *         mapping
+ */
+bool scan_double_vector(double_v* vec, scan_op_t op);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function scan_into_double_vector
+ * @brief Writes the running sum, product, minimum or maximum of vec to a buffer
+ *
+ * Works like scan_double_vector but leaves vec unchanged.
+ *
+ * @param vec A double vector or array object 
+ * @param out Buffer of at least vec->len doubles that receives the scan; it 
+ *        may be vec->data
+ * @param op SCAN_SUM, SCAN_PROD, SCAN_MIN or SCAN_MAX
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec or
+ *         out is NULL or op is not a valid scan_op_t
+ */
+bool scan_into_double_vector(const double_v* vec, double* out, scan_op_t op);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function arith_double_vector
+ * @brief Replaces every value of vec with vec[i] op other[i]
+ *
+ * The operation runs in the SIMD kernels selected at load time and, for 
+ * vectors of at least double_parallel_threshold() elements, on the thread 
+ * pool.  Every element is rounded once, so the result is the same at every
+ * SIMD level.  other may be vec itself.
+ *
+ * @param vec A double vector or array object, overwritten with the result
+ * @param other A double vector or array object with the same length as vec
+ * @param op ARITH_ADD, ARITH_SUB, ARITH_MUL or ARITH_DIV
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec or
+ *         other is NULL, the lengths differ or op is not a valid arith_op_t, or
+ *         EPERM for a MAPPED_READ_ONLY mapping
+ */
+bool arith_double_vector(double_v* vec, const double_v* other, arith_op_t op);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function arith_into_double_vector
+ * @brief Writes a[i] op b[i] to a buffer and leaves a and b unchanged
+ *
+ * @param a A double vector or array object 
+ * @param b A double vector or array object with the same length as a
+ * @param out Buffer of at least a->len doubles that receives the result; it 
+ *        may be a->data or b->data but must not overlap them otherwise
+ * @param op ARITH_ADD, ARITH_SUB, ARITH_MUL or ARITH_DIV
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if a, b 
+ *         or out is NULL, the lengths differ or op is not a valid arith_op_t
+ */
+bool arith_into_double_vector(const double_v* a, const double_v* b, double* out, 
+                              arith_op_t op);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function affine_double_vector
+ * @brief Replaces every value of vec with vec[i] * scale + offset
+ *
+ * A pure scaling passes an offset of -0.0, which keeps the sign of zero, and
+ * a pure offset passes a scale of 1.0.  The AVX2 and AVX-512 kernels use a
+ * fused multiply-add, which rounds once, so with both a scale and an offset 
+ * the result may differ from the SSE2 and scalar kernels in the last bit.  
+ * A positive, finite scale with a finite offset keeps a sorted vector sorted.
+ *
+ * @param vec A double vector or array object, overwritten with the result
+ * @param scale Factor applied to every value
+ * @param offset Value added to every scaled value
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec is NULL,
+ *         or EPERM for a MAPPED_READ_ONLY mapping
+ */
+bool affine_double_vector(double_v* vec, double scale, double offset);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function affine_into_double_vector
+ * @brief Writes vec[i] * scale + offset to a buffer and leaves vec unchanged
+ *
+ * @param vec A double vector or array object 
+ * @param out Buffer of at least vec->len doubles that receives the result; it 
+ *        may be vec->data but must not overlap it otherwise
+ * @param scale Factor applied to every value
+ * @param offset Value added to every scaled value
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec or
+ *         out is NULL
+ */
+bool affine_into_double_vector(const double_v* vec, double* out, double scale, 
+                               double offset);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function axpy_double_vector
+ * @brief Replaces every value of y with alpha * x[i] + y[i]
+ *
+ * Uses a fused multiply-add in the AVX2 and AVX-512 kernels, see 
+ * affine_double_vector.
+ *
+ * @param y A double vector or array object, overwritten with the result
+ * @param alpha Factor applied to every value of x
+ * @param x A double vector or array object with the same length as y
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if y or x
+ *         is NULL or the lengths differ, or EPERM if y is a MAPPED_READ_ONLY
+ *         mapping
+ */
+bool axpy_double_vector(double_v* y, double alpha, const double_v* x);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function dot_double_vector
+ * @brief Returns the dot product of two vectors
+ *
+ * Products are accumulated with fused multiply-adds in several SIMD lanes, 
+ * and vectors of at least double_parallel_threshold() elements are reduced 
+ * on the thread pool in fixed chunks whose partial sums are added in order.
+ * The result does not depend on the thread count but, as with 
+ * sum_double_vector, may differ between SIMD levels in the last bits.
+ *
+ * @param a A double vector or array object 
+ * @param b A double vector or array object with the same length as a
+ * @return The dot product.  Sets errno to EINVAL and returns DBL_MAX if a or b
+ *         is NULL, the lengths differ or the length is 0
+ */
+double dot_double_vector(const double_v* a, const double_v* b);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function norm_double_vector
+ * @brief Returns the L1, L2 or infinity norm of a vector
+ *
+ * The L2 norm is the square root of the dot product of vec with itself.  If
+ * that sum of squares overflows or underflows, the values are scaled by the
+ * largest magnitude in a second pass, so the result is accurate over the 
+ * whole double range.  A NaN anywhere gives NaN, otherwise an infinity gives
+ * INFINITY.
+ *
+ * @param vec A double vector or array object 
+ * @param type NORM_L1, NORM_L2 or NORM_INF
+ * @return The norm.  Sets errno to EINVAL and returns DBL_MAX if vec is NULL, 
+ *         the length is 0 or type is not a valid norm_t
+ */
+double norm_double_vector(const double_v* vec, norm_t type);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief creates a deep copy of a vector
+ *
+ * @param original A vector to be copied 
+ * @return A copy of a double vector
+ */
+double_v* copy_double_vector(const double_v* original);
+// ================================================================================ 
+// ================================================================================ 
+// SEARCH INDEX PROTOTYPES 
+
+/**
+ * @typedef search_index_d
+ * @brief Opaque read only search structure built from a sorted vector
+ *
+ * The values are stored in Eytzinger (breadth first) order, which keeps the 
+ * top levels of every search in a few cache lines and lets a search prefetch 
+ * the nodes three levels ahead.  Searches are branchless and return the same
+ * positions as the searches on the sorted vector.  The index is a snapshot; 
+ * later changes to the vector are not reflected.
+ */
+typedef struct search_index_d search_index_d;
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Builds a search index from a vector that is ascending with NaN last
+ *
+ * Uses one double and one size_t per value that is not NaN.
+ *
+ * @param vec A sorted double vector or array
+ * @return A pointer to the new index, or NULL on failure.  Sets errno to 
+ *         EINVAL if vec is NULL or not sorted and ENOMEM if memory cannot be
+ *         allocated
+ */
+search_index_d* init_search_index(double_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Frees the memory of a search index
+ *
+ * @param index The index to free.  Sets errno to EINVAL if index is NULL
+ */
+void free_search_index(search_index_d* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Frees a search index and sets the pointer to NULL
+ *
+ * Used with the SINDEX_GBC macro for automatic cleanup.
+ *
+ * @param index Pointer to the index pointer to free
+ */
+void _free_search_index(search_index_d** index);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro SINDEX_GBC
+     * @brief A macro for enabling automatic cleanup of search_index_d objects.
+     */
+    #define SINDEX_GBC __attribute__((cleanup(_free_search_index)))
+#endif
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the first position of the source vector not less than value
+ *
+ * @param index The search index
+ * @param value The value to locate; NaN returns the position of the first NaN
+ * @return A position between 0 and len, or LONG_MAX with errno set to EINVAL 
+ *         if index is NULL
+ */
+size_t lower_bound_search_index(const search_index_d* index, double value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the first position of the source vector greater than value
+ *
+ * @param index The search index
+ * @param value The value to locate; NaN returns len
+ * @return A position between 0 and len, or LONG_MAX with errno set to EINVAL 
+ *         if index is NULL
+ */
+size_t upper_bound_search_index(const search_index_d* index, double value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Computes lower_bound_search_index for every value of a query vector
+ *
+ * Queries are descended eight at a time in lockstep with prefetching, so the
+ * memory latency of one level is paid once for the whole group.
+ *
+ * @param index The search index
+ * @param queries Values to locate, in any order
+ * @param out Array of queries->len positions that receives the results
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if any 
+ *         argument is NULL
+ */
+bool lower_bound_batch_search_index(const search_index_d* index, const double_v* queries,
+                                    size_t* out);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Computes upper_bound_search_index for every value of a query vector
+ *
+ * @param index The search index
+ * @param queries Values to locate, in any order
+ * @param out Array of queries->len positions that receives the results
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if any 
+ *         argument is NULL
+ */
+bool upper_bound_batch_search_index(const search_index_d* index, const double_v* queries,
+                                    size_t* out);
+// ================================================================================ 
+// ================================================================================ 
+// EXPRESSION PROTOTYPES 
+
+/**
+ * @typedef expr_d
+ * @brief Opaque recording of element-wise operations over vectors
+ *
+ * An expression is a directed acyclic graph whose leaves are vectors or 
+ * constants and whose inner nodes are ARITH_ADD, ARITH_SUB, ARITH_MUL or 
+ * ARITH_DIV.  Nodes are referred to by the handles the builder functions 
+ * return, and a node can be used by any number of later nodes.  Evaluation 
+ * runs a single blocked loop over tiles that fit in the L1 cache, so 
+ * intermediate values are never written to memory and no temporary vector is
+ * allocated.  Every node is rounded exactly as the corresponding call to 
+ * arith_double_vector would round it.
+ *
+ * The expression stores pointers to its input vectors, not copies; their data
+ * and length are read when the expression is evaluated.
+ */
+typedef struct expr_d expr_d;
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Creates an empty expression
+ *
+ * @return A pointer to the new expression, or NULL with errno set to ENOMEM
+ *         if memory cannot be allocated
+ */
+expr_d* init_double_expr(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Frees the memory of an expression; its input vectors are not freed
+ *
+ * @param expr The expression to free.  Sets errno to EINVAL if expr is NULL
+ */
+void free_double_expr(expr_d* expr);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Frees an expression and sets the pointer to NULL
+ *
+ * Used with the DEXPR_GBC macro for automatic cleanup.
+ *
+ * @param expr Pointer to the expression pointer to free
+ */
+void _free_double_expr(expr_d** expr);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro DEXPR_GBC
+     * @brief A macro for enabling automatic cleanup of expr_d objects.
+     */
+    #define DEXPR_GBC __attribute__((cleanup(_free_double_expr)))
+#endif
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Adds a vector operand to an expression
+ *
+ * All vectors of an expression must have the same length when it is 
+ * evaluated.
+ *
+ * @param expr The expression
+ * @param vec A double vector or array object; it must outlive every evaluation
+ * @return The handle of the new node, or LONG_MAX on failure.  Sets errno to
+ *         EINVAL if expr or vec is NULL and ENOMEM if memory cannot be allocated
+ */
+size_t input_double_expr(expr_d* expr, const double_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Adds a constant operand, used for every element, to an expression
+ *
+ * @param expr The expression
+ * @param value The constant
+ * @return The handle of the new node, or LONG_MAX on failure.  Sets errno to
+ *         EINVAL if expr is NULL and ENOMEM if memory cannot be allocated
+ */
+size_t const_double_expr(expr_d* expr, double value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Adds the element-wise operation lhs op rhs to an expression
+ *
+ * @param expr The expression
+ * @param op ARITH_ADD, ARITH_SUB, ARITH_MUL or ARITH_DIV
+ * @param lhs Handle of the left operand
+ * @param rhs Handle of the right operand, which may equal lhs
+ * @return The handle of the new node, or LONG_MAX on failure.  Sets errno to
+ *         EINVAL if expr is NULL, op is not a valid arith_op_t or a handle 
+ *         does not belong to expr, and ENOMEM if memory cannot be allocated
+ */
+size_t arith_double_expr(expr_d* expr, arith_op_t op, size_t lhs, size_t rhs);
+// --------------------------------------------------------------------------------
 
 /**
- * @function reverse_double_vector
- * @brief Reverses the order of elements in a double vector in place.
+ * @brief Evaluates the node root of an expression for every element
  *
- * The function reverses the order of elements by swapping elements from the
- * beginning and end of the vector until the middle is reached.
+ * Only the nodes root depends on are computed.  The result is identical to
+ * applying arith_double_vector once per node.  Vectors of at least 
+ * double_parallel_threshold() elements are evaluated on the thread pool.
  *
- * @param vec double vector to reverse
- * @return void
- *         Sets errno to EINVAL if vec is NULL or invalid
+ * @param expr The expression
+ * @param root Handle of the node to evaluate
+ * @param out Buffer of at least len doubles that receives the result, where 
+ *        len is the common length of the inputs.  It may be the data of an 
+ *        input vector but must not overlap it otherwise
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if expr 
+ *         or out is NULL, root is not a handle of expr, root depends on no 
+ *         vector, or its vectors have no data or different lengths, and ENOMEM
+ *         if memory cannot be allocated
  */
-void reverse_double_vector(double_v* vec);
+bool eval_double_expr(const expr_d* expr, size_t root, double* out);
 // --------------------------------------------------------------------------------
 
 /**
- * @function swap_double
- * @brief Swaps the contents of two double objects.
+ * @brief Evaluates the node root of an expression and folds the result into
+ *        one value without storing it
  *
- * Performs an in-place swap of double values
+ * Each tile is folded while it is still in L1.  The tile sums are added in 
+ * order, and on the thread pool so are the chunk sums, so the result does 
+ * not depend on the thread count but may differ from sum_double_vector of 
+ * the evaluated vector in the last bits.  NaN propagates for every op.
  *
- * @param a Pointer to first double object
- * @param b Pointer to second double object
- * @return void
- *         Sets errno to EINVAL if either input is NULL
+ * @param expr The expression
+ * @param root Handle of the node to evaluate
+ * @param op SCAN_SUM, SCAN_PROD, SCAN_MIN or SCAN_MAX, the operation whose 
+ *        final running value is returned
+ * @return The folded value.  Sets errno to EINVAL and returns DBL_MAX under 
+ *         the conditions listed for eval_double_expr, if op is not a valid 
+ *         scan_op_t or if the length is 0, and ENOMEM if memory cannot be 
+ *         allocated
  */
-void swap_double(double* a, double* b);
+double reduce_double_expr(const expr_d* expr, size_t root, scan_op_t op);
+// ================================================================================ 
+// ================================================================================ 
+// ORDERED MULTISET PROTOTYPES 
+
+/**
+ * @typedef multiset_d
+ * @brief Opaque sorted collection of doubles that may hold repeated values
+ *
+ * The values are stored in sorted leaves of a few hundred doubles with an 
+ * index over the leaves, so insert, remove, rank and select cost O(log n) plus
+ * a move within one leaf, where inserting into a sorted double_v moves half 
+ * the vector on average.  NaN cannot be stored.
+ */
+typedef struct multiset_d multiset_d;
 // --------------------------------------------------------------------------------
 
 /**
-* @function sort_double_vector
-* @brief Sorts a double vector in ascending or descending order.
-*
-* Uses an optimized QuickSort algorithm with median-of-three pivot selection
-* and insertion sort for small subarrays. Sort direction is determined by
-* the iter_dir parameter.
-*
-* @param vec double vector to sort
-* @param direction FORWARD for ascending order, REVERSE for descending
-* @return void
-*         Sets errno to EINVAL if vec is NULL or invalid
-*/
-void sort_double_vector(double_v* vec, iter_dir direction);
-// -------------------------------------------------------------------------------- 
+ * @brief Creates an empty multiset
+ *
+ * @return A pointer to the new multiset, or NULL with errno set to ENOMEM
+ *         if memory cannot be allocated
+ */
+multiset_d* init_double_multiset(void);
+// --------------------------------------------------------------------------------
 
 /**
-* @function trim_double_vector
-* @brief Trims all un-necessary memory from a vector
-*
-* @param vec double vector to trim
-* @return void
-*         Sets errno to EINVAL if vec is NULL or invalid
-*/
-void trim_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+ * @brief Frees the memory of a multiset
+ *
+ * @param ms The multiset to free.  Sets errno to EINVAL if ms is NULL
+ */
+void free_double_multiset(multiset_d* ms);
+// --------------------------------------------------------------------------------
 
 /**
-* @function binary_search_double_vector
-* @brief Searches a double vector to find the index where a value exists
-*
-* @param vec double vector object
-* @param value The value to search for
-* @param tolerance The double tolerance for finding a value 
-* @param sort_first true if the vector or array needs to be sorted, false otherwise
-* @return The index where a value exists, LONG_MAX if the value is not in the array.
-*         Sets errno to EINVAL if vec is NULL or invalid, ENODATA if the array is 
-*         not populated
-*/
-size_t binary_search_double_vector(double_v* vec, double value, double tolerance, bool sort_first);
-// -------------------------------------------------------------------------------- 
+ * @brief Frees a multiset and sets the pointer to NULL
+ *
+ * Used with the DMSET_GBC macro for automatic cleanup.
+ *
+ * @param ms Pointer to the multiset pointer to free
+ */
+void _free_double_multiset(multiset_d** ms);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro DMSET_GBC
+     * @brief A macro for enabling automatic cleanup of multiset_d objects.
+     */
+    #define DMSET_GBC __attribute__((cleanup(_free_double_multiset)))
+#endif
+// --------------------------------------------------------------------------------
 
 /**
-* @function update_double_vector
-* @brief Replaces the value of a vector at a specific index
-*
-* @param vec double vector object
-* @param index The index where data will be replaced
-* @param replacement_value The replacement value
-* @return void, Sets errno to EINVAL if vec does not exsist, or ERANGE 
-*         if the index is out of bounds
-*/
-void update_double_vector(double_v* vec, size_t index, double replacement_value);
-// -------------------------------------------------------------------------------- 
+ * @brief Adds a value to a multiset, after any equal values already stored
+ *
+ * @param ms The multiset
+ * @param value The value to add
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if ms is
+ *         NULL or value is NaN and ENOMEM if memory cannot be allocated
+ */
+bool insert_double_multiset(multiset_d* ms, double value);
+// --------------------------------------------------------------------------------
 
 /**
- * @function min_double_vector 
- * @brief Returns the minimum value in a vector or array 
+ * @brief Removes one occurrence of a value from a multiset
  *
- * @param vec A double vector or array object 
- * @return The minimum value in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param ms The multiset
+ * @param value The value to remove
+ * @return true if a value was removed, false otherwise.  Sets errno to EINVAL
+ *         if ms is NULL or value is NaN and ENOENT if value is not stored
  */
-double min_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+bool remove_double_multiset(multiset_d* ms, double value);
+// --------------------------------------------------------------------------------
 
 /**
- * @function max_double_vector 
- * @brief Returns the maximum value in a vector or array 
+ * @brief Returns the number of values in a multiset
  *
- * @param vec A double vector or array object 
- * @return The maximum value in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param ms The multiset
+ * @return The number of values, or LONG_MAX with errno set to EINVAL if ms is
+ *         NULL
  */
-double max_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+size_t double_multiset_size(const multiset_d* ms);
+// --------------------------------------------------------------------------------
 
 /**
- * @function sum_double_vector 
- * @brief Returns the summation of all values in a vector or array
+ * @brief Returns the number of values smaller than value
  *
- * @param vec A double vector or array object 
- * @return The summation of all values in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * This is also the index the first occurrence of value would have in the 
+ * sorted values.
+ *
+ * @param ms The multiset
+ * @param value The value to rank
+ * @return The rank, or LONG_MAX with errno set to EINVAL if ms is NULL or 
+ *         value is NaN
  */
-double sum_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+size_t rank_double_multiset(const multiset_d* ms, double value);
+// --------------------------------------------------------------------------------
 
 /**
- * @function average_double_vector 
- * @brief Returns the average of all values in a vector or array
+ * @brief Returns the number of values in the closed interval [lo, hi]
  *
- * @param vec A double vector or array object 
- * @return The average of all values in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param ms The multiset
+ * @param lo Lower end of the interval
+ * @param hi Upper end of the interval; the count is 0 if hi < lo
+ * @return The count, or LONG_MAX with errno set to EINVAL if ms is NULL or 
+ *         lo or hi is NaN
  */
-double average_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+size_t count_range_double_multiset(const multiset_d* ms, double lo, double hi);
+// --------------------------------------------------------------------------------
 
 /**
- * @function stdev_double_vector 
- * @brief Returns the standard deviation of all values in a vector or array
+ * @brief Returns the value at index k of the sorted values
  *
- * @param vec A double vector or array object 
- * @return The standard deviation of all values in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * select_double_multiset(ms, 0) is the minimum and 
+ * select_double_multiset(ms, size / 2) the upper median.
+ *
+ * @param ms The multiset
+ * @param k Zero based index into the sorted values
+ * @return The value, or DBL_MAX on failure.  Sets errno to EINVAL if ms is 
+ *         NULL and ERANGE if k is not smaller than the size
  */
-double stdev_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+double select_double_multiset(const multiset_d* ms, size_t k);
+// --------------------------------------------------------------------------------
 
 /**
- * @function cum_sum_double_vector 
- * @brief Returns a dynamically allocated array containing the cumulative sum of all 
- *        values in vec
+ * @brief Iterator function type for multiset traversal
+ */
+typedef void (*multiset_iterator)(double value, void* user_data);
+
+/**
+ * @brief Calls iter for every value in [lo, hi] in ascending order
  *
- * @param vec A double vector or array object 
- * @return A double_v object with the cumulative sum of all values in vec.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * The multiset must not be changed from within iter.
+ *
+ * @param ms The multiset
+ * @param lo Lower end of the interval
+ * @param hi Upper end of the interval
+ * @param iter Iterator function to call for each value
+ * @param user_data Optional user data passed to iter
+ * @return true if successful, false with errno set to EINVAL if ms or iter is
+ *         NULL or lo or hi is NaN
  */
-double_v* cum_sum_double_vector(double_v* vec);
-// -------------------------------------------------------------------------------- 
+bool foreach_range_double_multiset(const multiset_d* ms, double lo, double hi,
+                                   multiset_iterator iter, void* user_data);
+// --------------------------------------------------------------------------------
 
 /**
- * @brief creates a deep copy of a vector
+ * @brief Copies the values of a multiset, in ascending order, to a new vector
  *
- * @param original A vector to be copied 
- * @return A copy of a double vector
+ * The vector carries the sorted flag.
+ *
+ * @param ms The multiset
+ * @return A dynamically allocated vector the caller must free, or NULL on 
+ *         failure.  Sets errno to EINVAL if ms is NULL and ENOMEM if memory 
+ *         cannot be allocated
  */
-double_v* copy_double_vector(const double_v* original);
+double_v* get_values_double_multiset(const multiset_d* ms);
 // ================================================================================ 
 // ================================================================================ 
 // DICTIONARY PROTOTYPES 
@@ -824,6 +2267,270 @@ bool foreach_doublev_dict(const dict_dv* dict, dict_dv_iterator iter, void* user
 string_v* get_keys_doublev_dict(const dict_dv* dict);
 // ================================================================================ 
 // ================================================================================ 
+// BINARY FILE PROTOTYPES 
+//
+// Vectors and vector dictionaries are stored in a versioned little endian 
+// format: a 64 byte file header followed by one column per vector, each made 
+// of a 64 byte column header (length, key length, sorted flag, checksum), the
+// key and the doubles, every part padded to 64 bytes.  The payloads therefore
+// start on 64 byte boundaries of the file.  An optional checksum of every 
+// column, covering its header, key and doubles, is verified when it is read.
+
+/**
+ * @typedef double_writer_d
+ * @brief Opaque writer that streams vectors to a binary file as columns
+ */
+typedef struct double_writer_d double_writer_d;
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef double_reader_d
+ * @brief Opaque reader that streams the columns of a binary file
+ */
+typedef struct double_reader_d double_reader_d;
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Creates or truncates a binary file and writes its header
+ *
+ * @param path Path of the file
+ * @param checksum true to store a checksum of every column
+ * @return A writer, or NULL on failure.  Sets errno to EINVAL if path is NULL
+ *         and ENOMEM if memory cannot be allocated; errors of fopen and fwrite
+ *         are passed through
+ */
+double_writer_d* open_double_writer(const char* path, bool checksum);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Appends a vector to a binary file as one column
+ *
+ * The doubles are written with one call straight from vec->data.  After a 
+ * failed write the file is incomplete; later writes fail with EIO and 
+ * close_double_writer reports the failure.
+ *
+ * @param writer The writer
+ * @param key Name of the column, or NULL for an unnamed column
+ * @param vec The vector to write, of any alloc_t
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if writer
+ *         or vec is NULL and EIO after an earlier failure; errors of fwrite 
+ *         are passed through
+ */
+bool write_double_column(double_writer_d* writer, const char* key, const double_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the column count, closes the file and frees the writer
+ *
+ * @param writer The writer
+ * @return true if every column was written, false otherwise.  Sets errno to
+ *         EINVAL if writer is NULL; errors of the writes and of fclose are 
+ *         passed through
+ */
+bool close_double_writer(double_writer_d* writer);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Opens a binary file and reads its header
+ *
+ * @param path Path of the file
+ * @return A reader, or NULL on failure.  Sets errno to EINVAL if path is NULL,
+ *         ENOMEM if memory cannot be allocated, EBADMSG if the file is not a 
+ *         binary vector file and ENOTSUP if it was written by a newer version;
+ *         errors of fopen are passed through
+ */
+double_reader_d* open_double_reader(const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the number of columns in the file of a reader
+ *
+ * @param reader The reader
+ * @return The column count, or LONG_MAX with errno set to EINVAL if reader is
+ *         NULL
+ */
+size_t double_reader_columns(const double_reader_d* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Reads the next column into a new vector
+ *
+ * The doubles are read with one call straight into the buffer of the new 
+ * vector.  The sorted flag is restored if the data is ascending, which is 
+ * checked with one scan since the file may be damaged or written by hand.  
+ * After a failure the reader should only be closed.
+ *
+ * @param reader The reader
+ * @return A dynamically allocated vector the caller must free, or NULL on 
+ *         failure.  Sets errno to EINVAL if reader is NULL, ENODATA when every
+ *         column has been read, EBADMSG if the file is truncated, the column
+ *         header claims more data than the file holds or a checksum does not
+ *         match and ENOMEM if memory cannot be allocated
+ */
+double_v* read_double_column(double_reader_d* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the key of the column read last
+ *
+ * @param reader The reader
+ * @return The key, an empty string for an unnamed column, valid until the 
+ *         next read or close.  NULL with errno set to EINVAL if reader is NULL
+ *         or no column has been read
+ */
+const char* double_reader_key(const double_reader_d* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Closes the file of a reader and frees the reader
+ *
+ * @param reader The reader.  Sets errno to EINVAL if reader is NULL
+ */
+void close_double_reader(double_reader_d* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Writes a vector to a binary file with one unnamed column
+ *
+ * @param vec The vector
+ * @param path Path of the file
+ * @param checksum true to store a checksum
+ * @return true if successful, false otherwise with errno set as by 
+ *         open_double_writer and write_double_column
+ */
+bool save_double_vector(const double_v* vec, const char* path, bool checksum);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Reads a vector written by save_double_vector
+ *
+ * @param path Path of the file
+ * @return A dynamically allocated vector, or NULL on failure with errno set as
+ *         by open_double_reader and read_double_column, or to EBADMSG if the
+ *         file does not hold exactly one column
+ */
+double_v* load_double_vector(const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Writes every vector of a dictionary to a binary file, one column 
+ *        per key
+ *
+ * @param dict The dictionary
+ * @param path Path of the file
+ * @param checksum true to store a checksum of every column
+ * @return true if successful, false otherwise with errno set to EINVAL if dict
+ *         or path is NULL, or as by open_double_writer and write_double_column
+ */
+bool save_doublev_dict(const dict_dv* dict, const char* path, bool checksum);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Reads a dictionary written by save_doublev_dict
+ *
+ * @param path Path of the file
+ * @return A new dictionary the caller must free, or NULL on failure with errno
+ *         set as by open_double_reader and read_double_column, or to EEXIST 
+ *         if a key appears twice
+ */
+dict_dv* load_doublev_dict(const char* path);
+// ================================================================================ 
+// ================================================================================ 
+// TEXT PARSING PROTOTYPES 
+
+/**
+ * @brief Parses delimited decimal numbers from a buffer and appends them to 
+ *        a vector
+ *
+ * Tokens are separated by any run of the characters in delim and of ASCII 
+ * whitespace, so "1.5, 2\n3" parses with delim ",".  A token is an optional
+ * sign, digits with an optional decimal point and an optional exponent, or 
+ * inf, infinity or nan in any case; hexadecimal floats are not accepted.  
+ * Numbers are converted in place without copying the tokens and are 
+ * correctly rounded to the nearest double, as by strtod in the C locale.  
+ * The decimal point is always '.', whatever locale the program selected.
+ * Magnitudes beyond DBL_MAX become infinities and values below the smallest
+ * subnormal become zero, without an error.
+ *
+ * Parsing stops at the first token that is not a number; the values parsed 
+ * before it stay in vec.
+ *
+ * @param text The text, which need not be null terminated
+ * @param len Number of bytes of text to parse
+ * @param delim Null terminated set of delimiter characters, "" for 
+ *        whitespace only
+ * @param vec A vector to append to, of any alloc_t with room for the values
+ * @param error_pos Receives the byte offset of the first token that could 
+ *        not be parsed or stored, or len if every token was parsed.  May be 
+ *        NULL
+ * @return The number of values appended.  On an error errno is set to EILSEQ
+ *         for a malformed token, or to EINVAL or ENOMEM if vec could not 
+ *         grow.  Returns LONG_MAX and sets errno to EINVAL if text, delim or 
+ *         vec is NULL
+ */
+size_t parse_double_buffer(const char* text, size_t len, const char* delim,
+                           double_v* vec, size_t* error_pos);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Parses delimited decimal numbers from a string and appends them to 
+ *        a vector
+ *
+ * Behaves as parse_double_buffer on the characters of str.
+ *
+ * @param str The string to parse
+ * @param delim Null terminated set of delimiter characters, "" for 
+ *        whitespace only
+ * @param vec A vector to append to
+ * @param error_pos Receives the byte offset of the first bad token, or the 
+ *        string length if every token was parsed.  May be NULL
+ * @return The number of values appended, or LONG_MAX with errno set to EINVAL
+ *         if an argument is NULL.  Errors while parsing are reported as by 
+ *         parse_double_buffer
+ */
+size_t parse_doubles_into_vector(const string_t* str, const char* delim,
+                                 double_v* vec, size_t* error_pos);
+// ================================================================================ 
+// ================================================================================ 
+// TEXT FORMATTING PROTOTYPES 
+
+/**
+ * @brief Appends the values of a vector to a string as delimited text
+ *
+ * Each value is written with the fewest significant digits that read back 
+ * to the same double, so parse_double_buffer or strtod recovers the vector 
+ * exactly.  The layout follows printf("%.17g"): plain notation for decimal 
+ * exponents in [-4, 17), otherwise d.ddde+XX; "inf", "-inf" and "nan" for 
+ * special values.  The text does not depend on the locale.  Values are 
+ * formatted into a stack buffer and appended a chunk at a time, so reserving
+ * the string beforehand with reserve_string avoids any reallocation.
+ *
+ * @param vec The vector to format
+ * @param delim Null terminated text written between values
+ * @param out The string to append to
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if an 
+ *         argument is NULL and ENOMEM if out cannot grow, in which case out 
+ *         holds part of the text
+ */
+bool format_double_vector(const double_v* vec, const char* delim, string_t* out);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Appends the entries of a dictionary to a string, one "key delim 
+ *        value" line per entry
+ *
+ * Values are written as by format_double_vector and each line ends with a
+ * newline.  Entries appear in the order foreach_double_dict visits them.
+ *
+ * @param dict The dictionary to format
+ * @param delim Null terminated text written between key and value
+ * @param out The string to append to
+ * @return true if successful, false otherwise with errno set as by 
+ *         format_double_vector
+ */
+bool format_double_dict(const dict_d* dict, const char* delim, string_t* out);
+// ================================================================================ 
+// ================================================================================ 
 // GENERIC MACROS
 
 /**
@@ -209,8 +209,9 @@ bool string_lit_concat(string_t* str1, const char* literal) {
         str1->alloc = new_len + 1;
     }
 
-    // Append the string literal to the first string
-    strncat(str1->str, literal, literal_len);
+    // Append the string literal at the known end of the first string, 
+    // without scanning it again
+    memcpy(str1->str + str1->len, literal, literal_len + 1);
 
     // Update the length of the first string
     str1->len = new_len;
@@ -108,6 +108,24 @@ void test_insert_error_cases(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_insert_special_values(void **state);
+// --------------------------------------------------------------------------------
+
+void test_extend_basic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_extend_single_growth(void **state);
+// --------------------------------------------------------------------------------
+
+void test_extend_static(void **state);
+// --------------------------------------------------------------------------------
+
+void test_extend_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_append_basic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_copy_double_vector_basic(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -140,6 +158,99 @@ void test_pop_front_special_values(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_pop_front_static(void **state);
+// --------------------------------------------------------------------------------
+
+void test_deque_fifo_window(void **state);
+// --------------------------------------------------------------------------------
+
+void test_deque_push_front(void **state);
+// --------------------------------------------------------------------------------
+
+void test_deque_matches_plain(void **state);
+// --------------------------------------------------------------------------------
+
+void test_deque_static_and_mremap(void **state);
+// --------------------------------------------------------------------------------
+
+void test_deque_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_mapped_read_only(void **state);
+// --------------------------------------------------------------------------------
+
+void test_mapped_write_modes(void **state);
+// --------------------------------------------------------------------------------
+
+void test_mapped_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_binary_vector_round_trip(void **state);
+// --------------------------------------------------------------------------------
+
+void test_binary_dict_round_trip(void **state);
+// --------------------------------------------------------------------------------
+
+void test_binary_corruption(void **state);
+// --------------------------------------------------------------------------------
+
+void test_binary_corrupt_lengths(void **state);
+// --------------------------------------------------------------------------------
+
+void test_binary_untrusted_header(void **state);
+// --------------------------------------------------------------------------------
+
+void test_binary_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_double_buffer(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_double_rounding(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_double_locale(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_doubles_into_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_double_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_format_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_format_double_round_trip(void **state);
+// --------------------------------------------------------------------------------
+
+void test_format_double_dict(void **state);
+// --------------------------------------------------------------------------------
+
+void test_format_double_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_view_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_view_double_chunks(void **state);
+// --------------------------------------------------------------------------------
+
+void test_view_fixed_length(void **state);
+// --------------------------------------------------------------------------------
+
+void test_view_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_view_parent_changes(void **state);
+// --------------------------------------------------------------------------------
+
+void test_mapped_fixed_length(void **state);
+// --------------------------------------------------------------------------------
+
+void test_mapped_read_only_writes(void **state);
+// --------------------------------------------------------------------------------
+
+void test_mapped_sorted_search(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -153,6 +264,24 @@ void test_pop_any_static(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_pop_any_special_values(void **state);
+// --------------------------------------------------------------------------------
+
+void test_erase_range_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_remove_value_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_remove_value_sorted(void **state);
+// --------------------------------------------------------------------------------
+
+void test_remove_if_nan_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_remove_simd_levels(void **state);
+// --------------------------------------------------------------------------------
+
+void test_remove_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -185,6 +314,87 @@ void test_sort_static_array(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_sort_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sort_radix_large(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sort_nan_last(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sort_parallel(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sort_simd_levels(void **state);
+// --------------------------------------------------------------------------------
+
+void test_argsort_basic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_argsort_permute_columns(void **state);
+// --------------------------------------------------------------------------------
+
+void test_argsort_permute_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_nth_matches_sort(void **state);
+// --------------------------------------------------------------------------------
+
+void test_nth_adversarial(void **state);
+// --------------------------------------------------------------------------------
+
+void test_median_percentiles(void **state);
+// --------------------------------------------------------------------------------
+
+void test_topk_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_selection_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sorted_flag_tracking(void **state);
+// --------------------------------------------------------------------------------
+
+void test_is_sorted_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sorted_flag_search_select(void **state);
+// --------------------------------------------------------------------------------
+
+void test_bounds_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_bounds_batch_and_index(void **state);
+// --------------------------------------------------------------------------------
+
+void test_search_index_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_expr_eval_matches_arith(void **state);
+// --------------------------------------------------------------------------------
+
+void test_expr_reduce(void **state);
+// --------------------------------------------------------------------------------
+
+void test_expr_parallel(void **state);
+// --------------------------------------------------------------------------------
+
+void test_expr_many_live_tiles(void **state);
+// --------------------------------------------------------------------------------
+
+void test_expr_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_multiset_basic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_multiset_matches_sorted_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_multiset_duplicates(void **state);
+// --------------------------------------------------------------------------------
+
+void test_multiset_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -201,6 +411,27 @@ void test_trim_already_optimal(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_trim_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_reserve_basic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_reserve_static(void **state);
+// --------------------------------------------------------------------------------
+
+void test_resize_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_growth_policy(void **state);
+// --------------------------------------------------------------------------------
+
+void test_growth_mremap(void **state);
+// --------------------------------------------------------------------------------
+
+void test_double_vector_alignment(void **state);
+// --------------------------------------------------------------------------------
+
+void test_reductions_unaligned_window(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -284,6 +515,72 @@ void test_stdev_cum_sum_special_values(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_stdev_cum_sum_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_simd_level_select(void **state);
+// --------------------------------------------------------------------------------
+
+void test_simd_levels_agree(void **state);
+// --------------------------------------------------------------------------------
+
+void test_stdev_stale_errno(void **state);
+// --------------------------------------------------------------------------------
+
+void test_describe_basic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_describe_matches_reductions(void **state);
+// --------------------------------------------------------------------------------
+
+void test_describe_special_values(void **state);
+// --------------------------------------------------------------------------------
+
+void test_describe_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sum_mode_compensated(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sum_mode_cum_sum(void **state);
+// --------------------------------------------------------------------------------
+
+void test_sum_mode_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_scan_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_scan_simd_levels(void **state);
+// --------------------------------------------------------------------------------
+
+void test_scan_parallel(void **state);
+// --------------------------------------------------------------------------------
+
+void test_scan_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_arith_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_affine_axpy_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dot_norm_double_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_arith_simd_levels(void **state);
+// --------------------------------------------------------------------------------
+
+void test_arith_parallel(void **state);
+// --------------------------------------------------------------------------------
+
+void test_arith_errors(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parallel_reductions_deterministic(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parallel_thread_count_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -54,6 +54,12 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_insert_array_bounds),
     cmocka_unit_test(test_insert_error_cases),
     cmocka_unit_test(test_insert_special_values),
+    cmocka_unit_test(test_extend_basic),
+    cmocka_unit_test(test_extend_single_growth),
+    cmocka_unit_test(test_extend_static),
+    cmocka_unit_test(test_extend_errors),
+    cmocka_unit_test(test_append_basic),
+    cmocka_unit_test(test_copy_double_vector_basic),
     cmocka_unit_test(test_pop_back_basic),
     cmocka_unit_test(test_pop_back_empty),
     cmocka_unit_test(test_pop_back_errors),
@@ -64,10 +70,47 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_pop_front_errors),
     cmocka_unit_test(test_pop_front_special_values),
     cmocka_unit_test(test_pop_front_static),
+    cmocka_unit_test(test_deque_fifo_window),
+    cmocka_unit_test(test_deque_push_front),
+    cmocka_unit_test(test_deque_matches_plain),
+    cmocka_unit_test(test_deque_static_and_mremap),
+    cmocka_unit_test(test_deque_errors),
+    cmocka_unit_test(test_mapped_read_only),
+    cmocka_unit_test(test_mapped_write_modes),
+    cmocka_unit_test(test_mapped_errors),
+    cmocka_unit_test(test_binary_vector_round_trip),
+    cmocka_unit_test(test_binary_dict_round_trip),
+    cmocka_unit_test(test_binary_corruption),
+    cmocka_unit_test(test_binary_corrupt_lengths),
+    cmocka_unit_test(test_binary_untrusted_header),
+    cmocka_unit_test(test_binary_errors),
+    cmocka_unit_test(test_parse_double_buffer),
+    cmocka_unit_test(test_parse_double_rounding),
+    cmocka_unit_test(test_parse_double_locale),
+    cmocka_unit_test(test_parse_doubles_into_vector),
+    cmocka_unit_test(test_parse_double_errors),
+    cmocka_unit_test(test_format_double_vector),
+    cmocka_unit_test(test_format_double_round_trip),
+    cmocka_unit_test(test_format_double_dict),
+    cmocka_unit_test(test_format_double_errors),
+    cmocka_unit_test(test_view_double_vector),
+    cmocka_unit_test(test_view_double_chunks),
+    cmocka_unit_test(test_view_fixed_length),
+    cmocka_unit_test(test_view_errors),
+    cmocka_unit_test(test_view_parent_changes),
+    cmocka_unit_test(test_mapped_fixed_length),
+    cmocka_unit_test(test_mapped_read_only_writes),
+    cmocka_unit_test(test_mapped_sorted_search),
     cmocka_unit_test(test_pop_any_basic),
     cmocka_unit_test(test_pop_any_errors),
     cmocka_unit_test(test_pop_any_static),
     cmocka_unit_test(test_pop_any_special_values),
+    cmocka_unit_test(test_erase_range_double_vector),
+    cmocka_unit_test(test_remove_value_double_vector),
+    cmocka_unit_test(test_remove_value_sorted),
+    cmocka_unit_test(test_remove_if_nan_double_vector),
+    cmocka_unit_test(test_remove_simd_levels),
+    cmocka_unit_test(test_remove_errors),
     cmocka_unit_test(test_reverse_basic),
     cmocka_unit_test(test_reverse_errors),
     cmocka_unit_test(test_reverse_static),
@@ -78,11 +121,45 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_sort_special_values),
     cmocka_unit_test(test_sort_static_array),
     cmocka_unit_test(test_sort_errors),
+    cmocka_unit_test(test_sort_radix_large),
+    cmocka_unit_test(test_sort_nan_last),
+    cmocka_unit_test(test_sort_parallel),
+    cmocka_unit_test(test_sort_simd_levels),
+    cmocka_unit_test(test_argsort_basic),
+    cmocka_unit_test(test_argsort_permute_columns),
+    cmocka_unit_test(test_argsort_permute_errors),
+    cmocka_unit_test(test_nth_matches_sort),
+    cmocka_unit_test(test_nth_adversarial),
+    cmocka_unit_test(test_median_percentiles),
+    cmocka_unit_test(test_topk_double_vector),
+    cmocka_unit_test(test_selection_errors),
+    cmocka_unit_test(test_sorted_flag_tracking),
+    cmocka_unit_test(test_is_sorted_double_vector),
+    cmocka_unit_test(test_sorted_flag_search_select),
+    cmocka_unit_test(test_bounds_double_vector),
+    cmocka_unit_test(test_bounds_batch_and_index),
+    cmocka_unit_test(test_search_index_errors),
+    cmocka_unit_test(test_expr_eval_matches_arith),
+    cmocka_unit_test(test_expr_reduce),
+    cmocka_unit_test(test_expr_parallel),
+    cmocka_unit_test(test_expr_many_live_tiles),
+    cmocka_unit_test(test_expr_errors),
+    cmocka_unit_test(test_multiset_basic),
+    cmocka_unit_test(test_multiset_matches_sorted_vector),
+    cmocka_unit_test(test_multiset_duplicates),
+    cmocka_unit_test(test_multiset_errors),
     cmocka_unit_test(test_trim_basic),
     cmocka_unit_test(test_trim_empty_vector),
     cmocka_unit_test(test_trim_static_array),
     cmocka_unit_test(test_trim_already_optimal),
     cmocka_unit_test(test_trim_errors),
+    cmocka_unit_test(test_reserve_basic),
+    cmocka_unit_test(test_reserve_static),
+    cmocka_unit_test(test_resize_double_vector),
+    cmocka_unit_test(test_growth_policy),
+    cmocka_unit_test(test_growth_mremap),
+    cmocka_unit_test(test_double_vector_alignment),
+    cmocka_unit_test(test_reductions_unaligned_window),
     cmocka_unit_test(test_binary_search_basic),
     cmocka_unit_test(test_binary_search_tolerance),
     cmocka_unit_test(test_binary_search_with_sort),
@@ -108,7 +185,29 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_cum_sum_basic),
     cmocka_unit_test(test_cum_sum_negative),
     cmocka_unit_test(test_stdev_cum_sum_special_values),
-    cmocka_unit_test(test_stdev_cum_sum_errors)
+    cmocka_unit_test(test_stdev_cum_sum_errors),
+    cmocka_unit_test(test_simd_level_select),
+    cmocka_unit_test(test_simd_levels_agree),
+    cmocka_unit_test(test_stdev_stale_errno),
+    cmocka_unit_test(test_describe_basic),
+    cmocka_unit_test(test_describe_matches_reductions),
+    cmocka_unit_test(test_describe_special_values),
+    cmocka_unit_test(test_describe_errors),
+    cmocka_unit_test(test_sum_mode_compensated),
+    cmocka_unit_test(test_sum_mode_cum_sum),
+    cmocka_unit_test(test_sum_mode_errors),
+    cmocka_unit_test(test_scan_double_vector),
+    cmocka_unit_test(test_scan_simd_levels),
+    cmocka_unit_test(test_scan_parallel),
+    cmocka_unit_test(test_scan_errors),
+    cmocka_unit_test(test_arith_double_vector),
+    cmocka_unit_test(test_affine_axpy_double_vector),
+    cmocka_unit_test(test_dot_norm_double_vector),
+    cmocka_unit_test(test_arith_simd_levels),
+    cmocka_unit_test(test_arith_parallel),
+    cmocka_unit_test(test_arith_errors),
+    cmocka_unit_test(test_parallel_reductions_deterministic),
+    cmocka_unit_test(test_parallel_thread_count_errors)
 };
 // -------------------------------------------------------------------------------- 
 